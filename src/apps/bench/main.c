@@ -0,0 +1,1094 @@
+/*
+Copyright(c) 2017 Cedric Jimenez
+
+This file is part of Nano-IP.
+
+Nano-IP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Nano-IP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with Nano-IP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "nano_ip.h"
+#include "nano_ip_big_small_packet_allocator.h"
+#include "nano_ip_slab_packet_allocator.h"
+#include "nano_ip_ethernet_crc.h"
+#include "bsp.h"
+
+/************************** Benchmark options ***************************/
+
+/** \brief Minimum duration in milliseconds of a measurement (the time base is the millisecond counter of the OAL) */
+#define BENCH_MIN_DURATION                  500u
+
+
+/********************* Packet allocator benchmark options ************************/
+
+/** \brief Enable or disable the packet allocator benchmark */
+#define BENCH_ALLOCATOR_ENABLED             1u
+
+/** \brief Size in bytes of the buffers of the packet allocator */
+#define BENCH_ALLOCATOR_BUFFER_SIZE         128u
+
+/** \brief Smallest number of buffers of the packet allocator */
+#define BENCH_ALLOCATOR_MIN_POOL_SIZE       16u
+
+/** \brief Largest number of buffers of the packet allocator (the pool size is multiplied by 4 at each step) */
+#define BENCH_ALLOCATOR_MAX_POOL_SIZE       1024u
+
+
+/********************* Slab packet allocator benchmark options ************************/
+
+/** \brief Enable or disable the slab packet allocator benchmark */
+#define BENCH_SLAB_ENABLED                  1u
+
+/** \brief Number of buffers of the small (128 bytes) and medium (576 bytes) size classes */
+#define BENCH_SLAB_SMALL_BUFFER_COUNT       32u
+
+/** \brief Number of buffers of the big (1536 bytes) size class */
+#define BENCH_SLAB_BIG_BUFFER_COUNT         64u
+
+/** \brief Number of packets held during the measurement (more than the small and medium classes can serve) */
+#define BENCH_SLAB_HELD_COUNT               96u
+
+
+/************************** OAL flags benchmark options ***************************/
+
+#ifndef NANO_IP_OAL_TASK_NO_INFINITE_LOOP
+/** \brief Enable or disable the OAL flags ping-pong benchmark */
+#define BENCH_FLAGS_ENABLED                 1u
+#else
+/** \brief The tasks of an OS-less target can't wait for each other */
+#define BENCH_FLAGS_ENABLED                 0u
+#endif /* NANO_IP_OAL_TASK_NO_INFINITE_LOOP */
+
+
+/************************** Ethernet CRC benchmark options ***************************/
+
+/** \brief Enable or disable the ethernet CRC benchmark */
+#define BENCH_CRC_ENABLED                   1u
+
+
+/************************** Internet checksum benchmark options ***************************/
+
+/** \brief Enable or disable the internet checksum benchmark */
+#define BENCH_CHECKSUM_ENABLED              1u
+
+
+/************************** Table lock contention benchmark options ***************************/
+
+#ifndef NANO_IP_OAL_TASK_NO_INFINITE_LOOP
+/** \brief Enable or disable the table lock contention benchmark */
+#define BENCH_CONTENTION_ENABLED            1u
+#else
+/** \brief The tasks of an OS-less target can't run concurrently */
+#define BENCH_CONTENTION_ENABLED            0u
+#endif /* NANO_IP_OAL_TASK_NO_INFINITE_LOOP */
+
+/** \brief Largest number of tasks concurrently searching the table (the number of tasks is doubled at each step) */
+#define BENCH_CONTENTION_MAX_TASKS          4u
+
+
+
+
+
+
+/********************** Benchmark's local variables *************************/
+
+
+/** \brief Benchmarked operation, runs count iterations */
+typedef void (*bench_func_t)(void* const param, const uint32_t count);
+
+/** \brief Buffer processed by a benchmarked operation */
+typedef struct _bench_buffer_t
+{
+    /** \brief Data */
+    const uint8_t* data;
+    /** \brief Size in bytes */
+    uint32_t size;
+} bench_buffer_t;
+
+
+/** \brief Benchmark task handle */
+static oal_task_t s_bench_task;
+
+/** \brief Benchmark task synchronization object (only used to wait forever once the benchmarks are done) */
+static oal_flags_t s_bench_sync_object;
+
+/** \brief Indicate that the benchmarks have been run */
+static bool s_bench_done;
+
+/** \brief Result of the benchmarked computations, kept so that they can't be optimized out */
+static volatile uint32_t s_bench_result;
+
+/** \brief Buffer sizes in bytes of the buffer benchmarks */
+static const uint16_t s_bench_buffer_sizes[] = {20u, 64u, 576u, 1514u, 9000u};
+
+/** \brief Data of the buffer benchmarks */
+static uint8_t s_bench_buffer[9000u];
+
+/** \brief Benchmark task */
+static void BENCH_Task(void* param);
+
+/** \brief Run an operation by batches until the minimum measurement duration has elapsed, returns the mean duration of an iteration in nanoseconds */
+static uint32_t BENCH_Measure(const bench_func_t func, void* const param, const uint32_t batch_size);
+
+/** \brief Compare 2 implementations of a computation on buffers of increasing sizes */
+static void BENCH_CompareOnBuffers(const bench_func_t reference_func, const bench_func_t func);
+
+
+
+#if (BENCH_ALLOCATOR_ENABLED == 1u)
+
+/** \brief Packet allocator benchmark context */
+typedef struct _bench_allocator_t
+{
+    /** \brief Packet allocator */
+    nano_ip_net_packet_allocator_t allocator;
+    /** \brief Packets held by the benchmark, oldest first */
+    nano_ip_net_packet_t* packets[BENCH_ALLOCATOR_MAX_POOL_SIZE];
+    /** \brief Number of held packets */
+    uint32_t count;
+    /** \brief Index of the oldest held packet */
+    uint32_t oldest;
+} bench_allocator_t;
+
+/** \brief Big buffers of the packet allocator */
+static uint8_t s_allocator_big_buffers[BENCH_ALLOCATOR_MAX_POOL_SIZE * BENCH_ALLOCATOR_BUFFER_SIZE];
+
+/** \brief Big buffers descriptions of the packet allocator */
+static big_small_buffer_desc_t s_allocator_big_buffers_descs[BENCH_ALLOCATOR_MAX_POOL_SIZE];
+
+/** \brief Small buffer of the packet allocator (never used by the benchmark) */
+static uint8_t s_allocator_small_buffers[BENCH_ALLOCATOR_BUFFER_SIZE / 2u];
+
+/** \brief Small buffer description of the packet allocator */
+static big_small_buffer_desc_t s_allocator_small_buffers_descs[1u];
+
+/** \brief Packet allocator data */
+static big_small_packet_allocator_data_t s_allocator_data;
+
+/** \brief Packet allocator benchmark context */
+static bench_allocator_t s_bench_allocator;
+
+/** \brief Packet allocator benchmark */
+static void BENCH_Allocator(void);
+
+/** \brief Release the oldest held packet and allocate a new one */
+static void BENCH_AllocatorReleaseAllocate(void* const param, const uint32_t count);
+
+#endif /* BENCH_ALLOCATOR_ENABLED */
+
+
+
+#if (BENCH_SLAB_ENABLED == 1u)
+
+/** \brief Number of size classes of the slab packet allocator */
+#define BENCH_SLAB_CLASS_COUNT              3u
+
+/** \brief Buffers of the small size class */
+STATIC_INSTANCE_SLAB_PACKET_ALLOCATOR_CLASS(s_slab_small, 128u, BENCH_SLAB_SMALL_BUFFER_COUNT);
+
+/** \brief Buffers of the medium size class */
+STATIC_INSTANCE_SLAB_PACKET_ALLOCATOR_CLASS(s_slab_medium, 576u, BENCH_SLAB_SMALL_BUFFER_COUNT);
+
+/** \brief Buffers of the big size class */
+STATIC_INSTANCE_SLAB_PACKET_ALLOCATOR_CLASS(s_slab_big, 1536u, BENCH_SLAB_BIG_BUFFER_COUNT);
+
+/** \brief Size classes of the slab packet allocator */
+static slab_packet_allocator_class_t s_slab_classes[BENCH_SLAB_CLASS_COUNT];
+
+/** \brief Slab packet allocator data */
+static slab_packet_allocator_data_t s_slab_data;
+
+/** \brief Slab packet allocator */
+static nano_ip_net_packet_allocator_t s_slab_allocator;
+
+/** \brief Packets held by the benchmark, the packet at index i has the size s_slab_packet_sizes[i % 6] */
+static nano_ip_net_packet_t* s_slab_packets[BENCH_SLAB_HELD_COUNT];
+
+/** \brief Packet sizes of the benchmark, half of them best fit the small class */
+static const uint16_t s_slab_packet_sizes[] = {64u, 100u, 128u, 300u, 576u, 1514u};
+
+/** \brief Index of the oldest held packet */
+static uint32_t s_slab_oldest;
+
+/** \brief Slab packet allocator benchmark */
+static void BENCH_Slab(void);
+
+/** \brief Release the oldest held packet and allocate a new one of the same size */
+static void BENCH_SlabReleaseAllocate(void* const param, const uint32_t count);
+
+#endif /* BENCH_SLAB_ENABLED */
+
+
+
+#if (BENCH_FLAGS_ENABLED == 1u)
+
+/** \brief Ping event */
+#define BENCH_FLAGS_PING                    1u
+
+/** \brief Pong event */
+#define BENCH_FLAGS_PONG                    2u
+
+/** \brief Pong task handle */
+static oal_task_t s_pong_task;
+
+/** \brief Flags set by the benchmark task and waited by the pong task */
+static oal_flags_t s_ping_flags;
+
+/** \brief Flags set by the pong task and waited by the benchmark task */
+static oal_flags_t s_pong_flags;
+
+/** \brief OAL flags benchmark */
+static void BENCH_Flags(void);
+
+/** \brief Set flags and get them back without waiting */
+static void BENCH_FlagsSetWait(void* const param, const uint32_t count);
+
+/** \brief Send a ping to the pong task and wait for its pong */
+static void BENCH_FlagsPingPong(void* const param, const uint32_t count);
+
+/** \brief Pong task */
+static void BENCH_FlagsPongTask(void* param);
+
+#endif /* BENCH_FLAGS_ENABLED */
+
+
+
+#if (BENCH_CRC_ENABLED == 1u)
+
+/** \brief Ethernet CRC benchmark */
+static void BENCH_Crc(void);
+
+/** \brief Reference ethernet FCS computation : nibble per nibble CRC and bit reversal of the result (implementation replaced by the table driven CRC) */
+static uint32_t BENCH_CrcReferenceFcs(const uint8_t* const data, const uint32_t size);
+
+/** \brief Compute the FCS of a buffer with the reference implementation */
+static void BENCH_CrcReference(void* const param, const uint32_t count);
+
+/** \brief Compute the FCS of a buffer with the stack implementation */
+static void BENCH_CrcStack(void* const param, const uint32_t count);
+
+#endif /* BENCH_CRC_ENABLED */
+
+
+
+#if (BENCH_CHECKSUM_ENABLED == 1u)
+
+/** \brief Internet checksum benchmark */
+static void BENCH_Checksum(void);
+
+/** \brief Reference internet checksum computation : 16 bits words sum (implementation replaced by the 64 bits accumulation) */
+static uint16_t BENCH_ChecksumReferenceCompute(const uint8_t* const buffer, uint16_t size);
+
+/** \brief Compute the internet checksum of a buffer with the reference implementation */
+static void BENCH_ChecksumReference(void* const param, const uint32_t count);
+
+/** \brief Compute the internet checksum of a buffer with the stack implementation */
+static void BENCH_ChecksumStack(void* const param, const uint32_t count);
+
+#endif /* BENCH_CHECKSUM_ENABLED */
+
+
+
+#if (BENCH_CONTENTION_ENABLED == 1u)
+
+/** \brief Route table searched by the contention benchmark, protected either by a mutex or by a sequence lock */
+static nano_ip_net_route_t s_contention_table[NANO_IP_MAX_NET_ROUTE_COUNT];
+
+/** \brief Mutex protecting the table (stack lock) */
+static oal_mutex_t s_contention_mutex;
+
+/** \brief Sequence lock protecting the table (route and ARP tables lock) */
+static oal_seqlock_t s_contention_seqlock;
+
+/** \brief Helper tasks searching the table concurrently with the benchmark task */
+static oal_task_t s_contention_tasks[BENCH_CONTENTION_MAX_TASKS - 1u];
+
+/** \brief Start flags of the helper tasks (1 flag per task) */
+static oal_flags_t s_contention_start_flags;
+
+/** \brief Done flags of the helper tasks (1 flag per task) */
+static oal_flags_t s_contention_done_flags;
+
+/** \brief Search operation of the current measurement */
+static volatile bench_func_t s_contention_func;
+
+/** \brief Indicate that the current measurement is running */
+static volatile bool s_contention_running;
+
+/** \brief Number of searches done by each task during the current measurement */
+static volatile uint32_t s_contention_counts[BENCH_CONTENTION_MAX_TASKS];
+
+/** \brief Table lock contention benchmark */
+static void BENCH_Contention(void);
+
+/** \brief Measure the number of searches per millisecond of all the tasks with a given number of concurrent tasks */
+static uint32_t BENCH_ContentionMeasure(const bench_func_t func, const uint32_t task_count);
+
+/** \brief Search the table until the end of the current measurement, returns the number of searches */
+static uint32_t BENCH_ContentionRun(void);
+
+/** \brief Search the table under the mutex */
+static void BENCH_ContentionMutexSearch(void* const param, const uint32_t count);
+
+/** \brief Search the table under the sequence lock */
+static void BENCH_ContentionSeqlockSearch(void* const param, const uint32_t count);
+
+/** \brief Helper task */
+static void BENCH_ContentionTask(void* param);
+
+#endif /* BENCH_CONTENTION_ENABLED */
+
+
+
+
+
+
+/** \brief Application entry point */
+int main(void)
+{
+    bool ret = false;
+    nano_ip_error_t err = NIP_ERR_FAILURE;
+
+    /* Initialize operating system */
+    ret = NANO_IP_BSP_OSInit();
+    if (ret)
+    {
+        /* Initialize the OS abstraction layer, the stack itself is not needed */
+        err = NANO_IP_OAL_Init();
+        if (err == NIP_ERR_SUCCESS)
+        {
+            err = NANO_IP_OAL_FLAGS_Create(&s_bench_sync_object);
+        }
+        if (err == NIP_ERR_SUCCESS)
+        {
+            /* Create the benchmark task */
+            s_bench_done = false;
+            err = NANO_IP_OAL_TASK_Create(&s_bench_task, "Benchmark task", BENCH_Task, NULL);
+        }
+    }
+
+    if (err == NIP_ERR_SUCCESS)
+    {
+        /* Start operating system */
+        ret = NANO_IP_BSP_OSStart();
+    }
+    else
+    {
+        NANO_IP_LOG_ERROR("main() : Error %d during initalization", NANO_IP_CAST(int32_t, err));
+    }
+
+    return 0;
+}
+
+
+/** \brief Benchmark task */
+static void BENCH_Task(void* param)
+{
+    (void)param;
+
+    /* Run the benchmarks once */
+    if (!s_bench_done)
+    {
+        uint32_t i;
+
+        /* Pseudo-random buffer data */
+        for (i = 0u; i < sizeof(s_bench_buffer); i++)
+        {
+            s_bench_buffer[i] = NANO_IP_CAST(uint8_t, (i * 2654435761u) >> 24u);
+        }
+
+        NANO_IP_LOG_INFO("Benchmarks started (%d ms per measurement)", NANO_IP_CAST(int32_t, BENCH_MIN_DURATION));
+
+        #if (BENCH_ALLOCATOR_ENABLED == 1u)
+        BENCH_Allocator();
+        #endif /* BENCH_ALLOCATOR_ENABLED */
+
+        #if (BENCH_SLAB_ENABLED == 1u)
+        BENCH_Slab();
+        #endif /* BENCH_SLAB_ENABLED */
+
+        #if (BENCH_FLAGS_ENABLED == 1u)
+        BENCH_Flags();
+        #endif /* BENCH_FLAGS_ENABLED */
+
+        #if (BENCH_CRC_ENABLED == 1u)
+        BENCH_Crc();
+        #endif /* BENCH_CRC_ENABLED */
+
+        #if (BENCH_CHECKSUM_ENABLED == 1u)
+        BENCH_Checksum();
+        #endif /* BENCH_CHECKSUM_ENABLED */
+
+        #if (BENCH_CONTENTION_ENABLED == 1u)
+        BENCH_Contention();
+        #endif /* BENCH_CONTENTION_ENABLED */
+
+        NANO_IP_LOG_INFO("Benchmarks done");
+        s_bench_done = true;
+    }
+
+    #ifndef NANO_IP_OAL_TASK_NO_INFINITE_LOOP
+    /* Nothing more to do */
+    while (true)
+    {
+        uint32_t flags = NANO_IP_OAL_FLAGS_ALL;
+        (void)NANO_IP_OAL_FLAGS_Wait(&s_bench_sync_object, &flags, true, NANO_IP_MAX_TIMEOUT_VALUE);
+    }
+    #endif /* NANO_IP_OAL_TASK_NO_INFINITE_LOOP */
+}
+
+/** \brief Run an operation by batches until the minimum measurement duration has elapsed, returns the mean duration of an iteration in nanoseconds */
+static uint32_t BENCH_Measure(const bench_func_t func, void* const param, const uint32_t batch_size)
+{
+    uint32_t elapsed;
+    uint64_t count = 0u;
+    const uint32_t start = NANO_IP_OAL_TIME_GetMsCounter();
+
+    do
+    {
+        func(param, batch_size);
+        count += batch_size;
+        elapsed = NANO_IP_OAL_TIME_GetMsCounter() - start;
+    }
+    while (elapsed < BENCH_MIN_DURATION);
+
+    return NANO_IP_CAST(uint32_t, (NANO_IP_CAST(uint64_t, elapsed) * 1000000u) / count);
+}
+
+/** \brief Compare 2 implementations of a computation on buffers of increasing sizes */
+static void BENCH_CompareOnBuffers(const bench_func_t reference_func, const bench_func_t func)
+{
+    uint32_t i;
+
+    for (i = 0u; i < (sizeof(s_bench_buffer_sizes) / sizeof(s_bench_buffer_sizes[0u])); i++)
+    {
+        uint32_t reference_result;
+        uint32_t reference_duration;
+        uint32_t duration;
+        bench_buffer_t buffer;
+        buffer.data = s_bench_buffer;
+        buffer.size = s_bench_buffer_sizes[i];
+
+        /* Both implementations must give the same result */
+        reference_func(&buffer, 1u);
+        reference_result = s_bench_result;
+        func(&buffer, 1u);
+        if (s_bench_result == reference_result)
+        {
+            /* Throughput in MB/s = bytes per nanosecond * 1000 */
+            reference_duration = BENCH_Measure(reference_func, &buffer, 100u);
+            duration = BENCH_Measure(func, &buffer, 100u);
+            NANO_IP_LOG_INFO("  %d bytes : %d ns (%d MB/s) => %d ns (%d MB/s)", 
+                             NANO_IP_CAST(int32_t, buffer.size),
+                             NANO_IP_CAST(int32_t, reference_duration), NANO_IP_CAST(int32_t, ((buffer.size * 1000u) / (reference_duration + 1u))),
+                             NANO_IP_CAST(int32_t, duration), NANO_IP_CAST(int32_t, ((buffer.size * 1000u) / (duration + 1u))));
+        }
+        else
+        {
+            NANO_IP_LOG_ERROR("  %d bytes : result mismatch 0x%x != 0x%x", NANO_IP_CAST(int32_t, buffer.size), 
+                              NANO_IP_CAST(int32_t, s_bench_result), NANO_IP_CAST(int32_t, reference_result));
+        }
+    }
+}
+
+
+
+#if (BENCH_ALLOCATOR_ENABLED == 1u)
+
+/** \brief Packet allocator benchmark */
+static void BENCH_Allocator(void)
+{
+    uint32_t pool_size;
+
+    NANO_IP_LOG_INFO("Big/small packet allocator : release + allocate with all the buffers but one in use");
+    for (pool_size = BENCH_ALLOCATOR_MIN_POOL_SIZE; pool_size <= BENCH_ALLOCATOR_MAX_POOL_SIZE; pool_size *= 4u)
+    {
+        nano_ip_error_t err;
+        bench_allocator_t* const bench = &s_bench_allocator;
+
+        /* Create an allocator with pool_size big buffers */
+        s_allocator_data.big_buffer_size = BENCH_ALLOCATOR_BUFFER_SIZE;
+        s_allocator_data.big_buffers_count = NANO_IP_CAST(uint16_t, pool_size);
+        s_allocator_data.big_buffers = s_allocator_big_buffers;
+        s_allocator_data.big_buffers_descs = s_allocator_big_buffers_descs;
+        s_allocator_data.small_buffer_size = (BENCH_ALLOCATOR_BUFFER_SIZE / 2u);
+        s_allocator_data.small_buffers_count = 1u;
+        s_allocator_data.small_buffers = s_allocator_small_buffers;
+        s_allocator_data.small_buffers_descs = s_allocator_small_buffers_descs;
+        err = NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_Init(&bench->allocator, &s_allocator_data);
+
+        /* Hold all the buffers but one, the oldest one is the last of the used buffers list */
+        bench->count = 0u;
+        bench->oldest = 0u;
+        while ((err == NIP_ERR_SUCCESS) && (bench->count < (pool_size - 1u)))
+        {
+            err = bench->allocator.allocate(bench->allocator.allocator_data, &bench->packets[bench->count], BENCH_ALLOCATOR_BUFFER_SIZE);
+            if (err == NIP_ERR_SUCCESS)
+            {
+                bench->count++;
+            }
+        }
+        if (err == NIP_ERR_SUCCESS)
+        {
+            const uint32_t duration = BENCH_Measure(BENCH_AllocatorReleaseAllocate, bench, 1000u);
+            NANO_IP_LOG_INFO("  %d buffers : %d ns", NANO_IP_CAST(int32_t, pool_size), NANO_IP_CAST(int32_t, duration));
+        }
+        else
+        {
+            NANO_IP_LOG_ERROR("  %d buffers : error %d", NANO_IP_CAST(int32_t, pool_size), NANO_IP_CAST(int32_t, err));
+        }
+
+        /* Give back the held buffers */
+        while (bench->count != 0u)
+        {
+            (void)bench->allocator.release(bench->allocator.allocator_data, bench->packets[bench->oldest]);
+            bench->oldest = ((bench->oldest + 1u) % (pool_size - 1u));
+            bench->count--;
+        }
+    }
+}
+
+/** \brief Release the oldest held packet and allocate a new one */
+static void BENCH_AllocatorReleaseAllocate(void* const param, const uint32_t count)
+{
+    uint32_t i;
+    bench_allocator_t* const bench = NANO_IP_CAST(bench_allocator_t*, param);
+
+    for (i = 0u; i < count; i++)
+    {
+        nano_ip_net_packet_t** const packet = &bench->packets[bench->oldest];
+        (void)bench->allocator.release(bench->allocator.allocator_data, (*packet));
+        (void)bench->allocator.allocate(bench->allocator.allocator_data, packet, BENCH_ALLOCATOR_BUFFER_SIZE);
+        bench->oldest++;
+        if (bench->oldest == bench->count)
+        {
+            bench->oldest = 0u;
+        }
+    }
+}
+
+#endif /* BENCH_ALLOCATOR_ENABLED */
+
+
+
+#if (BENCH_SLAB_ENABLED == 1u)
+
+/** \brief Slab packet allocator benchmark */
+static void BENCH_Slab(void)
+{
+    nano_ip_error_t err;
+    uint32_t i;
+
+    NANO_IP_LOG_INFO("Slab packet allocator : release + allocate of mixed sizes with %d packets held", NANO_IP_CAST(int32_t, BENCH_SLAB_HELD_COUNT));
+
+    /* Create an allocator with 3 size classes */
+    SLAB_PACKET_ALLOCATOR_CLASS_INIT(s_slab_classes[0u], s_slab_small, 128u, BENCH_SLAB_SMALL_BUFFER_COUNT);
+    SLAB_PACKET_ALLOCATOR_CLASS_INIT(s_slab_classes[1u], s_slab_medium, 576u, BENCH_SLAB_SMALL_BUFFER_COUNT);
+    SLAB_PACKET_ALLOCATOR_CLASS_INIT(s_slab_classes[2u], s_slab_big, 1536u, BENCH_SLAB_BIG_BUFFER_COUNT);
+    s_slab_data.classes = s_slab_classes;
+    s_slab_data.classes_count = BENCH_SLAB_CLASS_COUNT;
+    err = NANO_IP_SLAB_PACKET_ALLOCATOR_Init(&s_slab_allocator, &s_slab_data);
+
+    /* Hold the packets, the small and medium classes overflow into the bigger ones */
+    for (i = 0u; i < BENCH_SLAB_HELD_COUNT; i++)
+    {
+        s_slab_packets[i] = NULL;
+        if (err == NIP_ERR_SUCCESS)
+        {
+            err = s_slab_allocator.allocate(s_slab_allocator.allocator_data, &s_slab_packets[i],
+                                            s_slab_packet_sizes[i % (sizeof(s_slab_packet_sizes) / sizeof(s_slab_packet_sizes[0u]))]);
+        }
+    }
+    if (err == NIP_ERR_SUCCESS)
+    {
+        uint8_t class_index;
+        uint32_t duration;
+
+        /* Only count the allocations of the measurement */
+        s_slab_oldest = 0u;
+        (void)NANO_IP_SLAB_PACKET_ALLOCATOR_ResetStats(&s_slab_data);
+        duration = BENCH_Measure(BENCH_SlabReleaseAllocate, NULL, 1000u);
+        NANO_IP_LOG_INFO("  %d ns", NANO_IP_CAST(int32_t, duration));
+
+        /* Usage of the size classes */
+        for (class_index = 0u; class_index < BENCH_SLAB_CLASS_COUNT; class_index++)
+        {
+            slab_packet_allocator_stats_t stats;
+            (void)NANO_IP_SLAB_PACKET_ALLOCATOR_GetStats(&s_slab_data, class_index, &stats);
+            NANO_IP_LOG_INFO("  %d bytes class : %d allocations, %d fallbacks, %d failures, %d/%d buffers used at most",
+                             NANO_IP_CAST(int32_t, s_slab_classes[class_index].buffer_size), NANO_IP_CAST(int32_t, stats.allocations),
+                             NANO_IP_CAST(int32_t, stats.fallbacks), NANO_IP_CAST(int32_t, stats.failures),
+                             NANO_IP_CAST(int32_t, stats.high_watermark), NANO_IP_CAST(int32_t, s_slab_classes[class_index].buffers_count));
+        }
+    }
+    else
+    {
+        NANO_IP_LOG_ERROR("  error %d", NANO_IP_CAST(int32_t, err));
+    }
+
+    /* Give back the held packets */
+    for (i = 0u; i < BENCH_SLAB_HELD_COUNT; i++)
+    {
+        if (s_slab_packets[i] != NULL)
+        {
+            (void)s_slab_allocator.release(s_slab_allocator.allocator_data, s_slab_packets[i]);
+        }
+    }
+}
+
+/** \brief Release the oldest held packet and allocate a new one of the same size */
+static void BENCH_SlabReleaseAllocate(void* const param, const uint32_t count)
+{
+    uint32_t i;
+
+    (void)param;
+
+    for (i = 0u; i < count; i++)
+    {
+        nano_ip_net_packet_t** const packet = &s_slab_packets[s_slab_oldest];
+        (void)s_slab_allocator.release(s_slab_allocator.allocator_data, (*packet));
+        if (s_slab_allocator.allocate(s_slab_allocator.allocator_data, packet,
+                                      s_slab_packet_sizes[s_slab_oldest % (sizeof(s_slab_packet_sizes) / sizeof(s_slab_packet_sizes[0u]))]) != NIP_ERR_SUCCESS)
+        {
+            (*packet) = NULL;
+        }
+        s_slab_oldest++;
+        if (s_slab_oldest == BENCH_SLAB_HELD_COUNT)
+        {
+            s_slab_oldest = 0u;
+        }
+    }
+}
+
+#endif /* BENCH_SLAB_ENABLED */
+
+
+
+#if (BENCH_FLAGS_ENABLED == 1u)
+
+/** \brief OAL flags benchmark */
+static void BENCH_Flags(void)
+{
+    nano_ip_error_t err;
+
+    /* Create the pong task and its synchronization objects */
+    err = NANO_IP_OAL_FLAGS_Create(&s_ping_flags);
+    if (err == NIP_ERR_SUCCESS)
+    {
+        err = NANO_IP_OAL_FLAGS_Create(&s_pong_flags);
+    }
+    if (err == NIP_ERR_SUCCESS)
+    {
+        err = NANO_IP_OAL_TASK_Create(&s_pong_task, "Pong task", BENCH_FlagsPongTask, NULL);
+    }
+    if (err == NIP_ERR_SUCCESS)
+    {
+        uint32_t duration;
+
+        NANO_IP_LOG_INFO("OAL flags :");
+        duration = BENCH_Measure(BENCH_FlagsSetWait, NULL, 1000u);
+        NANO_IP_LOG_INFO("  set + wait on set flags : %d ns", NANO_IP_CAST(int32_t, duration));
+        duration = BENCH_Measure(BENCH_FlagsPingPong, NULL, 100u);
+        NANO_IP_LOG_INFO("  ping-pong between 2 tasks : %d ns per round trip", NANO_IP_CAST(int32_t, duration));
+    }
+    else
+    {
+        NANO_IP_LOG_ERROR("OAL flags : error %d", NANO_IP_CAST(int32_t, err));
+    }
+}
+
+/** \brief Set flags and get them back without waiting */
+static void BENCH_FlagsSetWait(void* const param, const uint32_t count)
+{
+    uint32_t i;
+
+    (void)param;
+    for (i = 0u; i < count; i++)
+    {
+        uint32_t flags = BENCH_FLAGS_PONG;
+        (void)NANO_IP_OAL_FLAGS_Set(&s_pong_flags, BENCH_FLAGS_PONG, false);
+        (void)NANO_IP_OAL_FLAGS_Wait(&s_pong_flags, &flags, true, NANO_IP_MAX_TIMEOUT_VALUE);
+    }
+}
+
+/** \brief Send a ping to the pong task and wait for its pong */
+static void BENCH_FlagsPingPong(void* const param, const uint32_t count)
+{
+    uint32_t i;
+
+    (void)param;
+    for (i = 0u; i < count; i++)
+    {
+        uint32_t flags = BENCH_FLAGS_PONG;
+        (void)NANO_IP_OAL_FLAGS_Set(&s_ping_flags, BENCH_FLAGS_PING, false);
+        (void)NANO_IP_OAL_FLAGS_Wait(&s_pong_flags, &flags, true, NANO_IP_MAX_TIMEOUT_VALUE);
+    }
+}
+
+/** \brief Pong task */
+static void BENCH_FlagsPongTask(void* param)
+{
+    (void)param;
+
+    /* Answer each ping with a pong */
+    while (true)
+    {
+        uint32_t flags = BENCH_FLAGS_PING;
+        if (NANO_IP_OAL_FLAGS_Wait(&s_ping_flags, &flags, true, NANO_IP_MAX_TIMEOUT_VALUE) == NIP_ERR_SUCCESS)
+        {
+            (void)NANO_IP_OAL_FLAGS_Set(&s_pong_flags, BENCH_FLAGS_PONG, false);
+        }
+    }
+}
+
+#endif /* BENCH_FLAGS_ENABLED */
+
+
+
+#if (BENCH_CRC_ENABLED == 1u)
+
+/** \brief Ethernet CRC benchmark */
+static void BENCH_Crc(void)
+{
+    NANO_IP_LOG_INFO("Ethernet FCS : nibble per nibble => stack implementation");
+    BENCH_CompareOnBuffers(BENCH_CrcReference, BENCH_CrcStack);
+}
+
+/** \brief Reference ethernet FCS computation : nibble per nibble CRC and bit reversal of the result (implementation replaced by the table driven CRC) */
+static uint32_t BENCH_CrcReferenceFcs(const uint8_t* const data, const uint32_t size)
+{
+    uint32_t i, j;
+    uint32_t fcs = 0u;
+    uint32_t crc32 = 0xFFFFFFFFu;
+
+    for (i = 0u; i < size; i++)
+    {
+        uint8_t byte = data[i];
+        for (j = 0u; j < 2u; j++)
+        {
+            const uint32_t q3 = ((((crc32 >> 28u) ^ (byte >> 3u)) & 0x00000001u) != 0u) ? 0x04C11DB7u : 0x00000000u;
+            const uint32_t q2 = ((((crc32 >> 29u) ^ (byte >> 2u)) & 0x00000001u) != 0u) ? 0x09823B6Eu : 0x00000000u;
+            const uint32_t q1 = ((((crc32 >> 30u) ^ (byte >> 1u)) & 0x00000001u) != 0u) ? 0x130476DCu : 0x00000000u;
+            const uint32_t q0 = ((((crc32 >> 31u) ^ (byte >> 0u)) & 0x00000001u) != 0u) ? 0x2608EDB8u : 0x00000000u;
+            crc32 = (crc32 << 4u) ^ q3 ^ q2 ^ q1 ^ q0;
+            byte >>= 4u;
+        }
+    }
+
+    /* Invert bits order */
+    for (i = 0u; i < 32u; i++)
+    {
+        if ((crc32 & (1u << (31u - i))) != 0u)
+        {
+            fcs += (1u << i);
+        }
+    }
+
+    /* Invert bits value */
+    return ~fcs;
+}
+
+/** \brief Compute the FCS of a buffer with the reference implementation */
+static void BENCH_CrcReference(void* const param, const uint32_t count)
+{
+    uint32_t i;
+    const bench_buffer_t* const buffer = NANO_IP_CAST(const bench_buffer_t*, param);
+
+    for (i = 0u; i < count; i++)
+    {
+        s_bench_result = BENCH_CrcReferenceFcs(buffer->data, buffer->size);
+    }
+}
+
+/** \brief Compute the FCS of a buffer with the stack implementation */
+static void BENCH_CrcStack(void* const param, const uint32_t count)
+{
+    uint32_t i;
+    const bench_buffer_t* const buffer = NANO_IP_CAST(const bench_buffer_t*, param);
+
+    for (i = 0u; i < count; i++)
+    {
+        s_bench_result = ~NANO_IP_ETHERNET_CRC_Update(ETHERNET_CRC_INIT_VALUE, buffer->data, buffer->size);
+    }
+}
+
+#endif /* BENCH_CRC_ENABLED */
+
+
+
+#if (BENCH_CHECKSUM_ENABLED == 1u)
+
+/** \brief Internet checksum benchmark */
+static void BENCH_Checksum(void)
+{
+    NANO_IP_LOG_INFO("Internet checksum : 16 bits words sum => stack implementation");
+    BENCH_CompareOnBuffers(BENCH_ChecksumReference, BENCH_ChecksumStack);
+}
+
+/** \brief Reference internet checksum computation : 16 bits words sum (implementation replaced by the 64 bits accumulation) */
+static uint16_t BENCH_ChecksumReferenceCompute(const uint8_t* const buffer, uint16_t size)
+{
+    uint32_t checksum = 0;
+    const uint16_t* data = NANO_IP_CAST(const uint16_t*, buffer);
+
+    /* Compute sum */
+    while (size > 1)
+    {
+        checksum += (*data);
+        data++;
+        size -= sizeof(uint16_t);
+    }
+    if (size != 0)
+    {
+        checksum += *NANO_IP_CAST(const uint8_t*, data);
+    }
+
+     /*  Fold 32-bit sum to 16 bits */
+    while ((checksum >> 16u) != 0)
+    {
+        checksum = (checksum & 0x0000FFFFu) + (checksum >> 16u);
+    }
+
+    /* Invert result */
+    checksum = ~checksum;
+
+    return NANO_IP_CAST(uint16_t, (checksum & 0x0000FFFFu));
+}
+
+/** \brief Compute the internet checksum of a buffer with the reference implementation */
+static void BENCH_ChecksumReference(void* const param, const uint32_t count)
+{
+    uint32_t i;
+    const bench_buffer_t* const buffer = NANO_IP_CAST(const bench_buffer_t*, param);
+
+    for (i = 0u; i < count; i++)
+    {
+        s_bench_result = BENCH_ChecksumReferenceCompute(buffer->data, NANO_IP_CAST(uint16_t, buffer->size));
+    }
+}
+
+/** \brief Compute the internet checksum of a buffer with the stack implementation */
+static void BENCH_ChecksumStack(void* const param, const uint32_t count)
+{
+    uint32_t i;
+    const bench_buffer_t* const buffer = NANO_IP_CAST(const bench_buffer_t*, param);
+
+    for (i = 0u; i < count; i++)
+    {
+        s_bench_result = NANO_IP_ComputeInternetCS(NULL, 0u, NANO_IP_CAST(uint8_t*, buffer->data), NANO_IP_CAST(uint16_t, buffer->size));
+    }
+}
+
+#endif /* BENCH_CHECKSUM_ENABLED */
+
+
+
+#if (BENCH_CONTENTION_ENABLED == 1u)
+
+/** \brief Table lock contention benchmark */
+static void BENCH_Contention(void)
+{
+    uint32_t i;
+    nano_ip_error_t err;
+
+    /* Fill the table, the searched address only matches the last entry */
+    for (i = 0u; i < NANO_IP_MAX_NET_ROUTE_COUNT; i++)
+    {
+        s_contention_table[i].dest_addr = NANO_IP_CAST(ipv4_address_t, 0x0A000000u + (i << 8u));
+        s_contention_table[i].netmask = 0xFFFFFF00u;
+        s_contention_table[i].gateway_addr = NANO_IP_CAST(ipv4_address_t, 0x0A000001u + (i << 8u));
+        s_contention_table[i].net_if = NULL;
+        s_contention_table[i].used = true;
+    }
+
+    /* Create the helper tasks and their synchronization objects */
+    err = NANO_IP_OAL_MUTEX_Create(&s_contention_mutex);
+    if (err == NIP_ERR_SUCCESS)
+    {
+        err = NANO_IP_OAL_SEQLOCK_Create(&s_contention_seqlock);
+    }
+    if (err == NIP_ERR_SUCCESS)
+    {
+        err = NANO_IP_OAL_FLAGS_Create(&s_contention_start_flags);
+    }
+    if (err == NIP_ERR_SUCCESS)
+    {
+        err = NANO_IP_OAL_FLAGS_Create(&s_contention_done_flags);
+    }
+    for (i = 0u; (i < (BENCH_CONTENTION_MAX_TASKS - 1u)) && (err == NIP_ERR_SUCCESS); i++)
+    {
+        /* Helper task i uses the counter i + 1, the benchmark task uses the counter 0 */
+        err = NANO_IP_OAL_TASK_Create(&s_contention_tasks[i], "Contention task", BENCH_ContentionTask, NANO_IP_CAST(void*, NANO_IP_CAST(uintptr_t, i + 1u)));
+    }
+    if (err == NIP_ERR_SUCCESS)
+    {
+        uint32_t task_count;
+
+        NANO_IP_LOG_INFO("Concurrent searches in a %d entries route table : stack mutex => sequence lock", NANO_IP_CAST(int32_t, NANO_IP_MAX_NET_ROUTE_COUNT));
+        for (task_count = 1u; task_count <= BENCH_CONTENTION_MAX_TASKS; task_count *= 2u)
+        {
+            const uint32_t mutex_searches = BENCH_ContentionMeasure(BENCH_ContentionMutexSearch, task_count);
+            const uint32_t seqlock_searches = BENCH_ContentionMeasure(BENCH_ContentionSeqlockSearch, task_count);
+            NANO_IP_LOG_INFO("  %d tasks : %d searches/ms => %d searches/ms", NANO_IP_CAST(int32_t, task_count),
+                             NANO_IP_CAST(int32_t, mutex_searches), NANO_IP_CAST(int32_t, seqlock_searches));
+        }
+    }
+    else
+    {
+        NANO_IP_LOG_ERROR("Table lock contention : error %d", NANO_IP_CAST(int32_t, err));
+    }
+}
+
+/** \brief Measure the number of searches per millisecond of all the tasks with a given number of concurrent tasks */
+static uint32_t BENCH_ContentionMeasure(const bench_func_t func, const uint32_t task_count)
+{
+    uint32_t i;
+    uint32_t start;
+    uint32_t elapsed;
+    uint32_t helpers_mask = 0u;
+    uint64_t count = 0u;
+
+    /* Start the helper tasks */
+    for (i = 1u; i < task_count; i++)
+    {
+        helpers_mask |= (1u << i);
+    }
+    s_contention_func = func;
+    s_contention_running = true;
+    start = NANO_IP_OAL_TIME_GetMsCounter();
+    (void)NANO_IP_OAL_FLAGS_Set(&s_contention_start_flags, helpers_mask, false);
+
+    /* Search from the benchmark task as well until the end of the measurement */
+    s_contention_counts[0u] = 0u;
+    do
+    {
+        func(NULL, 100u);
+        s_contention_counts[0u] += 100u;
+        elapsed = NANO_IP_OAL_TIME_GetMsCounter() - start;
+    }
+    while (elapsed < BENCH_MIN_DURATION);
+    s_contention_running = false;
+
+    /* Wait for the helper tasks */
+    while (helpers_mask != 0u)
+    {
+        uint32_t flags = helpers_mask;
+        if (NANO_IP_OAL_FLAGS_Wait(&s_contention_done_flags, &flags, true, NANO_IP_MAX_TIMEOUT_VALUE) == NIP_ERR_SUCCESS)
+        {
+            helpers_mask &= ~flags;
+        }
+    }
+    elapsed = NANO_IP_OAL_TIME_GetMsCounter() - start;
+
+    /* Searches of all the tasks */
+    for (i = 0u; i < task_count; i++)
+    {
+        count += s_contention_counts[i];
+    }
+
+    return NANO_IP_CAST(uint32_t, count / elapsed);
+}
+
+/** \brief Search the table until the end of the current measurement, returns the number of searches */
+static uint32_t BENCH_ContentionRun(void)
+{
+    uint32_t count = 0u;
+    const bench_func_t func = s_contention_func;
+
+    while (s_contention_running)
+    {
+        func(NULL, 100u);
+        count += 100u;
+    }
+
+    return count;
+}
+
+/** \brief Search the table under the mutex */
+static void BENCH_ContentionMutexSearch(void* const param, const uint32_t count)
+{
+    uint32_t i, j;
+    const ipv4_address_t dest_addr = NANO_IP_CAST(ipv4_address_t, 0x0A000010u + ((NANO_IP_MAX_NET_ROUTE_COUNT - 1u) << 8u));
+
+    (void)param;
+    for (i = 0u; i < count; i++)
+    {
+        ipv4_address_t gateway_addr = 0u;
+
+        (void)NANO_IP_OAL_MUTEX_Lock(&s_contention_mutex);
+        for (j = 0u; (j < NANO_IP_MAX_NET_ROUTE_COUNT) && (gateway_addr == 0u); j++)
+        {
+            const nano_ip_net_route_t* const route_entry = &s_contention_table[j];
+            if ((route_entry->used) &&
+                (route_entry->dest_addr == (dest_addr & route_entry->netmask)) )
+            {
+                gateway_addr = route_entry->gateway_addr;
+            }
+        }
+        (void)NANO_IP_OAL_MUTEX_Unlock(&s_contention_mutex);
+
+        s_bench_result = gateway_addr;
+    }
+}
+
+/** \brief Search the table under the sequence lock */
+static void BENCH_ContentionSeqlockSearch(void* const param, const uint32_t count)
+{
+    uint32_t i, j;
+    const ipv4_address_t dest_addr = NANO_IP_CAST(ipv4_address_t, 0x0A000010u + ((NANO_IP_MAX_NET_ROUTE_COUNT - 1u) << 8u));
+
+    (void)param;
+    for (i = 0u; i < count; i++)
+    {
+        uint32_t sequence;
+        ipv4_address_t gateway_addr;
+
+        do
+        {
+            sequence = NANO_IP_OAL_SEQLOCK_ReadBegin(&s_contention_seqlock);
+
+            gateway_addr = 0u;
+            for (j = 0u; (j < NANO_IP_MAX_NET_ROUTE_COUNT) && (gateway_addr == 0u); j++)
+            {
+                const nano_ip_net_route_t* const route_entry = &s_contention_table[j];
+                if ((route_entry->used) &&
+                    (route_entry->dest_addr == (dest_addr & route_entry->netmask)) )
+                {
+                    gateway_addr = route_entry->gateway_addr;
+                }
+            }
+        }
+        while (NANO_IP_OAL_SEQLOCK_ReadRetry(&s_contention_seqlock, sequence));
+
+        s_bench_result = gateway_addr;
+    }
+}
+
+/** \brief Helper task */
+static void BENCH_ContentionTask(void* param)
+{
+    const uint32_t index = NANO_IP_CAST(uint32_t, NANO_IP_CAST(uintptr_t, param));
+
+    /* Search the table during each measurement it is started for */
+    while (true)
+    {
+        uint32_t flags = (1u << index);
+        if (NANO_IP_OAL_FLAGS_Wait(&s_contention_start_flags, &flags, true, NANO_IP_MAX_TIMEOUT_VALUE) == NIP_ERR_SUCCESS)
+        {
+            s_contention_counts[index] = BENCH_ContentionRun();
+            (void)NANO_IP_OAL_FLAGS_Set(&s_contention_done_flags, (1u << index), false);
+        }
+    }
+}
+
+#endif /* BENCH_CONTENTION_ENABLED */
@@ -20,6 +20,7 @@ along with Nano-IP.  If not, see <http://www.gnu.org/licenses/>.
 #include "bsp.h"
 #include "stm32f767xx.h"
 #include "uart.h"
+#include "nano_ip.h"
 #include "nano_ip_tools.h"
 #include "nano_ip_synopsys_emac.h"
 #include "nano_ip_big_small_packet_allocator.h"
@@ -62,6 +63,11 @@ bool NANO_IP_BSP_OSStart()
     /* Schedule tasks */
     while(true)
     {
+        #if (NANO_IP_ENABLE_RUN_TO_COMPLETION != 0u)
+        /* Run the stack */
+        (void)NANO_IP_Poll(NANO_IP_NET_IF_RX_POLL_BUDGET);
+        #endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
+
         NANO_IP_OAL_TASK_Execute();
     }
 
@@ -69,6 +69,27 @@ along with Nano-IP.  If not, see <http://www.gnu.org/licenses/>.
 /** \brief Enable localhost interface */
 #define NANO_IP_ENABLE_LOCALHOST                1u
 
+/** \brief Compute the software ethernet CRC 8 bytes at a time using 8KB of lookup tables (0 = byte per byte using a 1KB table, unused on little-endian ARMv8 targets with CRC32 instructions) */
+#define NANO_IP_ETHERNET_CRC_SLICING_BY_8       1u
+
+/** \brief Maximum number of packets retrieved from a network driver and processed under a single stack lock by the network interface task */
+#define NANO_IP_NET_IF_BURST_SIZE               32u
+
+/** \brief Default maximum number of packets processed per polling round by a network interface in adaptive reception mode */
+#define NANO_IP_NET_IF_RX_POLL_BUDGET           64u
+
+/** \brief Enable the run-to-completion mode: the stack has no task of its own and is run by NANO_IP_Poll() in the application's context,
+           the sockets are then always non-blocking and NANO_IP_SOCKET_Poll() does not wait */
+#define NANO_IP_ENABLE_RUN_TO_COMPLETION        0u
+
+
+/** \brief Period in milliseconds of the stack timers tick (resolution of the protocol timeouts, at least 1 ms:
+           the OAL timers and time counter count milliseconds so sub-millisecond timeouts are not supported) */
+#define NANO_IP_TIMER_TICK_PERIOD               10u
+
+/** \brief Number of slots of the stack timers wheel (power of 2, longer timeouts take several turns of the wheel) */
+#define NANO_IP_TIMER_WHEEL_SIZE                64u
+
 
 /** \brief Maximum number of network routes (must be at least (2u * NANO_IP_MAX_NET_INTERFACES_COUNT + 2u)) */
 #define NANO_IP_MAX_NET_ROUTE_COUNT             ((2u * 2u + 2u) + 0u)
@@ -97,6 +118,39 @@ along with Nano-IP.  If not, see <http://www.gnu.org/licenses/>.
 /** \brief Enable TCP protocol */
 #define NANO_IP_ENABLE_TCP                      1u
 
+/** \brief Maximum number of unacknowledged TCP segments per connection */
+#define NANO_IP_TCP_MAX_TX_SEGMENT_COUNT        8u
+
+/** \brief Initial TCP retransmission timeout in milliseconds */
+#define NANO_IP_TCP_INITIAL_RTO                 1000u
+
+/** \brief Minimum TCP retransmission timeout in milliseconds */
+#define NANO_IP_TCP_MIN_RTO                     200u
+
+/** \brief Maximum TCP retransmission timeout in milliseconds */
+#define NANO_IP_TCP_MAX_RTO                     60000u
+
+/** \brief Size in bytes of the receive buffer of a TCP connection (maximum advertised window) */
+#define NANO_IP_TCP_RX_BUFFER_SIZE              4096u
+
+/** \brief Maximum number of out-of-order segments kept per TCP connection */
+#define NANO_IP_TCP_MAX_RX_OOO_SEGMENT_COUNT    4u
+
+/** \brief Maximum segment size advertised by TCP connections (Ethernet MTU - IPv4 and TCP headers) */
+#define NANO_IP_TCP_MSS                         1460u
+
+/** \brief Maximum delay in milliseconds before acknowledging received TCP data (0 = acknowledge immediately) */
+#define NANO_IP_TCP_DELAYED_ACK_TIMEOUT         100u
+
+
+/*********************************************************/
+/*       Configuration of NanoIP packet allocators       */
+/*********************************************************/
+
+/** \brief Number of free buffers cached per thread and per buffer size by the big small packet allocator 
+           (0 = no cache, accesses to the buffers lists are serialized by a mutex) */
+#define NANO_IP_PACKET_ALLOCATOR_CACHE_SIZE     0u
+
 
 /*********************************************************/
 /*            Configuration of NanoIP log                */
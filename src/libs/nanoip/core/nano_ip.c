@@ -53,8 +53,20 @@ nano_ip_error_t NANO_IP_Init(const nano_ip_net_packet_allocator_t* const packet_
             ret = NANO_IP_OAL_MUTEX_Create(&g_nano_ip.mutex);
         }
 
+        #if (NANO_IP_ENABLE_RUN_TO_COMPLETION != 0u)
+        /* Create the poll set signaling the pending work */
+        if (ret == NIP_ERR_SUCCESS)
+        {
+            ret = NANO_IP_OAL_POLL_Create(&g_nano_ip.poll);
+        }
+        #endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
+
         /* Initialize modules */
         if (ret == NIP_ERR_SUCCESS)
+        {
+            ret = NANO_IP_TIMER_Init();
+        }
+        if (ret == NIP_ERR_SUCCESS)
         {
             ret = NANO_IP_ETHERNET_Init();
         }
@@ -130,3 +142,60 @@ nano_ip_error_t NANO_IP_Start(void)
 
     return ret;
 }
+
+
+#if (NANO_IP_ENABLE_RUN_TO_COMPLETION != 0u)
+
+/** \brief Run the stack in the caller's context : process the drivers' events, up to budget received packets per network interface
+           and the expired timers, returns the number of processed received packets */
+uint32_t NANO_IP_Poll(const uint32_t budget)
+{
+    uint32_t count = 0u;
+    bool budget_exhausted = false;
+    nano_ip_net_if_t* net_if;
+
+    (void)NANO_IP_OAL_MUTEX_Lock(&g_nano_ip.mutex);
+    g_nano_ip.polling = true;
+
+    /* Signals received from now on will trigger a new poll */
+    (void)NANO_IP_OAL_POLL_Acknowledge(&g_nano_ip.poll);
+
+    /* Expired timers */
+    NANO_IP_TIMER_Process();
+
+    /* Network interfaces events */
+    net_if = g_nano_ip.net_ifaces_module.net_ifaces;
+    while (net_if != NULL)
+    {
+        const uint32_t net_if_count = NANO_IP_NET_IF_Poll(net_if, budget);
+        if (net_if_count == budget)
+        {
+            budget_exhausted = true;
+        }
+        count += net_if_count;
+        net_if = net_if->next;
+    }
+
+    /* Keep the poll handle ready while packets are pending, otherwise until the next timer expiry */
+    if (budget_exhausted)
+    {
+        (void)NANO_IP_OAL_POLL_SetTimeout(&g_nano_ip.poll, 0u);
+    }
+    else
+    {
+        (void)NANO_IP_OAL_POLL_SetTimeout(&g_nano_ip.poll, NANO_IP_TIMER_GetNextTimeout());
+    }
+
+    g_nano_ip.polling = false;
+    (void)NANO_IP_OAL_MUTEX_Unlock(&g_nano_ip.mutex);
+
+    return count;
+}
+
+/** \brief Get a handle which is ready when NANO_IP_Poll() has work to do (to be waited on by the application's event loop) */
+nano_ip_error_t NANO_IP_GetPollHandle(oal_poll_handle_t* const handle)
+{
+    return NANO_IP_OAL_POLL_GetHandle(&g_nano_ip.poll, handle);
+}
+
+#endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
@@ -24,6 +24,7 @@ along with Nano-IP.  If not, see <http://www.gnu.org/licenses/>.
 #include "nano_ip_types.h"
 #include "nano_ip_oal.h"
 #include "nano_ip_tools.h"
+#include "nano_ip_timer.h"
 
 #include "nano_ip_net_if.h"
 #include "nano_ip_net_ifaces.h"
@@ -56,6 +57,18 @@ nano_ip_error_t NANO_IP_Init(const nano_ip_net_packet_allocator_t* const packet_
 /** \brief Start Nano IP stack */
 nano_ip_error_t NANO_IP_Start(void);
 
+#if (NANO_IP_ENABLE_RUN_TO_COMPLETION != 0u)
+
+/** \brief Run the stack in the caller's context : process the drivers' events, up to budget received packets per network interface
+           and the expired timers, returns the number of processed received packets
+           (the sockets are non-blocking, their operations return NIP_ERR_IN_PROGRESS until NANO_IP_Poll() has processed the awaited events) */
+uint32_t NANO_IP_Poll(const uint32_t budget);
+
+/** \brief Get a handle which is ready when NANO_IP_Poll() has work to do (to be waited on by the application's event loop) */
+nano_ip_error_t NANO_IP_GetPollHandle(oal_poll_handle_t* const handle);
+
+#endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
+
 
 #ifdef __cplusplus
 }
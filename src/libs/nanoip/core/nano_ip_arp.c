@@ -95,8 +95,14 @@ static nano_ip_error_t NANO_IP_ARP_HandleRequest(nano_ip_net_if_t* const net_if,
 /** \brief Handle an ARP response frame */
 static nano_ip_error_t NANO_IP_ARP_HandleResponse(nano_ip_net_if_t* const net_if, const nano_ip_arp_ipv4_frame_t* const response);
 
-/** \brief ARP periodic task */
-static void NANO_IP_ARP_PeriodicTask(const uint32_t timestamp, void* const user_data);
+/** \brief Remove a request from the requests list, returns true if the request was in the list */
+static bool NANO_IP_ARP_RemoveRequest(nano_ip_arp_request_t* const request);
+
+/** \brief Called when an ARP request has timed out */
+static void NANO_IP_ARP_RequestTimeout(nano_ip_timer_t* const timer, void* const user_data);
+
+/** \brief Look for a valid entry in the ARP table and copy its MAC address, returns true if the entry has been found */
+static bool NANO_IP_ARP_LookForEntry(const ipv4_address_t ipv4_address, uint8_t* const mac_address);
 
 
 
@@ -107,17 +113,15 @@ nano_ip_error_t NANO_IP_ARP_Init(void)
     nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
     nano_ip_arp_module_data_t* const arp_module = &g_nano_ip.arp_module;
 
-    /* Register protocol */
-    arp_module->arp_protocol.ether_type = ARP_PROTOCOL;
-    arp_module->arp_protocol.rx_frame = NANO_IP_ARP_RxFrame;
-    arp_module->arp_protocol.user_data = arp_module;
-    ret = NANO_IP_ETHERNET_AddProtocol(&arp_module->arp_protocol);
+    /* Create the ARP table lock */
+    ret = NANO_IP_OAL_SEQLOCK_Create(&arp_module->table_lock);
     if (ret == NIP_ERR_SUCCESS)
     {
-        /* Register periodic callback */
-        arp_module->eth_callback.callback = NANO_IP_ARP_PeriodicTask;
-        arp_module->eth_callback.user_data = arp_module;
-        ret = NANO_IP_ETHERNET_RegisterPeriodicCallback(&arp_module->eth_callback);
+        /* Register protocol */
+        arp_module->arp_protocol.ether_type = ARP_PROTOCOL;
+        arp_module->arp_protocol.rx_frame = NANO_IP_ARP_RxFrame;
+        arp_module->arp_protocol.user_data = arp_module;
+        ret = NANO_IP_ETHERNET_AddProtocol(&arp_module->arp_protocol);
     }
 
     return ret;
@@ -139,7 +143,7 @@ nano_ip_error_t NANO_IP_ARP_AddEntry(const nano_ip_arp_entry_type_t type, const
         nano_ip_arp_table_entry_t* oldest_entry = NULL;
         nano_ip_arp_module_data_t* const arp_module = &g_nano_ip.arp_module;
 
-        (void)NANO_IP_OAL_MUTEX_Lock(&g_nano_ip.mutex);
+        NANO_IP_OAL_SEQLOCK_WriteLock(&arp_module->table_lock);
 
         while ((i < NANO_IP_MAX_ARP_ENTRY_COUNT) && (corresponding_entry == NULL))
         {
@@ -206,7 +210,7 @@ nano_ip_error_t NANO_IP_ARP_AddEntry(const nano_ip_arp_entry_type_t type, const
             ret = NIP_ERR_RESOURCE;
         }
 
-        (void)NANO_IP_OAL_MUTEX_Unlock(&g_nano_ip.mutex);
+        NANO_IP_OAL_SEQLOCK_WriteUnlock(&arp_module->table_lock);
     }
 
     return ret;
@@ -220,7 +224,7 @@ nano_ip_error_t NANO_IP_ARP_RemoveEntry(const ipv4_address_t ipv4_address)
     nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
     nano_ip_arp_module_data_t* const arp_module = &g_nano_ip.arp_module;
     
-    (void)NANO_IP_OAL_MUTEX_Lock(&g_nano_ip.mutex);
+    NANO_IP_OAL_SEQLOCK_WriteLock(&arp_module->table_lock);
 
     /* Look for the corresponding entry if it exists */   
     while ((i < NANO_IP_MAX_ARP_ENTRY_COUNT) && (ret != NIP_ERR_SUCCESS))
@@ -242,7 +246,7 @@ nano_ip_error_t NANO_IP_ARP_RemoveEntry(const ipv4_address_t ipv4_address)
         i++;
     }
 
-    (void)NANO_IP_OAL_MUTEX_Unlock(&g_nano_ip.mutex);
+    NANO_IP_OAL_SEQLOCK_WriteUnlock(&arp_module->table_lock);
 
     return ret;
 }
@@ -255,48 +259,20 @@ nano_ip_error_t NANO_IP_ARP_Request(nano_ip_net_if_t* const net_if, nano_ip_arp_
     /* Check parameters */
     if ((request != NULL) && (callback != NULL))
     {
-        uint32_t i = NANO_IP_MAX_ARP_ENTRY_COUNT - 1u;
-        nano_ip_arp_table_entry_t* entry = NULL;
         nano_ip_arp_module_data_t* const arp_module = &g_nano_ip.arp_module;
 
         /* Look for the IP address in the table */
-
-        (void)NANO_IP_OAL_MUTEX_Lock(&g_nano_ip.mutex);
-
-        while ((entry == NULL) && (i < NANO_IP_MAX_ARP_ENTRY_COUNT))
+        if (NANO_IP_ARP_LookForEntry(ipv4_address, request->mac_address))
         {
-            /* Check if entry is valid */
-            if ((arp_module->entries[i].entry_type != AET_UNUSED) && (arp_module->entries[i].ipv4_address == ipv4_address))
-            {
-                /* Check validity */
-                const uint32_t timestamp = NANO_IP_OAL_TIME_GetMsCounter();
-                entry = &arp_module->entries[i];
-                if( (entry->entry_type == AET_STATIC) || ((timestamp - entry->timestamp) <= NANO_IP_ARP_ENTRY_VALIDITY_PERIOD) )
-                {
-                    /* Copy MAC address */
-                    MEMCPY(request->mac_address, entry->mac_address, MAC_ADDRESS_SIZE);
-                    ret = NIP_ERR_SUCCESS;
-                }
-                else
-                {
-                    /* Entry is not valid anymore */
-                    entry->entry_type = AET_UNUSED;
-                    entry = NULL;
-                    i = NANO_IP_MAX_ARP_ENTRY_COUNT;
-                }
-            }
-            else
-            {
-                /* Next entry */
-                i--;
-            }
+            ret = NIP_ERR_SUCCESS;
         }
-
-        if (entry == NULL)
+        else
         {
-            /* Send ARP request if not found in the table */
+            /* Send ARP request if not found in the table (the requests list is protected by the stack lock) */
             nano_ip_net_packet_t* packet;
 
+            (void)NANO_IP_OAL_MUTEX_Lock(&g_nano_ip.mutex);
+
             /* Allocate a response frame */
             ret = NANO_IP_ETHERNET_AllocatePacket(ARP_PACKET_SIZE_IPV4, &packet);
             if (ret == NIP_ERR_SUCCESS)
@@ -327,12 +303,15 @@ nano_ip_error_t NANO_IP_ARP_Request(nano_ip_net_if_t* const net_if, nano_ip_arp_
                     request->ipv4_address = ipv4_address;
                     request->response_callback = callback;
                     request->user_data = user_data;
-                    request->timeout = NANO_IP_OAL_TIME_GetMsCounter() + NANO_IP_ARP_REQUEST_TIMEOUT;
 
                     /* Add request to the list */
                     request->next = arp_module->requests;
                     arp_module->requests = request;
 
+                    /* Start timeout */
+                    (void)NANO_IP_TIMER_InitializeTimer(&request->timer, NANO_IP_ARP_RequestTimeout, request);
+                    (void)NANO_IP_TIMER_Start(&request->timer, NANO_IP_ARP_REQUEST_TIMEOUT);
+
                     ret = NIP_ERR_IN_PROGRESS;
                 }
                 else
@@ -341,9 +320,9 @@ nano_ip_error_t NANO_IP_ARP_Request(nano_ip_net_if_t* const net_if, nano_ip_arp_
                     (void)NANO_IP_ETHERNET_ReleasePacket(packet);
                 }
             }
-        }
 
-        (void)NANO_IP_OAL_MUTEX_Unlock(&g_nano_ip.mutex);
+            (void)NANO_IP_OAL_MUTEX_Unlock(&g_nano_ip.mutex);
+        }
     }
 
     return ret;
@@ -357,33 +336,10 @@ nano_ip_error_t NANO_IP_ARP_CancelRequest(nano_ip_arp_request_t* const request)
     /* Check parameters */
     if (request != NULL)
     {
-        nano_ip_arp_request_t* req;
-        nano_ip_arp_request_t* previous_req = NULL;
-        nano_ip_arp_module_data_t* const arp_module = &g_nano_ip.arp_module;
-
-        /* Remove request from the list */
-        
         (void)NANO_IP_OAL_MUTEX_Lock(&g_nano_ip.mutex);
 
-        req = arp_module->requests;
-        while ((req != NULL) && (req != request))
-        {
-            previous_req = req;
-            req = req->next;
-        }
-        if( req != NULL)
-        {
-            if (previous_req == NULL)
-            {
-                arp_module->requests = NULL;
-            }
-            else
-            {
-                previous_req->next = req->next;
-            }
-        }
-
-        if (req != NULL)
+        /* Remove request from the list */
+        if (NANO_IP_ARP_RemoveRequest(request))
         {
             /* Call the callback */
             if (request->response_callback != NULL)
@@ -540,6 +496,7 @@ static nano_ip_error_t NANO_IP_ARP_HandleResponse(nano_ip_net_if_t* const net_if
                 {
                     arp_module->requests = request->next;
                 }
+                (void)NANO_IP_TIMER_Stop(&request->timer);
 
                 /* Call request callback */
                 if (request->response_callback != NULL)
@@ -560,45 +517,82 @@ static nano_ip_error_t NANO_IP_ARP_HandleResponse(nano_ip_net_if_t* const net_if
     return ret;
 }
 
-/** \brief ARP periodic task */
-static void NANO_IP_ARP_PeriodicTask(const uint32_t timestamp, void* const user_data)
+/** \brief Remove a request from the requests list, returns true if the request was in the list */
+static bool NANO_IP_ARP_RemoveRequest(nano_ip_arp_request_t* const request)
 {
-    nano_ip_arp_module_data_t* const arp_module = NANO_IP_CAST(nano_ip_arp_module_data_t*, user_data);
-    if (arp_module != NULL)
+    nano_ip_arp_request_t* req;
+    nano_ip_arp_request_t* previous_req = NULL;
+    nano_ip_arp_module_data_t* const arp_module = &g_nano_ip.arp_module;
+
+    req = arp_module->requests;
+    while ((req != NULL) && (req != request))
     {
-        /* Check requests timeout */
-        nano_ip_arp_request_t* previous_request = NULL;
-        nano_ip_arp_request_t* request = arp_module->requests;
+        previous_req = req;
+        req = req->next;
+    }
+    if (req != NULL)
+    {
+        if (previous_req == NULL)
+        {
+            arp_module->requests = req->next;
+        }
+        else
+        {
+            previous_req->next = req->next;
+        }
+        (void)NANO_IP_TIMER_Stop(&req->timer);
+    }
 
-        while (request != NULL)
+    return (req != NULL);
+}
+
+/** \brief Called when an ARP request has timed out */
+static void NANO_IP_ARP_RequestTimeout(nano_ip_timer_t* const timer, void* const user_data)
+{
+    nano_ip_arp_request_t* const request = NANO_IP_CAST(nano_ip_arp_request_t*, user_data);
+    (void)timer;
+
+    /* Remove request from the list and notify the failure */
+    if ((request != NULL) && NANO_IP_ARP_RemoveRequest(request))
+    {
+        if (request->response_callback != NULL)
         {
-            /* Check timeout */
-            if (request->timeout < timestamp)
-            {
-                /* Remove request from list */
-                if (previous_request == NULL)
-                {
-                    arp_module->requests = request->next;
-                }
-                else
-                {
-                    previous_request->next = request->next;
-                }
+            request->response_callback(request->user_data, false);
+        }
+    }
+}
 
-                /* Call request callback */
-                if (request->response_callback != NULL)
+/** \brief Look for a valid entry in the ARP table and copy its MAC address, returns true if the entry has been found */
+static bool NANO_IP_ARP_LookForEntry(const ipv4_address_t ipv4_address, uint8_t* const mac_address)
+{
+    bool found;
+    uint32_t sequence;
+    nano_ip_arp_module_data_t* const arp_module = &g_nano_ip.arp_module;
+    const uint32_t timestamp = NANO_IP_OAL_TIME_GetMsCounter();
+
+    /* Retry if the table has been modified during the search */
+    do
+    {
+        uint32_t i;
+
+        sequence = NANO_IP_OAL_SEQLOCK_ReadBegin(&arp_module->table_lock);
+
+        found = false;
+        for (i = 0u; (i < NANO_IP_MAX_ARP_ENTRY_COUNT) && !found; i++)
+        {
+            const nano_ip_arp_table_entry_t* const entry = &arp_module->entries[i];
+            if ((entry->entry_type != AET_UNUSED) && (entry->ipv4_address == ipv4_address))
+            {
+                /* Expired entries are ignored until they are updated or reused by an addition */
+                if ((entry->entry_type == AET_STATIC) || ((timestamp - entry->timestamp) <= NANO_IP_ARP_ENTRY_VALIDITY_PERIOD))
                 {
-                    request->response_callback(request->user_data, false);
+                    MEMCPY(mac_address, entry->mac_address, MAC_ADDRESS_SIZE);
+                    found = true;
                 }
             }
-            else
-            {
-                previous_request = request;
-            }
-
-            /* Next request */
-            request = request->next;
         }
     }
-}
+    while (NANO_IP_OAL_SEQLOCK_ReadRetry(&arp_module->table_lock, sequence));
 
+    return found;
+}
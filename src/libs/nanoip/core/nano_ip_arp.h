@@ -25,6 +25,8 @@ along with Nano-IP.  If not, see <http://www.gnu.org/licenses/>.
 #include "nano_ip_cfg.h"
 #include "nano_ip_ethernet.h"
 #include "nano_ip_ipv4_def.h"
+#include "nano_ip_oal.h"
+#include "nano_ip_timer.h"
 
 
 #ifdef __cplusplus
@@ -69,8 +71,8 @@ typedef struct _nano_ip_arp_request_t
     uint32_t ipv4_address;
     /** \brief Corresponding MAC address */
     uint8_t mac_address[MAC_ADDRESS_SIZE];
-    /** \brief Timeout */
-    uint32_t timeout;
+    /** \brief Timeout timer */
+    nano_ip_timer_t timer;
     /** \brief Callback */
     nano_ip_arp_resp_callback_t response_callback;
     /** \brief User data */
@@ -82,13 +84,13 @@ typedef struct _nano_ip_arp_request_t
 /** \brief ARP module internal data */
 typedef struct _nano_ip_arp_module_data_t
 {
-    /** \brief Ethernet periodic callback */
-    nano_ip_ethernet_periodic_callback_t eth_callback;
     /** \brief ARP protocol description */
     nano_ip_ethernet_protocol_t arp_protocol;
     /** \brief ARP table */
     nano_ip_arp_table_entry_t entries[NANO_IP_MAX_ARP_ENTRY_COUNT];
-    /** \brief ARP requests */
+    /** \brief ARP table lock (lookups do not lock the table) */
+    oal_seqlock_t table_lock;
+    /** \brief ARP requests (protected by the stack lock) */
     nano_ip_arp_request_t* requests;
 } nano_ip_arp_module_data_t;
 
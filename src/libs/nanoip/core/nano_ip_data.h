@@ -33,6 +33,14 @@ typedef struct _nano_ip_t
 {
     /** \brief Stack mutex */
     oal_mutex_t mutex;
+    /** \brief Timer module internal data */
+    nano_ip_timer_module_data_t timer_module;
+    #if (NANO_IP_ENABLE_RUN_TO_COMPLETION != 0u)
+    /** \brief Poll set ready when the stack has pending work */
+    oal_poll_t poll;
+    /** \brief Indicate if NANO_IP_Poll() is running */
+    bool polling;
+    #endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
     /** \brief Network interfaces module internal data */
     nano_ip_net_ifaces_module_data_t net_ifaces_module;
     #if (NANO_IP_ENABLE_LOCALHOST == 1)
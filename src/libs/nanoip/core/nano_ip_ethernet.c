@@ -18,6 +18,7 @@ along with Nano-IP.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include "nano_ip_ethernet.h"
+#include "nano_ip_ethernet_crc.h"
 #include "nano_ip_packet_funcs.h"
 #include "nano_ip_tools.h"
 #include "nano_ip_data.h"
@@ -29,9 +30,6 @@ along with Nano-IP.  If not, see <http://www.gnu.org/licenses/>.
 /** \brief Ethernet checksum size in bytes */
 #define ETHERNET_CS_SIZE                4u
 
-/** \brief Residue of the computation of the ethernet checksum on a frame */
-#define ETHERNET_CS_RESIDUE             0xC704DD7Bu
-
 
 /** \brief Ethernet broadcast MAC address */
 const uint8_t ETHERNET_BROADCAST_MAC_ADDRESS[MAC_ADDRESS_SIZE] = {0xFFu, 0xFFu, 0xFFu, 0xFFu, 0xFFu, 0xFFu};
@@ -41,8 +39,8 @@ const uint8_t ETHERNET_NULL_MAC_ADDRESS[MAC_ADDRESS_SIZE] = { 0x00u, 0x00u, 0x00
 
 
 
-/** \brief Compute the CRC of an ethernet frame */
-static uint32_t NANO_IP_ETHERNET_ComputeCrc(nano_ip_net_packet_t* const packet, const bool compute_residue);
+/** \brief Copy a packet and its payload segments into a single contiguous packet */
+static nano_ip_error_t NANO_IP_ETHERNET_LinearizePacket(const nano_ip_net_packet_t* const packet, nano_ip_net_packet_t** const linear_packet);
 
 
 
@@ -97,7 +95,7 @@ nano_ip_error_t NANO_IP_ETHERNET_RxFrame(nano_ip_net_if_t* const net_if, nano_ip
             else
             {
                 /* Check against the ethernet residue of crc computation on the frame + FCS */
-                if (NANO_IP_ETHERNET_ComputeCrc(packet, true) == ETHERNET_CS_RESIDUE)
+                if (NANO_IP_ETHERNET_CRC_Update(ETHERNET_CRC_INIT_VALUE, packet->data, NANO_IP_CAST(uint32_t, packet->count) + ETHERNET_CS_SIZE) == ETHERNET_CRC_RESIDUE)
                 {
                     ret = NIP_ERR_SUCCESS;
                 }
@@ -201,49 +199,69 @@ nano_ip_error_t NANO_IP_ETHERNET_SendPacket(nano_ip_net_if_t* const net_if, cons
     /* Check parameters */
     if ((net_if != NULL) && (packet != NULL))
     {
-        /* Pad frame to the minimum ethernet frame size */
-        if ((packet->count < MIN_ETHERNET_FRAME_SIZE) && ((net_if->driver->caps & NETDRV_CAP_ETH_FRAME_PADDING) == 0u) )
+        nano_ip_net_packet_t* frame = packet;
+
+        /* Linearize the payload segments if the driver can't send them as is */
+        ret = NIP_ERR_SUCCESS;
+        if ((packet->segments != NULL) &&
+            (((net_if->driver->caps & NETDRV_CAP_TX_GATHER) == 0u) ||
+             ((net_if->driver->caps & NETDRV_CAP_ETH_CS_COMPUTATION) == 0u) ||
+             ((packet->count + NANO_IP_PACKET_GetSegmentsSize(packet)) < MIN_ETHERNET_FRAME_SIZE)))
         {
-            MEMSET(packet->current, 0, MIN_ETHERNET_FRAME_SIZE - packet->count);
-            packet->count = MIN_ETHERNET_FRAME_SIZE;
+            ret = NANO_IP_ETHERNET_LinearizePacket(packet, &frame);
         }
+        if (ret == NIP_ERR_SUCCESS)
+        {
+            /* Pad frame to the minimum ethernet frame size */
+            if ((frame->count < MIN_ETHERNET_FRAME_SIZE) && ((net_if->driver->caps & NETDRV_CAP_ETH_FRAME_PADDING) == 0u) )
+            {
+                MEMSET(frame->current, 0, MIN_ETHERNET_FRAME_SIZE - frame->count);
+                frame->count = MIN_ETHERNET_FRAME_SIZE;
+            }
 
-        /* Fill ethernet header */
-        packet->current = packet->data;
-        NANO_IP_PACKET_WriteBufferNoCount(packet, eth_header->dest_address, MAC_ADDRESS_SIZE);
-        NANO_IP_PACKET_WriteBufferNoCount(packet, eth_header->src_address, MAC_ADDRESS_SIZE);
-        NANO_IP_PACKET_Write16bitsNoCount(packet, eth_header->ether_type);
+            /* Fill ethernet header */
+            frame->current = frame->data;
+            NANO_IP_PACKET_WriteBufferNoCount(frame, eth_header->dest_address, MAC_ADDRESS_SIZE);
+            NANO_IP_PACKET_WriteBufferNoCount(frame, eth_header->src_address, MAC_ADDRESS_SIZE);
+            NANO_IP_PACKET_Write16bitsNoCount(frame, eth_header->ether_type);
 
-        /* Compute packet CRC */
-        if ((net_if->driver->caps & NETDRV_CAP_ETH_CS_COMPUTATION) == 0u)
-        {
-            /* Append CRC to the packet */
-            uint8_t i;
-            uint32_t fcs = 0u;
-            const uint32_t computed_crc = NANO_IP_ETHERNET_ComputeCrc(packet, false);
-            
-            /* Invert bits order */
-            for (i = 0; i < 32; i++)
+            /* Compute packet CRC */
+            if ((net_if->driver->caps & NETDRV_CAP_ETH_CS_COMPUTATION) == 0u)
             {
-                if ((computed_crc & (1u << (31u - i))) != 0u)
+                /* The reflected CRC gives the FCS bits in transmission order */
+                const uint32_t fcs = ~NANO_IP_ETHERNET_CRC_Update(ETHERNET_CRC_INIT_VALUE, frame->data, frame->count);
+
+                /* Append FCS to the packet */
+                frame->data[frame->count] = (fcs & 0xFFu);
+                frame->data[frame->count + 1u] = ((fcs >> 8u) & 0xFFu);
+                frame->data[frame->count + 2u] = ((fcs >> 16u) & 0xFFu);
+                frame->data[frame->count + 3u] = ((fcs >> 24u) & 0xFFu);
+                frame->count += sizeof(uint32_t);
+            }
+
+            /* Send the packet, the driver owns it until it is returned as sent */
+            frame->flags |= NET_IF_PACKET_FLAG_TX_PENDING;
+            ret = net_if->driver->send_packet(net_if->driver->user_data, frame);
+            if (ret != NIP_ERR_SUCCESS)
+            {
+                /* The driver has not accepted the frame, it can be sent again */
+                frame->flags &= ~NET_IF_PACKET_FLAG_TX_PENDING;
+            }
+            if (frame != packet)
+            {
+                if (ret == NIP_ERR_SUCCESS)
+                {
+                    /* The linearized copy is sent in place of the original packet, drop the reference
+                       given for the transmission (the packet is freed unless its owner keeps a reference) */
+                    (void)g_nano_ip.packet_allocator->release(g_nano_ip.packet_allocator->allocator_data, packet);
+                }
+                else
                 {
-                    fcs += (1u << i);
+                    /* The original packet still belongs to the caller */
+                    (void)g_nano_ip.packet_allocator->release(g_nano_ip.packet_allocator->allocator_data, frame);
                 }
             }
-
-            /* Invert bits value */
-            fcs = ~fcs;
-
-            /* Append FCS to the packet */
-            packet->data[packet->count] = (fcs & 0xFFu);
-            packet->data[packet->count + 1u] = ((fcs >> 8u) & 0xFFu);
-            packet->data[packet->count + 2u] = ((fcs >> 16u) & 0xFFu);
-            packet->data[packet->count + 3u] = ((fcs >> 24u) & 0xFFu);
-            packet->count += sizeof(uint32_t);
         }
-
-        /* Send the packet */
-        ret = net_if->driver->send_packet(net_if->driver->user_data, packet);
     }
 
     return ret;
@@ -259,10 +277,16 @@ nano_ip_error_t NANO_IP_ETHERNET_ReleasePacket(nano_ip_net_packet_t* const packe
     {
         if ((packet->flags & NET_IF_PACKET_FLAG_TX) == 0u)
         {
-            /* Requeue packet for reception */
-            packet->flags = NET_IF_PACKET_FLAG_RX;
-            packet->current = NANO_IP_CAST(uint8_t*, packet->data);
-            ret = packet->net_if->driver->add_rx_packet(packet->net_if->driver->user_data, packet);
+            /* Requeue packet for reception once the last reference has been dropped */
+            if (NANO_IP_PACKET_RecycleRx(packet))
+            {
+                ret = packet->net_if->driver->add_rx_packet(packet->net_if->driver->user_data, packet);
+            }
+            else
+            {
+                /* Packet is still in use */
+                ret = NIP_ERR_SUCCESS;
+            }
         }
         else
         {
@@ -274,104 +298,27 @@ nano_ip_error_t NANO_IP_ETHERNET_ReleasePacket(nano_ip_net_packet_t* const packe
     return ret;
 }
 
-/** \brief Register a periodic callback */
-nano_ip_error_t NANO_IP_ETHERNET_RegisterPeriodicCallback(nano_ip_ethernet_periodic_callback_t* const callback)
+
+/** \brief Copy a packet and its payload segments into a single contiguous packet */
+static nano_ip_error_t NANO_IP_ETHERNET_LinearizePacket(const nano_ip_net_packet_t* const packet, nano_ip_net_packet_t** const linear_packet)
 {
-    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+    nano_ip_error_t ret;
 
-    /* Check parameters */
-    if ((callback != NULL) && (callback->callback != NULL))
+    /* Allocate a packet big enough for the whole frame, its padding and its CRC */
+    uint16_t total_packet_size = packet->count + NANO_IP_PACKET_GetSegmentsSize(packet) + ETHERNET_CS_SIZE;
+    if (total_packet_size < (MIN_ETHERNET_FRAME_SIZE + ETHERNET_CS_SIZE))
     {
-        /* Add callback to the list */
-        callback->next = g_nano_ip.eth_module.callbacks;
-        g_nano_ip.eth_module.callbacks = callback;
-
-        ret = NIP_ERR_SUCCESS;
+        total_packet_size = MIN_ETHERNET_FRAME_SIZE + ETHERNET_CS_SIZE;
     }
-
-    return ret;
-}
-
-/** \brief Ethernet periodic task */
-nano_ip_error_t NANO_IP_ETHERNET_PeriodicTask(void)
-{
-    nano_ip_error_t ret = NIP_ERR_SUCCESS;
-
-    const uint32_t timestamp = NANO_IP_OAL_TIME_GetMsCounter();
-
-    /* Call all the callbacks */
-    nano_ip_ethernet_periodic_callback_t* callback = g_nano_ip.eth_module.callbacks;
-    while (callback != NULL)
+    ret = g_nano_ip.packet_allocator->allocate(g_nano_ip.packet_allocator->allocator_data, linear_packet, total_packet_size);
+    if (ret == NIP_ERR_SUCCESS)
     {
-        if (callback->callback != NULL)
-        {
-            callback->callback(timestamp, callback->user_data);
-        }
-        callback = callback->next;
+        /* Copy the packet data followed by the payload segments */
+        (*linear_packet)->flags = NET_IF_PACKET_FLAG_TX;
+        (*linear_packet)->net_if = packet->net_if;
+        NANO_IP_PACKET_WriteBuffer((*linear_packet), packet->data, packet->count);
+        NANO_IP_PACKET_WriteSegments((*linear_packet), packet->segments);
     }
 
     return ret;
 }
-
-
-/** \brief Compute the CRC of an ethernet frame */
-static uint32_t NANO_IP_ETHERNET_ComputeCrc(nano_ip_net_packet_t* const packet, const bool compute_residue)
-{
-    uint32_t crc32;
-    uint32_t count;
-    uint32_t i, j;
-    uint8_t byte;
-    uint8_t* pbyte;
-    uint32_t q0, q1, q2, q3;
-
-    pbyte = packet->data;
-    count = packet->count;
-    if (compute_residue)
-    {
-        count += sizeof(uint32_t);
-    }
-    crc32 = 0xFFFFFFFF;
-    for (i = 0; i < count; i++, pbyte++) 
-    {
-        byte = (*pbyte);
-        for (j = 0; j < 2; j++) 
-        {
-            if (((crc32 >> 28) ^ (byte >> 3)) & 0x00000001) 
-            {
-                q3 = 0x04C11DB7;
-            } 
-            else 
-            {
-                q3 = 0x00000000;
-            }
-            if (((crc32 >> 29) ^ (byte >> 2)) & 0x00000001) 
-            {
-                q2 = 0x09823B6E;
-            } 
-            else 
-            {
-                q2 = 0x00000000;
-            }
-            if (((crc32 >> 30) ^ (byte >> 1)) & 0x00000001) 
-            {
-                q1 = 0x130476DC;
-            } 
-            else 
-            {
-                q1 = 0x00000000;
-            }
-            if (((crc32 >> 31) ^ (byte >> 0)) & 0x00000001) 
-            {
-                q0 = 0x2608EDB8;
-            } 
-            else 
-            {
-                q0 = 0x00000000;
-            }
-            crc32 = (crc32 << 4) ^ q3 ^ q2 ^ q1 ^ q0;
-            byte >>= 4;
-        }
-    }
-    
-    return crc32;
-}
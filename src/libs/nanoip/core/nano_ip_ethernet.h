@@ -60,17 +60,6 @@ typedef struct _nano_ip_ethernet_protocol_t
     struct _nano_ip_ethernet_protocol_t* next;
 } nano_ip_ethernet_protocol_t;
 
-/** \brief Ethernet periodic callback */
-typedef struct _nano_ip_ethernet_periodic_callback_t
-{
-    /** \brief Callback */
-    void (*callback)(const uint32_t timestamp, void* const user_data);
-    /** \brief User data */
-    void* user_data;
-    /** \brief Next callback */
-    struct _nano_ip_ethernet_periodic_callback_t* next;
-} nano_ip_ethernet_periodic_callback_t;
-
 
 
 /** \brief Ethernet module internal data */
@@ -78,8 +67,6 @@ typedef struct _nano_ip_ethernet_module_data_t
 {
     /** \brief Ethernet protocols */
     nano_ip_ethernet_protocol_t* eth_protocols;
-    /** \brief Ethernet callbacks */
-    nano_ip_ethernet_periodic_callback_t* callbacks;
 } nano_ip_ethernet_module_data_t;
 
 
@@ -103,12 +90,6 @@ nano_ip_error_t NANO_IP_ETHERNET_SendPacket(nano_ip_net_if_t* const net_if, cons
 /** \brief Release an ethernet packet */
 nano_ip_error_t NANO_IP_ETHERNET_ReleasePacket(nano_ip_net_packet_t* const packet);
 
-/** \brief Register a periodic callback */
-nano_ip_error_t NANO_IP_ETHERNET_RegisterPeriodicCallback(nano_ip_ethernet_periodic_callback_t* const callback);
-
-/** \brief Ethernet periodic task */
-nano_ip_error_t NANO_IP_ETHERNET_PeriodicTask(void);
-
 
 #ifdef __cplusplus
 }
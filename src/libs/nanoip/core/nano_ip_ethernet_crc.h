@@ -0,0 +1,49 @@
+/*
+Copyright(c) 2017 Cedric Jimenez
+
+This file is part of Nano-IP.
+
+Nano-IP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Nano-IP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with Nano-IP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef NANO_IP_ETHERNET_CRC_H
+#define NANO_IP_ETHERNET_CRC_H
+
+#include "nano_ip_types.h"
+#include "nano_ip_cfg.h"
+
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+
+/** \brief Initial value of the ethernet CRC */
+#define ETHERNET_CRC_INIT_VALUE         0xFFFFFFFFu
+
+/** \brief Value of the ethernet CRC computed on a frame followed by its valid FCS */
+#define ETHERNET_CRC_RESIDUE            0xDEBB20E3u
+
+
+
+/** \brief Update an ethernet CRC with a buffer (reflected CRC32, the FCS of a frame is the complement of its CRC) */
+uint32_t NANO_IP_ETHERNET_CRC_Update(const uint32_t crc, const uint8_t* const data, const uint32_t size);
+
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* NANO_IP_ETHERNET_CRC_H */
@@ -67,8 +67,11 @@ static nano_ip_error_t NANO_IP_ICMP_HandlePingRequest(const ipv4_header_t* const
 /** \brief Handle an ICMP ping request */
 static nano_ip_error_t NANO_IP_ICMP_HandlePingReply(const ipv4_header_t* const ipv4_header, nano_ip_net_packet_t* const packet);
 
-/** \brief ICMP periodic task */
-static void NANO_IP_ICMP_PeriodicTask(const uint32_t timestamp, void* const user_data);
+/** \brief Remove a request from the requests list, returns true if the request was in the list */
+static bool NANO_IP_ICMP_RemoveRequest(nano_ip_icmp_request_t* const request);
+
+/** \brief Called when an ICMP request has timed out */
+static void NANO_IP_ICMP_RequestTimeout(nano_ip_timer_t* const timer, void* const user_data);
 
 #endif /* NANO_IP_ENABLE_ICMP_PING_REQ */
 
@@ -89,16 +92,6 @@ nano_ip_error_t NANO_IP_ICMP_Init(void)
         icmp_module->ipv4_protocol.rx_frame = NANO_IP_ICMP_RxFrame;
         icmp_module->ipv4_protocol.user_data = icmp_module;
         ret = NANO_IP_IPV4_AddProtocol(&icmp_module->ipv4_protocol);
-
-        #if (NANO_IP_ENABLE_ICMP_PING_REQ == 1)
-        /* Register periodic callback */
-        if (ret == NIP_ERR_SUCCESS)
-        {
-            icmp_module->ipv4_callback.callback = NANO_IP_ICMP_PeriodicTask;
-            icmp_module->ipv4_callback.user_data = icmp_module;
-            ret = NANO_IP_IPV4_RegisterPeriodicCallback(&icmp_module->ipv4_callback);
-        }
-        #endif /* NANO_IP_ENABLE_ICMP_PING_REQ */
     }
 
     return ret;
@@ -121,6 +114,11 @@ nano_ip_error_t NANO_IP_ICMP_InitRequest(nano_ip_icmp_request_t* const request)
         /* Initialize IPv4 handle */
         ret = NANO_IP_IPV4_InitializeHandle(&request->ipv4_handle, request, NANO_IP_ICMP_Ipv4ErrorCallback);
         if (ret == NIP_ERR_SUCCESS)
+        {
+            /* Initialize timeout timer */
+            ret = NANO_IP_TIMER_InitializeTimer(&request->timer, NANO_IP_ICMP_RequestTimeout, request);
+        }
+        if (ret == NIP_ERR_SUCCESS)
         {
             /* Initialize sync object */
             ret = NANO_IP_OAL_FLAGS_Create(&request->sync_obj);
@@ -191,11 +189,13 @@ nano_ip_error_t NANO_IP_ICMP_PingRequest(nano_ip_icmp_request_t* const request,
                     /* Update request data */
                     request->ipv4_address = ipv4_address;
                     request->response_time = NANO_IP_OAL_TIME_GetMsCounter();
-                    request->timeout = request->response_time + timeout;
 
                     /* Add request to the list */
                     request->next = icmp_module->requests;
                     icmp_module->requests = request;
+
+                    /* Start timeout */
+                    (void)NANO_IP_TIMER_Start(&request->timer, timeout);
                 }
                 else
                 {
@@ -256,29 +256,7 @@ nano_ip_error_t NANO_IP_ICMP_CancelRequest(nano_ip_icmp_request_t* const request
     if (request != NULL)
     {
         /* Remove request from the list */
-        nano_ip_icmp_request_t* req;
-        nano_ip_icmp_request_t* previous_req = NULL;
-        nano_ip_icmp_module_data_t* const icmp_module = &g_nano_ip.icmp_module;
-
-        req = icmp_module->requests;
-        while ((req != NULL) && (req != request))
-        {
-            previous_req = req;
-            req = req->next;
-        }
-        if (req != NULL)
-        {
-            if (previous_req == NULL)
-            {
-                icmp_module->requests = NULL;
-            }
-            else
-            {
-                previous_req->next = req->next;
-            }
-        }
-
-        if (req != NULL)
+        if (NANO_IP_ICMP_RemoveRequest(request))
         {
             /* Notify end of request */
             ret = NANO_IP_OAL_FLAGS_Set(&request->sync_obj, PING_REQ_CANCEL_FLAG, false);
@@ -430,7 +408,6 @@ static nano_ip_error_t NANO_IP_ICMP_HandlePingReply(const ipv4_header_t* const i
 {
     nano_ip_error_t ret = NIP_ERR_IGNORE_PACKET;
     nano_ip_icmp_request_t* request;
-    nano_ip_icmp_request_t* previous = NULL;
     nano_ip_icmp_module_data_t* const icmp_module = &g_nano_ip.icmp_module;
 
     /* Decode ping request identifier */
@@ -444,7 +421,6 @@ static nano_ip_error_t NANO_IP_ICMP_HandlePingReply(const ipv4_header_t* const i
     while ((request != NULL) && 
            (request->identifier != identifier))
     {
-        previous = request;
         request = request->next;
     }
     if (request != NULL)
@@ -454,14 +430,7 @@ static nano_ip_error_t NANO_IP_ICMP_HandlePingReply(const ipv4_header_t* const i
         request->response_time = timestamp - request->response_time;
 
         /* Remove request from the list */
-        if (previous == NULL)
-        {
-            icmp_module->requests = NULL;
-        }
-        else
-        {
-            previous->next = request->next;
-        }
+        (void)NANO_IP_ICMP_RemoveRequest(request);
 
         /* Notify end of request */
         ret = NANO_IP_OAL_FLAGS_Set(&request->sync_obj, PING_REQ_SUCCESS_FLAG, false);
@@ -471,42 +440,45 @@ static nano_ip_error_t NANO_IP_ICMP_HandlePingReply(const ipv4_header_t* const i
 }
 
 
-/** \brief ICMP periodic task */
-static void NANO_IP_ICMP_PeriodicTask(const uint32_t timestamp, void* const user_data)
+/** \brief Remove a request from the requests list, returns true if the request was in the list */
+static bool NANO_IP_ICMP_RemoveRequest(nano_ip_icmp_request_t* const request)
 {
-    nano_ip_icmp_module_data_t* const icmp_module = NANO_IP_CAST(nano_ip_icmp_module_data_t*, user_data);
-    if (icmp_module != NULL)
-    {
-        /* Check requests timeout */
-        nano_ip_icmp_request_t* previous_request = NULL;
-        nano_ip_icmp_request_t* request = icmp_module->requests;
+    nano_ip_icmp_request_t* req;
+    nano_ip_icmp_request_t* previous_req = NULL;
+    nano_ip_icmp_module_data_t* const icmp_module = &g_nano_ip.icmp_module;
 
-        while (request != NULL)
+    req = icmp_module->requests;
+    while ((req != NULL) && (req != request))
+    {
+        previous_req = req;
+        req = req->next;
+    }
+    if (req != NULL)
+    {
+        if (previous_req == NULL)
         {
-            /* Check timeout */
-            if (request->timeout < timestamp)
-            {
-                /* Remove request from list */
-                if (previous_request == NULL)
-                {
-                    icmp_module->requests = request->next;
-                }
-                else
-                {
-                    previous_request->next = request->next;
-                }
+            icmp_module->requests = req->next;
+        }
+        else
+        {
+            previous_req->next = req->next;
+        }
+        (void)NANO_IP_TIMER_Stop(&req->timer);
+    }
 
-                /* Notify end of request */
-                (void)NANO_IP_OAL_FLAGS_Set(&request->sync_obj, PING_REQ_TIMEOUT_FLAG, false);
-            }
-            else
-            {
-                previous_request = request;
-            }
+    return (req != NULL);
+}
 
-            /* Next request */
-            request = request->next;
-        }
+/** \brief Called when an ICMP request has timed out */
+static void NANO_IP_ICMP_RequestTimeout(nano_ip_timer_t* const timer, void* const user_data)
+{
+    nano_ip_icmp_request_t* const request = NANO_IP_CAST(nano_ip_icmp_request_t*, user_data);
+    (void)timer;
+
+    /* Remove request from the list and notify the end of request */
+    if ((request != NULL) && NANO_IP_ICMP_RemoveRequest(request))
+    {
+        (void)NANO_IP_OAL_FLAGS_Set(&request->sync_obj, PING_REQ_TIMEOUT_FLAG, false);
     }
 }
 
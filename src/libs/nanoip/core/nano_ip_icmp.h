@@ -26,6 +26,7 @@ along with Nano-IP.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "nano_ip_types.h"
 #include "nano_ip_ipv4.h"
+#include "nano_ip_timer.h"
 
 
 
@@ -50,8 +51,8 @@ typedef struct _nano_ip_icmp_request_t
 {
     /** \brief Requested IPv4 address */
     ipv4_address_t ipv4_address;
-    /** \brief Timeout */
-    uint32_t timeout;
+    /** \brief Timeout timer */
+    nano_ip_timer_t timer;
     /** \brief Response time */
     uint32_t response_time;
     /** \brief Identifier */
@@ -78,8 +79,6 @@ typedef struct _nano_ip_icmp_module_data_t
 
     /** \brief ICMP requests */
     nano_ip_icmp_request_t* requests;
-    /** \brief IPv4 periodic callback */
-    nano_ip_ipv4_periodic_callback_t ipv4_callback;
 
     #endif /* NANO_IP_ENABLE_ICMP_PING_REQ */
 
@@ -58,9 +58,6 @@ static nano_ip_error_t NANO_IP_IPV4_FinalizeSendPacket(nano_ip_ipv4_handle_t* co
 /** \brief Handle a received IPv4 frame */
 static nano_ip_error_t NANO_IP_IPV4_RxFrame(void* user_data, nano_ip_net_if_t* const net_if, const ethernet_header_t* const eth_header, nano_ip_net_packet_t* const packet);
 
-/** \brief IPv4 periodic task */
-static void NANO_IP_IPV4_PeriodicTask(const uint32_t timestamp, void* const user_data);
-
 
 
 /** \brief Initialize the IPv4 module */
@@ -76,11 +73,6 @@ nano_ip_error_t NANO_IP_IPV4_Init(void)
     ret = NANO_IP_ETHERNET_AddProtocol(&ipv4_module->ipv4_protocol);
     if (ret == NIP_ERR_SUCCESS)
     {
-        /* Register periodic callback */
-        ipv4_module->eth_callback.callback = NANO_IP_IPV4_PeriodicTask;
-        ipv4_module->eth_callback.user_data = ipv4_module;
-        ret = NANO_IP_ETHERNET_RegisterPeriodicCallback(&ipv4_module->eth_callback);
-
         /* Add IPv4 broadcast address in the ARP table */
         (void)NANO_IP_ARP_AddEntry(AET_STATIC, ETHERNET_BROADCAST_MAC_ADDRESS, IPV4_BROADCAST_ADDRESS);
     }
@@ -280,25 +272,6 @@ nano_ip_error_t NANO_IP_IPV4_ReleasePacket(nano_ip_net_packet_t* const packet)
     return ret;
 }
 
-/** \brief Register a periodic callback */
-nano_ip_error_t NANO_IP_IPV4_RegisterPeriodicCallback(nano_ip_ipv4_periodic_callback_t* const callback)
-{
-    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
-
-    /* Check parameters */
-    if ((callback != NULL) && (callback->callback != NULL))
-    {
-        nano_ip_ipv4_module_data_t* const ipv4_module = &g_nano_ip.ipv4_module;
-
-        /* Add callback to the list */
-        callback->next = ipv4_module->callbacks;
-        ipv4_module->callbacks = callback;
-
-        ret = NIP_ERR_SUCCESS;
-    }
-
-    return ret;
-}
 
 /** \brief ARP response callback */
 static void NANO_IP_IPV4_ARPResponseCallback(void* const user_data, const bool success)
@@ -316,7 +289,7 @@ static void NANO_IP_IPV4_ARPResponseCallback(void* const user_data, const bool s
         }
         else
         {
-            /* Release packet */
+            /* Drop the transmission reference (the packet is freed unless its owner keeps a reference, ex: for retransmission) */
             (void)NANO_IP_ETHERNET_ReleasePacket(ipv4_handle->packet);
             err = NIP_ERR_ARP_FAILURE;
         }
@@ -341,7 +314,7 @@ static nano_ip_error_t NANO_IP_IPV4_FillHeader(const ipv4_header_t* const ipv4_h
         uint16_t checksum;
         uint8_t* checksum_pos;
         uint8_t* const header_start = &packet->data[ETHERNET_HEADER_SIZE];
-        const uint16_t total_packet_size = packet->count - ETHERNET_HEADER_SIZE;
+        const uint16_t total_packet_size = packet->count - ETHERNET_HEADER_SIZE + NANO_IP_PACKET_GetSegmentsSize(packet);
         uint8_t* const current_pos = packet->current;
         packet->current = header_start;
         NANO_IP_PACKET_Write8bitsNoCount(packet, IPV4_VERSION_IHL_FIELD);
@@ -494,23 +467,3 @@ static nano_ip_error_t NANO_IP_IPV4_RxFrame(void* user_data, nano_ip_net_if_t* c
 
     return ret;
 }
-
-
-/** \brief IPv4 periodic task */
-static void NANO_IP_IPV4_PeriodicTask(const uint32_t timestamp, void* const user_data)
-{
-    nano_ip_ipv4_module_data_t* const ipv4_module = NANO_IP_CAST(nano_ip_ipv4_module_data_t*, user_data);
-    if (ipv4_module != NULL)
-    {
-        /* Call all the callbacks */
-        nano_ip_ipv4_periodic_callback_t* callback = ipv4_module->callbacks;
-        while (callback != NULL)
-        {
-            if (callback->callback != NULL)
-            {
-                callback->callback(timestamp, callback->user_data);
-            }
-            callback = callback->next;
-        }
-    }
-}
@@ -93,30 +93,14 @@ typedef struct _nano_ip_ipv4_protocol_t
 } nano_ip_ipv4_protocol_t;
 
 
-/** \brief IPv4 periodic callback */
-typedef struct _nano_ip_ipv4_periodic_callback_t
-{
-    /** \brief Callback */
-    void(*callback)(const uint32_t timestamp, void* const user_data);
-    /** \brief User data */
-    void* user_data;
-    /** \brief Next callback */
-    struct _nano_ip_ipv4_periodic_callback_t* next;
-} nano_ip_ipv4_periodic_callback_t;
-
-
 
 /** \brief IPv4 module internal data */
 typedef struct _nano_ip_ipv4_module_data_t
 {
     /** \brief IPv4 protocol description */
     nano_ip_ethernet_protocol_t ipv4_protocol;
-    /** \brief Ethernet periodic callback */
-    nano_ip_ethernet_periodic_callback_t eth_callback;
     /** \brief IPv4 protocols */
     nano_ip_ipv4_protocol_t* protocols;
-    /** \brief IPv4 callbacks */
-    nano_ip_ipv4_periodic_callback_t* callbacks;
 } nano_ip_ipv4_module_data_t;
 
 
@@ -146,9 +130,6 @@ nano_ip_error_t NANO_IP_IPV4_HandleIsReady(nano_ip_ipv4_handle_t* const ipv4_han
 /** \brief Release an IPv4 frame */
 nano_ip_error_t NANO_IP_IPV4_ReleasePacket(nano_ip_net_packet_t* const packet);
 
-/** \brief Register a periodic callback */
-nano_ip_error_t NANO_IP_IPV4_RegisterPeriodicCallback(nano_ip_ipv4_periodic_callback_t* const callback);
-
 
 #ifdef __cplusplus
 }
@@ -24,7 +24,10 @@ along with Nano-IP.  If not, see <http://www.gnu.org/licenses/>.
 /** \brief Initialize the route module */
 nano_ip_error_t NANO_IP_ROUTE_Init(void)
 {
-    nano_ip_error_t ret = NIP_ERR_SUCCESS;
+    nano_ip_error_t ret;
+
+    /* Create the route table lock */
+    ret = NANO_IP_OAL_SEQLOCK_Create(&g_nano_ip.route_module.lock);
 
     return ret;
 }
@@ -41,7 +44,7 @@ nano_ip_error_t NANO_IP_ROUTE_Add(const ipv4_address_t dest_addr, const ipv4_add
         nano_ip_route_module_data_t* const route_module = &g_nano_ip.route_module;
 
         /* Look for a free entry */
-        (void)NANO_IP_OAL_MUTEX_Lock(&g_nano_ip.mutex);
+        NANO_IP_OAL_SEQLOCK_WriteLock(&route_module->lock);
 
         ret = NIP_ERR_RESOURCE;
         if (route_module->route_used_entries_count < NANO_IP_MAX_NET_ROUTE_COUNT)
@@ -63,7 +66,7 @@ nano_ip_error_t NANO_IP_ROUTE_Add(const ipv4_address_t dest_addr, const ipv4_add
             }
         }
 
-        (void)NANO_IP_OAL_MUTEX_Unlock(&g_nano_ip.mutex);
+        NANO_IP_OAL_SEQLOCK_WriteUnlock(&route_module->lock);
     }
 
     return ret;
@@ -78,7 +81,7 @@ nano_ip_error_t NANO_IP_ROUTE_Delete(const ipv4_address_t dest_addr, const ipv4_
     const ipv4_address_t netaddr = dest_addr & netmask;
     
     /* Look for the corresponding entry */
-    (void)NANO_IP_OAL_MUTEX_Lock(&g_nano_ip.mutex);
+    NANO_IP_OAL_SEQLOCK_WriteLock(&route_module->lock);
 
     for (i = 0; (i < NANO_IP_MAX_NET_ROUTE_COUNT) && (ret == NIP_ERR_ROUTE_NOT_FOUND); i++)
     {
@@ -94,7 +97,7 @@ nano_ip_error_t NANO_IP_ROUTE_Delete(const ipv4_address_t dest_addr, const ipv4_
         }
     }
 
-    (void)NANO_IP_OAL_MUTEX_Unlock(&g_nano_ip.mutex);
+    NANO_IP_OAL_SEQLOCK_WriteUnlock(&route_module->lock);
 
     return ret;
 }
@@ -108,26 +111,29 @@ nano_ip_error_t NANO_IP_ROUTE_Search(const ipv4_address_t dest_addr, ipv4_addres
     if ((gateway_addr != NULL) && (net_if != NULL))
     {
         uint32_t i;
+        uint32_t sequence;
         nano_ip_route_module_data_t* const route_module = &g_nano_ip.route_module;
 
-        /* Look for a the corresponding entry */
-        (void)NANO_IP_OAL_MUTEX_Lock(&g_nano_ip.mutex);
-
-        ret = NIP_ERR_ROUTE_NOT_FOUND;
-        for (i = 0; (i < NANO_IP_MAX_NET_ROUTE_COUNT) && (ret == NIP_ERR_ROUTE_NOT_FOUND); i++)
+        /* Look for a the corresponding entry (retry if the table has been modified during the search) */
+        do
         {
-            nano_ip_net_route_t* route_entry = &route_module->route_table[i];
-            if ((route_entry->used) &&
-                (route_entry->dest_addr == (dest_addr & route_entry->netmask)) )
+            sequence = NANO_IP_OAL_SEQLOCK_ReadBegin(&route_module->lock);
+
+            ret = NIP_ERR_ROUTE_NOT_FOUND;
+            for (i = 0; (i < NANO_IP_MAX_NET_ROUTE_COUNT) && (ret == NIP_ERR_ROUTE_NOT_FOUND); i++)
             {
-                /* Retrieve route data */
-                (*gateway_addr) = route_entry->gateway_addr;
-                (*net_if) = route_entry->net_if;
-                ret = NIP_ERR_SUCCESS;
+                const nano_ip_net_route_t* const route_entry = &route_module->route_table[i];
+                if ((route_entry->used) &&
+                    (route_entry->dest_addr == (dest_addr & route_entry->netmask)) )
+                {
+                    /* Retrieve route data */
+                    (*gateway_addr) = route_entry->gateway_addr;
+                    (*net_if) = route_entry->net_if;
+                    ret = NIP_ERR_SUCCESS;
+                }
             }
         }
-
-        (void)NANO_IP_OAL_MUTEX_Unlock(&g_nano_ip.mutex);
+        while (NANO_IP_OAL_SEQLOCK_ReadRetry(&route_module->lock, sequence));
     }
 
     return ret;
@@ -24,6 +24,7 @@ along with Nano-IP.  If not, see <http://www.gnu.org/licenses/>.
 #include "nano_ip_error.h"
 #include "nano_ip_cfg.h"
 #include "nano_ip_net_if.h"
+#include "nano_ip_oal.h"
 #include "nano_ip_ipv4_def.h"
 
 #ifdef __cplusplus
@@ -56,6 +57,8 @@ typedef struct _nano_ip_route_module_data_t
     nano_ip_net_route_t route_table[NANO_IP_MAX_NET_ROUTE_COUNT];
     /** \brief Route table used entries count */
     uint32_t route_used_entries_count;
+    /** \brief Route table lock (searches do not lock the table) */
+    oal_seqlock_t lock;
 } nano_ip_route_module_data_t;
 
 
@@ -56,15 +56,54 @@ along with Nano-IP.  If not, see <http://www.gnu.org/licenses/>.
 /** \brief TCP header size in bytes */
 #define TCP_HEADER_SIZE                     0x14u
 
-/** \brief TCP header size in 32bits words (data offset) */
-#define TCP_HEADER_DATA_OFFSET              0x50u
+/** \brief TCP option : end of option list */
+#define TCP_OPTION_END                      0u
+
+/** \brief TCP option : no operation */
+#define TCP_OPTION_NOP                      1u
+
+/** \brief TCP option : maximum segment size */
+#define TCP_OPTION_MSS                      2u
+
+/** \brief TCP maximum segment size option size in bytes */
+#define TCP_OPTION_MSS_SIZE                 4u
+
+/** \brief TCP option : window scale */
+#define TCP_OPTION_WINDOW_SCALE             3u
+
+/** \brief TCP window scale option size in bytes */
+#define TCP_OPTION_WINDOW_SCALE_SIZE        3u
+
+/** \brief TCP option : SACK permitted */
+#define TCP_OPTION_SACK_PERMITTED           4u
+
+/** \brief TCP SACK permitted option size in bytes */
+#define TCP_OPTION_SACK_PERMITTED_SIZE      2u
+
+/** \brief TCP option : selective acknowledge */
+#define TCP_OPTION_SACK                     5u
+
+/** \brief TCP SACK block size in bytes */
+#define TCP_OPTION_SACK_BLOCK_SIZE          8u
+
+/** \brief TCP option : timestamps */
+#define TCP_OPTION_TIMESTAMP                8u
+
+/** \brief TCP timestamps option size in bytes */
+#define TCP_OPTION_TIMESTAMP_SIZE           10u
+
+/** \brief Space reserved in every frame for the timestamps option (2 NOP + option) */
+#define TCP_OPTION_TIMESTAMP_SPACE          12u
+
+/** \brief Maximum window scale shift count (RFC 7323) */
+#define TCP_MAX_WINDOW_SCALE                14u
+
+/** \brief Number of received segments triggering an acknowledge when acknowledges are delayed */
+#define TCP_DELAYED_ACK_SEGMENT_COUNT       2u
 
 /** \brief TCP pseudo header size in bytes */
 #define TCP_PSEUDO_HEADER_SIZE              0x0Cu
 
-/** \brief TCP window size */
-#define TCP_WINDOW_SIZE                     1024u
-
 /** \brief Max retry count for transmitted packets */
 #define TCP_MAX_RETRY_COUNT                 5u
 
@@ -74,6 +113,29 @@ along with Nano-IP.  If not, see <http://www.gnu.org/licenses/>.
 /** \brief TCP port pool start  */
 #define TCP_PORT_POOL_START                 10000u
 
+/** \brief TCP default maximum segment size when the peer does not send the MSS option (RFC 1122) */
+#define TCP_DEFAULT_MSS                     536u
+
+/** \brief TCP minimum maximum segment size, smaller MSS options are raised to it (it must leave room for the timestamps option) */
+#define TCP_MIN_MSS                         48u
+
+#if (NANO_IP_TCP_MSS < TCP_MIN_MSS)
+#error "NANO_IP_TCP_MSS must be at least 48 bytes"
+#endif /* NANO_IP_TCP_MSS */
+
+/** \brief Number of duplicate acknowledges triggering a fast retransmit */
+#define TCP_DUP_ACK_THRESHOLD               3u
+
+/** \brief Maximum congestion window size in bytes */
+#define TCP_MAX_CWND                        0x3FFFFFFFu
+
+
+/** \brief Check if sequence number a is before sequence number b (modulo 2^32) */
+#define TCP_SEQ_LT(a, b)                    (NANO_IP_CAST(int32_t, ((a) - (b))) < 0)
+
+/** \brief Check if sequence number a is before or equal to sequence number b (modulo 2^32) */
+#define TCP_SEQ_LEQ(a, b)                   (NANO_IP_CAST(int32_t, ((a) - (b))) <= 0)
+
 
 
 
@@ -86,8 +148,20 @@ static void NANO_IP_TCP_RemoveHandle(nano_ip_tcp_handle_t* const handle);
 /** \brief Handle a received TCP frame */
 static nano_ip_error_t NANO_IP_TCP_RxFrame(void* user_data, nano_ip_net_if_t* const net_if, const ipv4_header_t* const ipv4_header, nano_ip_net_packet_t* const packet);
 
-/** \brief TCP periodic task */
-static void NANO_IP_TCP_PeriodicTask(const uint32_t timestamp, void* const user_data);
+/** \brief TCP state timeout timer callback */
+static void NANO_IP_TCP_StateTimeout(nano_ip_timer_t* const timer, void* const user_data);
+
+/** \brief TCP retransmission timer callback */
+static void NANO_IP_TCP_RtoTimeout(nano_ip_timer_t* const timer, void* const user_data);
+
+/** \brief TCP delayed acknowledge timer callback */
+static void NANO_IP_TCP_AckTimeout(nano_ip_timer_t* const timer, void* const user_data);
+
+/** \brief Handle the expiration of the retransmission timeout of a handle */
+static void NANO_IP_TCP_RtoExpired(nano_ip_tcp_handle_t* const handle);
+
+/** \brief Update the retransmission timeout with a new round-trip time measurement */
+static void NANO_IP_TCP_UpdateRto(nano_ip_tcp_handle_t* const handle, const uint32_t rtt);
 
 /** \brief Compute the TCP checksum of a buffer */
 static uint16_t NANO_IP_TCP_ComputeCS(const ipv4_header_t* const ipv4_header, uint8_t* const buffer, const uint16_t size);
@@ -96,7 +170,76 @@ static uint16_t NANO_IP_TCP_ComputeCS(const ipv4_header_t* const ipv4_header, ui
 static nano_ip_error_t NANO_IP_TCP_SendControlFrame(nano_ip_tcp_handle_t* const handle, const uint8_t flags);
 
 /** \brief Finalize and send a TCP packet */
-static nano_ip_error_t NANO_IP_TCP_FinalizeAndSendPacket(nano_ip_tcp_handle_t* const handle, const uint8_t flags, nano_ip_net_packet_t* const packet);
+static nano_ip_error_t NANO_IP_TCP_FinalizeAndSendPacket(nano_ip_tcp_handle_t* const handle, const uint8_t flags, const uint32_t seq_number, const uint8_t options_length, nano_ip_net_packet_t* const packet);
+
+/** \brief Decode the options of a received TCP frame */
+static void NANO_IP_TCP_ReadOptions(tcp_header_t* const tcp_header, const uint8_t* const options, const uint16_t options_length);
+
+/** \brief Offer all the supported options on a new connection */
+static void NANO_IP_TCP_OfferOptions(nano_ip_tcp_handle_t* const handle);
+
+/** \brief Negotiate the options of a connection from the peer's SYN frame */
+static void NANO_IP_TCP_NegotiateOptions(nano_ip_tcp_handle_t* const handle, const tcp_header_t* const tcp_header);
+
+/** \brief Check the timestamp of a received frame (PAWS) and update the timestamp to echo */
+static bool NANO_IP_TCP_CheckTimestamp(nano_ip_tcp_handle_t* const handle, const tcp_header_t* const tcp_header);
+
+/** \brief Remove the timestamps option space from a packet when timestamps are not in use */
+static void NANO_IP_TCP_RemoveTimestampSpace(nano_ip_net_packet_t* const packet);
+
+/** \brief Acknowledge in sequence data, the acknowledge is delayed if possible */
+static void NANO_IP_TCP_DelayAck(nano_ip_tcp_handle_t* const handle);
+
+/** \brief Build the SACK blocks describing the out-of-order segments */
+static uint8_t NANO_IP_TCP_GetSackBlocks(const nano_ip_tcp_handle_t* const handle, tcp_sack_block_t* const blocks, const uint8_t max_count);
+
+/** \brief Initialize the transmit state of a newly established connection */
+static void NANO_IP_TCP_InitTxState(nano_ip_tcp_handle_t* const handle);
+
+/** \brief Indicate if a segment of the given length fits into the transmit window */
+static bool NANO_IP_TCP_TxWindowIsOpen(const nano_ip_tcp_handle_t* const handle, const uint16_t length);
+
+/** \brief Process the acknowledge number of a received frame */
+static void NANO_IP_TCP_ProcessAck(nano_ip_tcp_handle_t* const handle, const tcp_header_t* const tcp_header, const uint16_t length);
+
+/** \brief Update the congestion window on a new acknowledge */
+static void NANO_IP_TCP_UpdateCwnd(nano_ip_tcp_handle_t* const handle, const uint32_t acked_bytes);
+
+/** \brief Mark the selectively acknowledged segments */
+static void NANO_IP_TCP_ProcessSackBlocks(nano_ip_tcp_handle_t* const handle, const tcp_header_t* const tcp_header);
+
+/** \brief Retransmit the segments considered lost */
+static void NANO_IP_TCP_RetransmitLostSegments(nano_ip_tcp_handle_t* const handle, const bool first_segment);
+
+/** \brief Retransmit a segment */
+static void NANO_IP_TCP_RetransmitSegment(nano_ip_tcp_handle_t* const handle, nano_ip_tcp_tx_segment_t* const segment);
+
+/** \brief Release the packet of a transmitted segment */
+static void NANO_IP_TCP_ReleaseTxSegment(nano_ip_tcp_tx_segment_t* const segment);
+
+/** \brief Release all the unacknowledged segments of a handle */
+static void NANO_IP_TCP_ReleaseTxSegments(nano_ip_tcp_handle_t* const handle);
+
+/** \brief Compute the receive window to advertise */
+static uint32_t NANO_IP_TCP_GetRxWindow(const nano_ip_tcp_handle_t* const handle);
+
+/** \brief Process the data of a received frame */
+static bool NANO_IP_TCP_ProcessRxData(nano_ip_tcp_handle_t* const handle, const tcp_header_t* const tcp_header, nano_ip_net_packet_t* const packet);
+
+/** \brief Deliver in sequence data to the application */
+static bool NANO_IP_TCP_DeliverRxData(nano_ip_tcp_handle_t* const handle, nano_ip_net_packet_t* const packet);
+
+/** \brief Get the sequence number of a received segment */
+static uint32_t NANO_IP_TCP_GetRxSegmentSeqNumber(const nano_ip_net_packet_t* const packet);
+
+/** \brief Store an out-of-order segment */
+static bool NANO_IP_TCP_QueueRxOooSegment(nano_ip_tcp_handle_t* const handle, const uint32_t seq_number, nano_ip_net_packet_t* const packet);
+
+/** \brief Deliver the out-of-order segments which are now in sequence */
+static void NANO_IP_TCP_DeliverRxOooSegments(nano_ip_tcp_handle_t* const handle);
+
+/** \brief Release all the out-of-order segments of a handle */
+static void NANO_IP_TCP_ReleaseRxOooSegments(nano_ip_tcp_handle_t* const handle);
 
 
 
@@ -115,13 +258,6 @@ nano_ip_error_t NANO_IP_TCP_Init(void)
     tcp_module->ipv4_protocol.rx_frame = NANO_IP_TCP_RxFrame;
     tcp_module->ipv4_protocol.user_data = tcp_module;
     ret = NANO_IP_IPV4_AddProtocol(&tcp_module->ipv4_protocol);
-    if (ret == NIP_ERR_SUCCESS)
-    {
-        /* Register periodic callback */
-        tcp_module->ipv4_callback.callback = NANO_IP_TCP_PeriodicTask;
-        tcp_module->ipv4_callback.user_data = tcp_module;
-        ret = NANO_IP_IPV4_RegisterPeriodicCallback(&tcp_module->ipv4_callback);
-    }
 
     return ret;
 }
@@ -142,9 +278,18 @@ nano_ip_error_t NANO_IP_TCP_InitializeHandle(nano_ip_tcp_handle_t* const handle,
         ret = NANO_IP_IPV4_InitializeHandle(&handle->ipv4_handle, handle, NANO_IP_TCP_Ipv4ErrorCallback);
         if (ret == NIP_ERR_SUCCESS)
         {
+            /* Initialize timers */
+            (void)NANO_IP_TIMER_InitializeTimer(&handle->state_timer, NANO_IP_TCP_StateTimeout, handle);
+            (void)NANO_IP_TIMER_InitializeTimer(&handle->rto_timer, NANO_IP_TCP_RtoTimeout, handle);
+            (void)NANO_IP_TIMER_InitializeTimer(&handle->ack_timer, NANO_IP_TCP_AckTimeout, handle);
+
             /* Initialize handle */
             handle->callback = callback;
             handle->user_data = user_data;
+            handle->rx_buffer_size = NANO_IP_TCP_RX_BUFFER_SIZE;
+            handle->rto = NANO_IP_TCP_INITIAL_RTO;
+            handle->mss = TCP_DEFAULT_MSS;
+            NANO_IP_PACKET_ResetQueue(&handle->rx_ooo_packets);
         }
     }
     
@@ -305,6 +450,9 @@ nano_ip_error_t NANO_IP_TCP_Connect(nano_ip_tcp_handle_t* const handle, const ip
             /* Initialize sequence number */
             handle->seq_number = NANO_IP_OAL_TIME_GetMsCounter();
 
+            /* Offer all the supported options */
+            NANO_IP_TCP_OfferOptions(handle);
+
             /* Send SYN frame */
             ret = NANO_IP_TCP_SendControlFrame(handle, TCP_FLAG_SYN);
             if ((ret == NIP_ERR_SUCCESS) || (ret == NIP_ERR_IN_PROGRESS))
@@ -316,7 +464,7 @@ nano_ip_error_t NANO_IP_TCP_Connect(nano_ip_tcp_handle_t* const handle, const ip
                 handle->seq_number++;
 
                 /* Initiate timeout */
-                handle->state_timeout = NANO_IP_OAL_TIME_GetMsCounter() + TCP_STATE_TIMEOUT;
+                (void)NANO_IP_TIMER_Start(&handle->state_timer, TCP_STATE_TIMEOUT);
             }
         }
         else
@@ -383,7 +531,7 @@ nano_ip_error_t NANO_IP_TCP_Close(nano_ip_tcp_handle_t* const handle)
                 handle->seq_number++;
 
                 /* Initiate timeout */
-                handle->state_timeout = NANO_IP_OAL_TIME_GetMsCounter() + TCP_STATE_TIMEOUT;
+                (void)NANO_IP_TIMER_Start(&handle->state_timer, TCP_STATE_TIMEOUT);
             }
         }
         if (handle->state != TCP_STATE_IDLE)
@@ -412,15 +560,16 @@ nano_ip_error_t NANO_IP_TCP_AllocatePacket(nano_ip_net_packet_t** packet, const
     /* Check parameters */
     if (packet != NULL)
     {
-        /* Compute total packet size needed */
-        const uint16_t total_packet_size = packet_size + TCP_HEADER_SIZE;
+        /* Compute total packet size needed, the timestamps option space is removed 
+           when sending the packet if the connection does not use it */
+        const uint16_t total_packet_size = packet_size + TCP_HEADER_SIZE + TCP_OPTION_TIMESTAMP_SPACE;
 
         /* Try to allocate an IPv4 packet */
         ret = NANO_IP_IPV4_AllocatePacket(total_packet_size, packet);
         if (ret == NIP_ERR_SUCCESS)
         {
             /* Skip header */
-            NANO_IP_PACKET_WriteSkipBytes((*packet), TCP_HEADER_SIZE);
+            NANO_IP_PACKET_WriteSkipBytes((*packet), TCP_HEADER_SIZE + TCP_OPTION_TIMESTAMP_SPACE);
 
             /* Reset count */
             (*packet)->count = 0;
@@ -441,32 +590,62 @@ nano_ip_error_t NANO_IP_TCP_SendPacket(nano_ip_tcp_handle_t* const handle, nano_
     if ((handle != NULL) && (packet != NULL))
     {
         /* Check handle state */
-        if (handle->last_tx_packet != NULL)
+        if (handle->state != TCP_STATE_ESTABLISHED)
+        {
+            ret = NIP_ERR_INVALID_TCP_STATE;
+        }
+        else if (!NANO_IP_TCP_TxWindowIsOpen(handle, packet->count) ||
+                 (NANO_IP_IPV4_HandleIsReady(&handle->ipv4_handle) != NIP_ERR_SUCCESS))
         {
             ret = NIP_ERR_BUSY;
         }
-        else if (handle->state == TCP_STATE_ESTABLISHED)
+        else
         {
-            /* Save packet informations */
-            handle->last_tx_packet = packet;
-            handle->last_tx_packet_pos = packet->current;
-            handle->last_tx_packet_count = packet->count;
-            handle->tx_retry_count = 0u;
+            /* Save segment informations */
+            uint8_t index = handle->tx_segment_first + handle->tx_segment_count;
+            nano_ip_tcp_tx_segment_t* segment;
+            if (index >= NANO_IP_TCP_MAX_TX_SEGMENT_COUNT)
+            {
+                index -= NANO_IP_TCP_MAX_TX_SEGMENT_COUNT;
+            }
+            segment = &handle->tx_segments[index];
+            if (!handle->ts_enabled)
+            {
+                NANO_IP_TCP_RemoveTimestampSpace(packet);
+            }
+            segment->packet = packet;
+            segment->packet_end = packet->current;
+            segment->seq_number = handle->seq_number;
+            segment->length = packet->count;
+            segment->retransmitted = false;
+            segment->sacked = false;
+            segment->tx_timestamp = NANO_IP_OAL_TIME_GetMsCounter();
 
-            /* Keep packet for retransmission */
-            handle->last_tx_packet->flags |= NET_IF_PACKET_FLAG_KEEP_PACKET;
+            /* Reference held by the retransmission queue */
+            NANO_IP_PACKET_Retain(packet);
 
             /* Send frame */
-            ret = NANO_IP_TCP_FinalizeAndSendPacket(handle, (TCP_FLAG_PSH | TCP_FLAG_ACK), packet);
+            ret = NANO_IP_TCP_FinalizeAndSendPacket(handle, (TCP_FLAG_PSH | TCP_FLAG_ACK), segment->seq_number, 0u, packet);
             if ((ret == NIP_ERR_SUCCESS) || (ret == NIP_ERR_IN_PROGRESS))
             {
+                /* Start the retransmission timeout on the first segment in flight */
+                if (handle->tx_segment_count == 0u)
+                {
+                    handle->tx_retry_count = 0u;
+                    (void)NANO_IP_TIMER_Start(&handle->rto_timer, handle->rto);
+                }
+
+                /* Add the segment to the retransmission queue */
+                handle->tx_segment_count++;
+
                 /* Update sequence number */
-                handle->seq_number += handle->last_tx_packet_count;
+                handle->seq_number += segment->length;
+            }
+            else
+            {
+                /* Packet is given back to the caller */
+                (void)NANO_IP_TCP_ReleasePacket(packet);
             }
-        }
-        else
-        {
-            ret = NIP_ERR_INVALID_TCP_STATE;
         }
     }
 
@@ -485,7 +664,7 @@ nano_ip_error_t NANO_IP_TCP_HandleIsReady(nano_ip_tcp_handle_t* const handle)
     /* Check parameters */
     if (handle != NULL)
     {
-        if (handle->last_tx_packet == NULL)
+        if (NANO_IP_TCP_TxWindowIsOpen(handle, 0u))
         {
             ret = NANO_IP_IPV4_HandleIsReady(&handle->ipv4_handle);
         }
@@ -500,6 +679,81 @@ nano_ip_error_t NANO_IP_TCP_HandleIsReady(nano_ip_tcp_handle_t* const handle)
     return ret;
 }
 
+/** \brief Indicate that received data has been consumed by the application to reopen the receive window */
+nano_ip_error_t NANO_IP_TCP_UpdateRxWindow(nano_ip_tcp_handle_t* const handle, const uint32_t consumed_size)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+
+    (void)NANO_IP_OAL_MUTEX_Lock(&g_nano_ip.mutex);
+
+    /* Check parameters */
+    if (handle != NULL)
+    {
+        /* Update buffered data */
+        if (consumed_size < handle->rx_buffered)
+        {
+            handle->rx_buffered -= consumed_size;
+        }
+        else
+        {
+            handle->rx_buffered = 0u;
+        }
+
+        /* Send a window update once half of the buffer has been freed */
+        ret = NIP_ERR_SUCCESS;
+        if (handle->state == TCP_STATE_ESTABLISHED)
+        {
+            const uint32_t rx_window = NANO_IP_TCP_GetRxWindow(handle);
+            if ((rx_window > handle->rx_window) &&
+                ((rx_window - handle->rx_window) >= (handle->rx_buffer_size / 2u)))
+            {
+                ret = NANO_IP_TCP_SendControlFrame(handle, TCP_FLAG_ACK);
+            }
+        }
+    }
+
+    (void)NANO_IP_OAL_MUTEX_Unlock(&g_nano_ip.mutex);
+
+    return ret;
+}
+
+/** \brief Get the statistics of a TCP connection */
+nano_ip_error_t NANO_IP_TCP_GetStats(nano_ip_tcp_handle_t* const handle, nano_ip_tcp_stats_t* const stats)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+
+    (void)NANO_IP_OAL_MUTEX_Lock(&g_nano_ip.mutex);
+
+    /* Check parameters */
+    if ((handle != NULL) && (stats != NULL))
+    {
+        /* Check handle state */
+        if (handle->state == TCP_STATE_ESTABLISHED)
+        {
+            stats->cwnd = handle->cwnd;
+            stats->ssthresh = handle->ssthresh;
+            stats->tx_window = handle->tx_window;
+            stats->mss = handle->mss;
+            stats->bytes_in_flight = handle->seq_number - handle->tx_unacked_seq_number;
+            stats->srtt = (handle->srtt >> 3u);
+            stats->rto = handle->rto;
+            stats->rto_count = handle->rto_count;
+            stats->fast_retransmit_count = handle->fast_retransmit_count;
+            stats->fast_recovery = handle->fast_recovery;
+
+            ret = NIP_ERR_SUCCESS;
+        }
+        else
+        {
+            ret = NIP_ERR_INVALID_TCP_STATE;
+        }
+    }
+
+    (void)NANO_IP_OAL_MUTEX_Unlock(&g_nano_ip.mutex);
+
+    return ret;
+}
+
 /** \brief Release a TCP frame */
 nano_ip_error_t NANO_IP_TCP_ReleasePacket(nano_ip_net_packet_t* const packet)
 {
@@ -550,6 +804,15 @@ static void NANO_IP_TCP_RemoveHandle(nano_ip_tcp_handle_t* const handle)
     nano_ip_tcp_handle_t* previous_hdl = NULL;
     nano_ip_tcp_module_data_t* const tcp_module = &g_nano_ip.tcp_module;
 
+    /* Drop the unacknowledged and the out-of-order segments */
+    NANO_IP_TCP_ReleaseTxSegments(handle);
+    NANO_IP_TCP_ReleaseRxOooSegments(handle);
+
+    /* Stop the timers */
+    (void)NANO_IP_TIMER_Stop(&handle->state_timer);
+    (void)NANO_IP_TIMER_Stop(&handle->rto_timer);
+    (void)NANO_IP_TIMER_Stop(&handle->ack_timer);
+
     hdl = tcp_module->handles;
     while ((hdl != NULL) && (hdl != handle))
     {
@@ -598,6 +861,14 @@ static nano_ip_error_t NANO_IP_TCP_RxFrame(void* user_data, nano_ip_net_if_t* co
             options_length = tcp_header.data_offset * sizeof(uint32_t) - TCP_HEADER_SIZE;
             NANO_IP_PACKET_ReadSkipBytes(packet, sizeof(uint16_t)); /* Checksum */
             NANO_IP_PACKET_ReadSkipBytes(packet, sizeof(uint16_t)); /* Urgent pointer */
+            if (options_length <= packet->count)
+            {
+                NANO_IP_TCP_ReadOptions(&tcp_header, packet->current, options_length);
+            }
+            else
+            {
+                NANO_IP_TCP_ReadOptions(&tcp_header, packet->current, 0u);
+            }
             NANO_IP_PACKET_ReadSkipBytes(packet, options_length); /* Options */
 
             /* Compute checkum */
@@ -669,9 +940,12 @@ static nano_ip_error_t NANO_IP_TCP_RxFrame(void* user_data, nano_ip_net_if_t* co
                             }
                         }
 
-                        /* Check acknowledge number */
+                        /* Check acknowledge number, an established connection accepts any acknowledge number
+                           up to the next byte to send (the data of a segment carrying an old acknowledge is still processed) */
                         if ((handle->state == TCP_STATE_LISTEN) || 
-                            (tcp_header.ack_number == handle->seq_number))
+                            (tcp_header.ack_number == handle->seq_number) ||
+                            ((handle->state == TCP_STATE_ESTABLISHED) &&
+                             TCP_SEQ_LEQ(tcp_header.ack_number, handle->seq_number)))
                         {
                             /* TCP state machine */
                             switch (handle->state)
@@ -702,10 +976,13 @@ static nano_ip_error_t NANO_IP_TCP_RxFrame(void* user_data, nano_ip_net_if_t* co
                                                 accept_handle->dest_port = tcp_header.src_port;
 
                                                 /* Initialize sequence number */
-                                                handle->seq_number = NANO_IP_OAL_TIME_GetMsCounter();
+                                                accept_handle->seq_number = NANO_IP_OAL_TIME_GetMsCounter();
 
-                                                /* Update ack number */
+                                                /* Update ack number, peer's window and options */
                                                 accept_handle->ack_number = tcp_header.seq_number + 1u;
+                                                accept_handle->tx_window = tcp_header.window;
+                                                NANO_IP_TCP_OfferOptions(accept_handle);
+                                                NANO_IP_TCP_NegotiateOptions(accept_handle, &tcp_header);
 
                                                 /* Send acknowledge */
                                                 ret = NANO_IP_TCP_SendControlFrame(accept_handle, TCP_FLAG_SYN | TCP_FLAG_ACK);
@@ -718,7 +995,7 @@ static nano_ip_error_t NANO_IP_TCP_RxFrame(void* user_data, nano_ip_net_if_t* co
                                                     accept_handle->state = TCP_STATE_SYN_RECEIVED;
 
                                                     /* Initiate timeout */
-                                                    accept_handle->state_timeout = NANO_IP_OAL_TIME_GetMsCounter() + TCP_STATE_TIMEOUT;
+                                                    (void)NANO_IP_TIMER_Start(&accept_handle->state_timer, TCP_STATE_TIMEOUT);
                                                 }
                                             }
                                             else
@@ -739,6 +1016,7 @@ static nano_ip_error_t NANO_IP_TCP_RxFrame(void* user_data, nano_ip_net_if_t* co
                                     if (tcp_header.flags == TCP_FLAG_ACK)
                                     {
                                         /* Connection established */
+                                        NANO_IP_TCP_InitTxState(handle);
                                         handle->state = TCP_STATE_ESTABLISHED;
 
                                         /* Call the registered callback */
@@ -754,14 +1032,17 @@ static nano_ip_error_t NANO_IP_TCP_RxFrame(void* user_data, nano_ip_net_if_t* co
                                     /* Check SYN flag acknowledge */
                                     if (tcp_header.flags == (TCP_FLAG_SYN | TCP_FLAG_ACK))
                                     {
-                                        /* Update ack number */
+                                        /* Update ack number, peer's window and options */
                                         handle->ack_number = tcp_header.seq_number + 1u;
+                                        handle->tx_window = tcp_header.window;
+                                        NANO_IP_TCP_NegotiateOptions(handle, &tcp_header);
 
                                         /* Send acknowledge */
                                         ret = NANO_IP_TCP_SendControlFrame(handle, TCP_FLAG_ACK);
                                         if (ret == NIP_ERR_SUCCESS)
                                         {
                                             /* Connection established */
+                                            NANO_IP_TCP_InitTxState(handle);
                                             handle->state = TCP_STATE_ESTABLISHED;
 
                                             /* Call the registered callback */
@@ -775,55 +1056,51 @@ static nano_ip_error_t NANO_IP_TCP_RxFrame(void* user_data, nano_ip_net_if_t* co
 
                                 case TCP_STATE_ESTABLISHED:
                                 {
-                                    /* Check PUSH flag */
-                                    if ((packet->count != 0u) && (tcp_header.flags == (TCP_FLAG_PSH | TCP_FLAG_ACK)))
+                                    /* Reject old duplicate frames (PAWS) */
+                                    if (!NANO_IP_TCP_CheckTimestamp(handle, &tcp_header))
                                     {
-                                        /* Check duplicate sequence */
-                                        if (tcp_header.seq_number == handle->ack_number)
+                                        /* Acknowledge the rejected frame */
+                                        if ((tcp_header.flags & TCP_FLAG_RST) == 0u)
                                         {
-                                            /* Update ack number */
-                                            handle->ack_number = tcp_header.seq_number + packet->count;
-
-                                            /* Send acknowledge */
-                                            ret = NANO_IP_TCP_SendControlFrame(handle, TCP_FLAG_ACK);
-                                            if (ret == NIP_ERR_SUCCESS)
-                                            {
-                                                /* Data received, call the registered callback */
-                                                (void)MEMSET(&event_data, 0, sizeof(event_data));
-                                                event_data.error = NIP_ERR_SUCCESS;
-                                                event_data.packet = packet;
-                                                release_packet = handle->callback(handle->user_data, TCP_EVENT_RX, &event_data);
-                                            }
+                                            (void)NANO_IP_TCP_SendControlFrame(handle, TCP_FLAG_ACK);
                                         }
                                     }
-                                    else if ((handle->last_tx_packet != NULL) && (tcp_header.flags == TCP_FLAG_ACK))
+                                    else
                                     {
-                                        /* Packet has been acknowledged */
-                                        (void)NANO_IP_TCP_ReleasePacket(handle->last_tx_packet);
-                                        handle->last_tx_packet = NULL;
+                                        /* Cumulative acknowledge of the transmitted segments (an acknowledge older than 
+                                           the oldest unacknowledged byte is a reordered duplicate and is ignored) */
+                                        if (((tcp_header.flags & TCP_FLAG_ACK) != 0u) &&
+                                            TCP_SEQ_LEQ(handle->tx_unacked_seq_number, tcp_header.ack_number))
+                                        {
+                                            NANO_IP_TCP_ProcessAck(handle, &tcp_header, length);
+                                        }
 
-                                        /* Call the registered callback */
-                                        (void)MEMSET(&event_data, 0, sizeof(event_data));
-                                        event_data.error = NIP_ERR_SUCCESS;
-                                        (void)handle->callback(handle->user_data, TCP_EVENT_TX, &event_data);
-                                    }
-                                    else if (tcp_header.flags == (TCP_FLAG_FIN | TCP_FLAG_ACK))
-                                    {
-                                        /* Update ack number */
-                                        handle->ack_number = tcp_header.seq_number + 1u;
+                                        /* Check received data */
+                                        if ((length != 0u) && ((tcp_header.flags & (TCP_FLAG_SYN | TCP_FLAG_RST)) == 0u))
+                                        {
+                                            release_packet = NANO_IP_TCP_ProcessRxData(handle, &tcp_header, packet);
+                                        }
 
-                                        /* Send acknowledge */
-                                        ret = NANO_IP_TCP_SendControlFrame(handle, TCP_FLAG_FIN | TCP_FLAG_ACK);
-                                        if (ret == NIP_ERR_SUCCESS)
+                                        /* Check FIN flag, it is processed only once all the preceding data has been received */
+                                        if (((tcp_header.flags & TCP_FLAG_FIN) != 0u) && 
+                                            ((tcp_header.seq_number + length) == handle->ack_number))
                                         {
-                                            /* Connection closing */
-                                            handle->state = TCP_STATE_CLOSE_WAIT;
+                                            /* Update ack number */
+                                            handle->ack_number++;
 
-                                            /* Update sequence number */
-                                            handle->seq_number++;
+                                            /* Send acknowledge */
+                                            ret = NANO_IP_TCP_SendControlFrame(handle, TCP_FLAG_FIN | TCP_FLAG_ACK);
+                                            if (ret == NIP_ERR_SUCCESS)
+                                            {
+                                                /* Connection closing */
+                                                handle->state = TCP_STATE_CLOSE_WAIT;
 
-                                            /* Initiate timeout */
-                                            handle->state_timeout = NANO_IP_OAL_TIME_GetMsCounter() + TCP_STATE_TIMEOUT;
+                                                /* Update sequence number */
+                                                handle->seq_number++;
+
+                                                /* Initiate timeout */
+                                                (void)NANO_IP_TIMER_Start(&handle->state_timer, TCP_STATE_TIMEOUT);
+                                            }
                                         }
                                     }
 
@@ -856,7 +1133,7 @@ static nano_ip_error_t NANO_IP_TCP_RxFrame(void* user_data, nano_ip_net_if_t* co
                                         handle->state = TCP_STATE_FIN_WAIT_2;
 
                                         /* Initiate timeout */
-                                        handle->state_timeout = NANO_IP_OAL_TIME_GetMsCounter() + TCP_STATE_TIMEOUT;
+                                        (void)NANO_IP_TIMER_Start(&handle->state_timer, TCP_STATE_TIMEOUT);
                                     }
                                     else if (tcp_header.flags == (TCP_FLAG_FIN | TCP_FLAG_ACK))
                                     {
@@ -871,7 +1148,7 @@ static nano_ip_error_t NANO_IP_TCP_RxFrame(void* user_data, nano_ip_net_if_t* co
                                             handle->state = TCP_STATE_TIME_WAIT;
 
                                             /* Initiate timeout */
-                                            handle->state_timeout = NANO_IP_OAL_TIME_GetMsCounter() + TCP_STATE_TIMEOUT;
+                                            (void)NANO_IP_TIMER_Start(&handle->state_timer, TCP_STATE_TIMEOUT);
                                         }
                                     }
                                     else
@@ -897,7 +1174,7 @@ static nano_ip_error_t NANO_IP_TCP_RxFrame(void* user_data, nano_ip_net_if_t* co
                                             handle->state = TCP_STATE_TIME_WAIT;
 
                                             /* Initiate timeout */
-                                            handle->state_timeout = NANO_IP_OAL_TIME_GetMsCounter() + TCP_STATE_TIMEOUT;
+                                            (void)NANO_IP_TIMER_Start(&handle->state_timer, TCP_STATE_TIMEOUT);
                                         }
                                     }
                                     break;
@@ -929,7 +1206,7 @@ static nano_ip_error_t NANO_IP_TCP_RxFrame(void* user_data, nano_ip_net_if_t* co
                         else
                         {
                             /* Ignore duplicates */
-                            if (tcp_header.ack_number > handle->seq_number)
+                            if (TCP_SEQ_LT(handle->seq_number, tcp_header.ack_number))
                             {
                                 /* Reset connection */
                                 handle->state = TCP_STATE_CLOSED;
@@ -946,7 +1223,8 @@ static nano_ip_error_t NANO_IP_TCP_RxFrame(void* user_data, nano_ip_net_if_t* co
                         /* Release received packet */
                         if (!release_packet)
                         {
-                            packet->flags |= NET_IF_PACKET_FLAG_KEEP_PACKET;
+                            /* Reference held by the receiver until it releases the packet */
+                            NANO_IP_PACKET_Retain(packet);
                         }
                         ret = NIP_ERR_SUCCESS;
                     }
@@ -970,133 +1248,212 @@ static nano_ip_error_t NANO_IP_TCP_RxFrame(void* user_data, nano_ip_net_if_t* co
     return ret;
 }
 
-/** \brief TCP periodic task */
-static void NANO_IP_TCP_PeriodicTask(const uint32_t timestamp, void* const user_data)
+/** \brief TCP state timeout timer callback */
+static void NANO_IP_TCP_StateTimeout(nano_ip_timer_t* const timer, void* const user_data)
 {
-    nano_ip_tcp_module_data_t* const tcp_module = NANO_IP_CAST(nano_ip_tcp_module_data_t*, user_data);
+    nano_ip_tcp_handle_t* const tcp_handle = NANO_IP_CAST(nano_ip_tcp_handle_t*, user_data);
+    (void)timer;
 
     /* Check parameters */
-    if (tcp_module != NULL)
+    if (tcp_handle != NULL)
     {
-        /* Go through the opened TCP handles */
         nano_ip_tcp_event_data_t event_data;
-        nano_ip_tcp_handle_t* tcp_handle = tcp_module->handles;
-        while (tcp_handle != NULL)
+
+        /* TCP state machine */
+        switch (tcp_handle->state)
         {
-            /* TCP state machine */
-            switch (tcp_handle->state)
+            case TCP_STATE_SYN_SENT:
+            {
+                /* Abort connection */
+                tcp_handle->state = TCP_STATE_CLOSED;
+                NANO_IP_TCP_RemoveHandle(tcp_handle);
+
+                /* Call the registered callback */
+                (void)MEMSET(&event_data, 0, sizeof(event_data));
+                event_data.error = NIP_ERR_TIMEOUT;
+                (void)tcp_handle->callback(tcp_handle->user_data, TCP_EVENT_CONNECT_TIMEOUT, &event_data);
+                break;
+            }
+
+            case TCP_STATE_SYN_RECEIVED:
+            {
+                /* Abort connection */
+                tcp_handle->state = TCP_STATE_CLOSED;
+                NANO_IP_TCP_RemoveHandle(tcp_handle);
+
+                /* Call the registered callback */
+                (void)MEMSET(&event_data, 0, sizeof(event_data));
+                event_data.error = NIP_ERR_TIMEOUT;
+                (void)tcp_handle->callback(tcp_handle->user_data, TCP_EVENT_ACCEPT_FAILED, &event_data);
+                break;
+            }
+
+            case TCP_STATE_CLOSE_WAIT:
+            /* Intended fallthrough */
+            case TCP_STATE_FIN_WAIT_1:
+            /* Intended fallthrough */
+            case TCP_STATE_FIN_WAIT_2:
+            /* Intended fallthrough */
+            case TCP_STATE_TIME_WAIT:
             {
-                case TCP_STATE_SYN_SENT:
+                /* Abort connection */
+                tcp_handle->state = TCP_STATE_CLOSED;
+                NANO_IP_TCP_RemoveHandle(tcp_handle);
+
+                /* Call the registered callback */
+                (void)MEMSET(&event_data, 0, sizeof(event_data));
+                if (tcp_handle->state == TCP_STATE_CLOSE_WAIT)
                 {
-                    /* Check timeout */
-                    if (tcp_handle->state_timeout <= timestamp)
-                    {
-                        /* Abort connection */
-                        tcp_handle->state = TCP_STATE_CLOSED;
-                        NANO_IP_TCP_RemoveHandle(tcp_handle);
-
-                        /* Call the registered callback */
-                        (void)MEMSET(&event_data, 0, sizeof(event_data));
-                        event_data.error = NIP_ERR_TIMEOUT;
-                        (void)tcp_handle->callback(tcp_handle->user_data, TCP_EVENT_CONNECT_TIMEOUT, &event_data);
-                    }
-                    break;
+                    event_data.error = NIP_ERR_SUCCESS;
                 }
-
-                case TCP_STATE_SYN_RECEIVED:
+                else
                 {
-                    /* Check timeout */
-                    if (tcp_handle->state_timeout <= timestamp)
-                    {
-                        /* Abort connection */
-                        tcp_handle->state = TCP_STATE_CLOSED;
-                        NANO_IP_TCP_RemoveHandle(tcp_handle);
-
-                        /* Call the registered callback */
-                        (void)MEMSET(&event_data, 0, sizeof(event_data));
-                        event_data.error = NIP_ERR_TIMEOUT;
-                        (void)tcp_handle->callback(tcp_handle->user_data, TCP_EVENT_ACCEPT_FAILED, &event_data);
-                    }
-                    break;
+                    event_data.error = NIP_ERR_TIMEOUT;
                 }
+                (void)tcp_handle->callback(tcp_handle->user_data, TCP_EVENT_CLOSED, &event_data);
+                break;
+            }
 
-                case TCP_STATE_ESTABLISHED:
-                {
-                    /* Check timeout */
-                    if ((tcp_handle->last_tx_packet != NULL) && (tcp_handle->state_timeout <= timestamp))
-                    {
-                        /* Update retry count */
-                        tcp_handle->tx_retry_count++;
-                        if (tcp_handle->tx_retry_count == TCP_MAX_RETRY_COUNT)
-                        {
-                            /* Release packet */
-                            (void)NANO_IP_TCP_ReleasePacket(tcp_handle->last_tx_packet);
-                            tcp_handle->last_tx_packet = NULL;
-
-                            /* Abort connection */
-                            tcp_handle->state = TCP_STATE_CLOSED;
-                            NANO_IP_TCP_RemoveHandle(tcp_handle);
-
-                            /* Call the registered callback */
-                            (void)MEMSET(&event_data, 0, sizeof(event_data));
-                            event_data.error = NIP_ERR_TIMEOUT;
-                            (void)tcp_handle->callback(tcp_handle->user_data, TCP_EVENT_TX_FAILED, &event_data);
-                            (void)tcp_handle->callback(tcp_handle->user_data, TCP_EVENT_CLOSED, &event_data);
-                        }
-                        else
-                        {
-                            /* Resend packet */
-                            tcp_handle->last_tx_packet->current = tcp_handle->last_tx_packet_pos;
-                            tcp_handle->last_tx_packet->count = tcp_handle->last_tx_packet_count;
-                            (void)NANO_IP_IPV4_SendPacket(&tcp_handle->ipv4_handle, &tcp_handle->last_tx_packet_ipv4_header, tcp_handle->last_tx_packet);
-                            tcp_handle->state_timeout += TCP_STATE_TIMEOUT;
-                        }
-                        
-                    }
+            default:
+            {
+                /* Do nothing... */
+                break;
+            }
+        }
+    }
+}
 
-                    break;
-                }
+/** \brief TCP retransmission timer callback */
+static void NANO_IP_TCP_RtoTimeout(nano_ip_timer_t* const timer, void* const user_data)
+{
+    nano_ip_tcp_handle_t* const tcp_handle = NANO_IP_CAST(nano_ip_tcp_handle_t*, user_data);
+    (void)timer;
 
-                case TCP_STATE_CLOSE_WAIT:
-                /* Intended fallthrough */
-                case TCP_STATE_FIN_WAIT_1:
-                /* Intended fallthrough */
-                case TCP_STATE_FIN_WAIT_2:
-                /* Intended fallthrough */
-                case TCP_STATE_TIME_WAIT:
-                {
-                    /* Check timeout */
-                    if (tcp_handle->state_timeout <= timestamp)
-                    {
-                        /* Abort connection */
-                        tcp_handle->state = TCP_STATE_CLOSED;
-                        NANO_IP_TCP_RemoveHandle(tcp_handle);
+    /* Check if segments are still waiting for an acknowledge */
+    if ((tcp_handle != NULL) &&
+        (tcp_handle->state == TCP_STATE_ESTABLISHED) &&
+        (tcp_handle->tx_segment_count != 0u))
+    {
+        NANO_IP_TCP_RtoExpired(tcp_handle);
+    }
+}
 
-                        /* Call the registered callback */
-                        (void)MEMSET(&event_data, 0, sizeof(event_data));
-                        if (tcp_handle->state == TCP_STATE_CLOSE_WAIT)
-                        {
-                            event_data.error = NIP_ERR_SUCCESS;
-                        }
-                        else
-                        {
-                            event_data.error = NIP_ERR_TIMEOUT;
-                        }
-                        (void)tcp_handle->callback(tcp_handle->user_data, TCP_EVENT_CLOSED, &event_data);
-                    }
-                    break;
-                }
+/** \brief TCP delayed acknowledge timer callback */
+static void NANO_IP_TCP_AckTimeout(nano_ip_timer_t* const timer, void* const user_data)
+{
+    nano_ip_tcp_handle_t* const tcp_handle = NANO_IP_CAST(nano_ip_tcp_handle_t*, user_data);
+    (void)timer;
 
-                default:
-                {
-                    /* Do nothing... */
-                    break;
-                }
-            }
+    /* Check if received segments are still waiting for an acknowledge */
+    if ((tcp_handle != NULL) &&
+        (tcp_handle->state == TCP_STATE_ESTABLISHED) &&
+        (tcp_handle->rx_unacked_segment_count != 0u))
+    {
+        (void)NANO_IP_TCP_SendControlFrame(tcp_handle, TCP_FLAG_ACK);
+    }
+}
+
+/** \brief Handle the expiration of the retransmission timeout of a handle */
+static void NANO_IP_TCP_RtoExpired(nano_ip_tcp_handle_t* const handle)
+{
+    /* Update retry count */
+    handle->tx_retry_count++;
+    if (handle->tx_retry_count == TCP_MAX_RETRY_COUNT)
+    {
+        nano_ip_tcp_event_data_t event_data;
+
+        /* Abort connection */
+        handle->state = TCP_STATE_CLOSED;
+        NANO_IP_TCP_RemoveHandle(handle);
+
+        /* Call the registered callback */
+        (void)MEMSET(&event_data, 0, sizeof(event_data));
+        event_data.error = NIP_ERR_TIMEOUT;
+        (void)handle->callback(handle->user_data, TCP_EVENT_TX_FAILED, &event_data);
+        (void)handle->callback(handle->user_data, TCP_EVENT_CLOSED, &event_data);
+    }
+    else
+    {
+        /* Congestion control : restart from one segment in slow start */
+        uint8_t i;
+        uint32_t ssthresh = (handle->seq_number - handle->tx_unacked_seq_number) / 2u;
+        if (ssthresh < (2u * handle->mss))
+        {
+            ssthresh = 2u * handle->mss;
+        }
+        handle->ssthresh = ssthresh;
+        handle->cwnd = handle->mss;
+        handle->recover = handle->seq_number;
+        handle->fast_recovery = false;
+        handle->dup_ack_count = 0u;
+        handle->rto_count++;
+
+        /* The selective acknowledges must not be trusted after a timeout (RFC 2018) */
+        for (i = 0u; i < NANO_IP_TCP_MAX_TX_SEGMENT_COUNT; i++)
+        {
+            handle->tx_segments[i].sacked = false;
+        }
+
+        /* Resend the oldest unacknowledged segment */
+        NANO_IP_TCP_RetransmitSegment(handle, &handle->tx_segments[handle->tx_segment_first]);
+
+        /* Exponential backoff */
+        handle->rto *= 2u;
+        if (handle->rto > NANO_IP_TCP_MAX_RTO)
+        {
+            handle->rto = NANO_IP_TCP_MAX_RTO;
+        }
+        (void)NANO_IP_TIMER_Start(&handle->rto_timer, handle->rto);
+    }
+}
 
-            /* Next handle */
-            tcp_handle = tcp_handle->next;
+/** \brief Update the retransmission timeout with a new round-trip time measurement */
+static void NANO_IP_TCP_UpdateRto(nano_ip_tcp_handle_t* const handle, const uint32_t rtt)
+{
+    uint32_t variation;
+
+    if (!handle->rtt_valid)
+    {
+        /* First measurement : SRTT = R, RTTVAR = R/2 */
+        handle->srtt = rtt << 3u;
+        handle->rttvar = rtt << 1u;
+        handle->rtt_valid = true;
+    }
+    else
+    {
+        /* RTTVAR = 3/4 * RTTVAR + 1/4 * |SRTT - R| */
+        const int32_t delta = NANO_IP_CAST(int32_t, rtt) - NANO_IP_CAST(int32_t, (handle->srtt >> 3u));
+        if (delta < 0)
+        {
+            handle->rttvar = handle->rttvar + NANO_IP_CAST(uint32_t, -delta) - (handle->rttvar >> 2u);
+        }
+        else
+        {
+            handle->rttvar = handle->rttvar + NANO_IP_CAST(uint32_t, delta) - (handle->rttvar >> 2u);
         }
+
+        /* SRTT = 7/8 * SRTT + 1/8 * R */
+        handle->srtt = NANO_IP_CAST(uint32_t, NANO_IP_CAST(int32_t, handle->srtt) + delta);
+    }
+
+    /* RTO = SRTT + max(G, 4 * RTTVAR) */
+    variation = handle->rttvar;
+    if (variation < NANO_IP_TIMER_TICK_PERIOD)
+    {
+        variation = NANO_IP_TIMER_TICK_PERIOD;
+    }
+    handle->rto = (handle->srtt >> 3u) + variation;
+    if (handle->rto < NANO_IP_TCP_MIN_RTO)
+    {
+        handle->rto = NANO_IP_TCP_MIN_RTO;
+    }
+    else if (handle->rto > NANO_IP_TCP_MAX_RTO)
+    {
+        handle->rto = NANO_IP_TCP_MAX_RTO;
+    }
+    else
+    {
+        /* RTO within bounds */
     }
 }
 
@@ -1128,13 +1485,92 @@ static nano_ip_error_t NANO_IP_TCP_SendControlFrame(nano_ip_tcp_handle_t* const
 {
     nano_ip_error_t ret;
     nano_ip_net_packet_t* packet;
+    tcp_sack_block_t sack_blocks[TCP_MAX_SACK_BLOCK_COUNT];
+    uint8_t sack_block_count = 0u;
+    uint8_t options_length = 0u;
 
-    /* Allocate a packet */
-    ret = NANO_IP_TCP_AllocatePacket(&packet, 0u);
-    if (ret == NIP_ERR_SUCCESS)
+    if ((flags & TCP_FLAG_SYN) != 0u)
     {
-        /* Send frame */
-        ret = NANO_IP_TCP_FinalizeAndSendPacket(handle, flags, packet);
+        /* SYN frames advertise the maximum segment size and the supported options */
+        options_length = TCP_OPTION_MSS_SIZE;
+        if (handle->ws_enabled)
+        {
+            options_length += sizeof(uint32_t);
+        }
+        if (handle->sack_enabled)
+        {
+            options_length += sizeof(uint32_t);
+        }
+    }
+    else if (handle->sack_enabled && ((flags & TCP_FLAG_ACK) != 0u))
+    {
+        /* Report the out-of-order segments, less blocks fit when the timestamps option is present */
+        uint8_t max_count = TCP_MAX_SACK_BLOCK_COUNT;
+        if (handle->ts_enabled)
+        {
+            max_count--;
+        }
+        sack_block_count = NANO_IP_TCP_GetSackBlocks(handle, sack_blocks, max_count);
+        if (sack_block_count != 0u)
+        {
+            options_length = sizeof(uint32_t) + (sack_block_count * TCP_OPTION_SACK_BLOCK_SIZE);
+        }
+    }
+    else
+    {
+        /* No options */
+    }
+
+    /* Allocate a packet */
+    ret = NANO_IP_TCP_AllocatePacket(&packet, options_length);
+    if (ret == NIP_ERR_SUCCESS)
+    {
+        if (!handle->ts_enabled)
+        {
+            NANO_IP_TCP_RemoveTimestampSpace(packet);
+        }
+
+        /* Write options */
+        if ((flags & TCP_FLAG_SYN) != 0u)
+        {
+            NANO_IP_PACKET_Write8bits(packet, TCP_OPTION_MSS);
+            NANO_IP_PACKET_Write8bits(packet, TCP_OPTION_MSS_SIZE);
+            NANO_IP_PACKET_Write16bits(packet, NANO_IP_TCP_MSS);
+            if (handle->ws_enabled)
+            {
+                NANO_IP_PACKET_Write8bits(packet, TCP_OPTION_NOP);
+                NANO_IP_PACKET_Write8bits(packet, TCP_OPTION_WINDOW_SCALE);
+                NANO_IP_PACKET_Write8bits(packet, TCP_OPTION_WINDOW_SCALE_SIZE);
+                NANO_IP_PACKET_Write8bits(packet, handle->rx_window_scale);
+            }
+            if (handle->sack_enabled)
+            {
+                NANO_IP_PACKET_Write8bits(packet, TCP_OPTION_NOP);
+                NANO_IP_PACKET_Write8bits(packet, TCP_OPTION_NOP);
+                NANO_IP_PACKET_Write8bits(packet, TCP_OPTION_SACK_PERMITTED);
+                NANO_IP_PACKET_Write8bits(packet, TCP_OPTION_SACK_PERMITTED_SIZE);
+            }
+        }
+        else if (sack_block_count != 0u)
+        {
+            uint8_t i;
+            NANO_IP_PACKET_Write8bits(packet, TCP_OPTION_NOP);
+            NANO_IP_PACKET_Write8bits(packet, TCP_OPTION_NOP);
+            NANO_IP_PACKET_Write8bits(packet, TCP_OPTION_SACK);
+            NANO_IP_PACKET_Write8bits(packet, NANO_IP_CAST(uint8_t, 2u + (sack_block_count * TCP_OPTION_SACK_BLOCK_SIZE)));
+            for (i = 0u; i < sack_block_count; i++)
+            {
+                NANO_IP_PACKET_Write32bits(packet, sack_blocks[i].left);
+                NANO_IP_PACKET_Write32bits(packet, sack_blocks[i].right);
+            }
+        }
+        else
+        {
+            /* No options */
+        }
+
+        /* Send frame */
+        ret = NANO_IP_TCP_FinalizeAndSendPacket(handle, flags, handle->seq_number, options_length, packet);
         if ((ret != NIP_ERR_SUCCESS) && (ret != NIP_ERR_IN_PROGRESS))
         {
             /* Release packet */
@@ -1146,7 +1582,7 @@ static nano_ip_error_t NANO_IP_TCP_SendControlFrame(nano_ip_tcp_handle_t* const
 }
 
 /** \brief Finalize and send a TCP packet */
-static nano_ip_error_t NANO_IP_TCP_FinalizeAndSendPacket(nano_ip_tcp_handle_t* const handle, const uint8_t flags, nano_ip_net_packet_t* const packet)
+static nano_ip_error_t NANO_IP_TCP_FinalizeAndSendPacket(nano_ip_tcp_handle_t* const handle, const uint8_t flags, const uint32_t seq_number, const uint8_t options_length, nano_ip_net_packet_t* const packet)
 {
     nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
 
@@ -1157,28 +1593,69 @@ static nano_ip_error_t NANO_IP_TCP_FinalizeAndSendPacket(nano_ip_tcp_handle_t* c
     uint8_t* const current_pos = packet->current;
     uint16_t tcp_length = packet->count + TCP_HEADER_SIZE;
     uint16_t packet_size = NANO_IP_CAST(uint16_t, packet->current - packet->data);
+    uint8_t header_size = TCP_HEADER_SIZE + options_length;
+    if (handle->ts_enabled)
+    {
+        tcp_length += TCP_OPTION_TIMESTAMP_SPACE;
+        header_size += TCP_OPTION_TIMESTAMP_SPACE;
+    }
 
     /* Write header */
     header_start = packet->current - tcp_length;
     packet->current = header_start;
     NANO_IP_PACKET_Write16bits(packet, handle->port);
     NANO_IP_PACKET_Write16bits(packet, handle->dest_port);
-    NANO_IP_PACKET_Write32bits(packet, handle->seq_number);
+    NANO_IP_PACKET_Write32bits(packet, seq_number);
     if ((flags & TCP_FLAG_ACK) != 0u)
     {
         NANO_IP_PACKET_Write32bits(packet, handle->ack_number);
+
+        /* Any frame carrying an acknowledge replaces the delayed acknowledge */
+        handle->last_ack_sent = handle->ack_number;
+        handle->rx_unacked_segment_count = 0u;
     }
     else
     {
         NANO_IP_PACKET_Write32bits(packet, 0u);
     }
-    NANO_IP_PACKET_Write8bits(packet, TCP_HEADER_DATA_OFFSET);
+    NANO_IP_PACKET_Write8bits(packet, NANO_IP_CAST(uint8_t, (header_size / sizeof(uint32_t)) << 4u));
     NANO_IP_PACKET_Write8bits(packet, flags);
-    NANO_IP_PACKET_Write16bits(packet, TCP_WINDOW_SIZE);
+    handle->rx_window = NANO_IP_TCP_GetRxWindow(handle);
+    if ((flags & TCP_FLAG_SYN) != 0u)
+    {
+        /* The window is never scaled in SYN frames */
+        if (handle->rx_window > 0xFFFFu)
+        {
+            handle->rx_window = 0xFFFFu;
+        }
+        NANO_IP_PACKET_Write16bits(packet, NANO_IP_CAST(uint16_t, handle->rx_window));
+    }
+    else
+    {
+        NANO_IP_PACKET_Write16bits(packet, NANO_IP_CAST(uint16_t, handle->rx_window >> handle->rx_window_scale));
+    }
 
     checksum_pos = packet->current;
     NANO_IP_PACKET_Write32bits(packet, 0u);
 
+    /* Write timestamps option */
+    if (handle->ts_enabled)
+    {
+        NANO_IP_PACKET_Write8bits(packet, TCP_OPTION_NOP);
+        NANO_IP_PACKET_Write8bits(packet, TCP_OPTION_NOP);
+        NANO_IP_PACKET_Write8bits(packet, TCP_OPTION_TIMESTAMP);
+        NANO_IP_PACKET_Write8bits(packet, TCP_OPTION_TIMESTAMP_SIZE);
+        NANO_IP_PACKET_Write32bits(packet, NANO_IP_OAL_TIME_GetMsCounter());
+        if ((flags & TCP_FLAG_ACK) != 0u)
+        {
+            NANO_IP_PACKET_Write32bits(packet, handle->ts_recent);
+        }
+        else
+        {
+            NANO_IP_PACKET_Write32bits(packet, 0u);
+        }
+    }
+
     /* Prepare IPv4 header */
     ipv4_header.dest_address = handle->dest_ipv4_address;
     if (handle->ipv4_address == 0u)
@@ -1206,12 +1683,6 @@ static nano_ip_error_t NANO_IP_TCP_FinalizeAndSendPacket(nano_ip_tcp_handle_t* c
     }
     ipv4_header.protocol = TCP_PROTOCOL;
 
-    /* Save IPv4 header */
-    if (handle->last_tx_packet != NULL)
-    {
-        (void)MEMCPY(&handle->last_tx_packet_ipv4_header, &ipv4_header, sizeof(ipv4_header_t));
-    }
-
     /* Write checksum */
     checksum = NANO_IP_TCP_ComputeCS(&ipv4_header, header_start, tcp_length);
     checksum_pos[0] = NANO_IP_CAST(uint8_t, (checksum & 0xFFu));
@@ -1227,4 +1698,799 @@ static nano_ip_error_t NANO_IP_TCP_FinalizeAndSendPacket(nano_ip_tcp_handle_t* c
     return ret;
 }
 
+/** \brief Decode the options of a received TCP frame */
+static void NANO_IP_TCP_ReadOptions(tcp_header_t* const tcp_header, const uint8_t* const options, const uint16_t options_length)
+{
+    uint16_t index = 0u;
+    bool end = false;
+
+    tcp_header->mss = 0u;
+    tcp_header->ws_present = false;
+    tcp_header->window_scale = 0u;
+    tcp_header->sack_permitted = false;
+    tcp_header->ts_present = false;
+    tcp_header->ts_value = 0u;
+    tcp_header->ts_echo = 0u;
+    tcp_header->sack_count = 0u;
+    while (!end && (index < options_length))
+    {
+        const uint8_t kind = options[index];
+        if (kind == TCP_OPTION_END)
+        {
+            end = true;
+        }
+        else if (kind == TCP_OPTION_NOP)
+        {
+            index++;
+        }
+        else if ((index + 1u) < options_length)
+        {
+            const uint8_t length = options[index + 1u];
+            const uint8_t* const value = &options[index + 2u];
+            if ((length < 2u) || ((index + length) > options_length))
+            {
+                /* Malformed option */
+                end = true;
+            }
+            else
+            {
+                if ((kind == TCP_OPTION_MSS) && (length == TCP_OPTION_MSS_SIZE))
+                {
+                    tcp_header->mss = NANO_IP_CAST(uint16_t, NET_READ_16(value));
+                }
+                else if ((kind == TCP_OPTION_WINDOW_SCALE) && (length == TCP_OPTION_WINDOW_SCALE_SIZE))
+                {
+                    tcp_header->ws_present = true;
+                    tcp_header->window_scale = value[0u];
+                }
+                else if ((kind == TCP_OPTION_SACK_PERMITTED) && (length == TCP_OPTION_SACK_PERMITTED_SIZE))
+                {
+                    tcp_header->sack_permitted = true;
+                }
+                else if ((kind == TCP_OPTION_TIMESTAMP) && (length == TCP_OPTION_TIMESTAMP_SIZE))
+                {
+                    tcp_header->ts_present = true;
+                    tcp_header->ts_value = NANO_IP_CAST(uint32_t, NET_READ_32(&value[0u]));
+                    tcp_header->ts_echo = NANO_IP_CAST(uint32_t, NET_READ_32(&value[4u]));
+                }
+                else if ((kind == TCP_OPTION_SACK) && (((length - 2u) % TCP_OPTION_SACK_BLOCK_SIZE) == 0u))
+                {
+                    uint8_t i;
+                    const uint8_t count = (length - 2u) / TCP_OPTION_SACK_BLOCK_SIZE;
+                    for (i = 0u; (i < count) && (i < TCP_MAX_SACK_BLOCK_COUNT); i++)
+                    {
+                        tcp_header->sack_blocks[i].left = NANO_IP_CAST(uint32_t, NET_READ_32(&value[i * TCP_OPTION_SACK_BLOCK_SIZE]));
+                        tcp_header->sack_blocks[i].right = NANO_IP_CAST(uint32_t, NET_READ_32(&value[i * TCP_OPTION_SACK_BLOCK_SIZE + 4u]));
+                    }
+                    tcp_header->sack_count = i;
+                }
+                else
+                {
+                    /* Unsupported option */
+                }
+                index += length;
+            }
+        }
+        else
+        {
+            /* Truncated option */
+            end = true;
+        }
+    }
+}
+
+/** \brief Offer all the supported options on a new connection */
+static void NANO_IP_TCP_OfferOptions(nano_ip_tcp_handle_t* const handle)
+{
+    /* Smallest shift count allowing to advertise the whole receive buffer */
+    uint8_t rx_window_scale = 0u;
+    while ((rx_window_scale < TCP_MAX_WINDOW_SCALE) && ((handle->rx_buffer_size >> rx_window_scale) > 0xFFFFu))
+    {
+        rx_window_scale++;
+    }
+
+    handle->ws_enabled = true;
+    handle->tx_window_scale = 0u;
+    handle->rx_window_scale = rx_window_scale;
+    handle->sack_enabled = true;
+    handle->ts_enabled = true;
+    handle->ts_recent = 0u;
+}
+
+/** \brief Negotiate the options of a connection from the peer's SYN frame */
+static void NANO_IP_TCP_NegotiateOptions(nano_ip_tcp_handle_t* const handle, const tcp_header_t* const tcp_header)
+{
+    /* Use the smallest of the local and peer's MSS, or the default MSS if the peer did not send the option */
+    uint16_t mss = TCP_DEFAULT_MSS;
+    if (tcp_header->mss != 0u)
+    {
+        mss = tcp_header->mss;
+    }
+    if (mss > NANO_IP_TCP_MSS)
+    {
+        mss = NANO_IP_TCP_MSS;
+    }
+    if (mss < TCP_MIN_MSS)
+    {
+        mss = TCP_MIN_MSS;
+    }
+
+    /* Options are in use only if both ends support them */
+    handle->ws_enabled = (handle->ws_enabled && tcp_header->ws_present);
+    if (handle->ws_enabled)
+    {
+        handle->tx_window_scale = tcp_header->window_scale;
+        if (handle->tx_window_scale > TCP_MAX_WINDOW_SCALE)
+        {
+            handle->tx_window_scale = TCP_MAX_WINDOW_SCALE;
+        }
+    }
+    else
+    {
+        handle->tx_window_scale = 0u;
+        handle->rx_window_scale = 0u;
+    }
+    handle->sack_enabled = (handle->sack_enabled && tcp_header->sack_permitted);
+    handle->ts_enabled = (handle->ts_enabled && tcp_header->ts_present);
+    if (handle->ts_enabled)
+    {
+        /* The timestamps option is carried by every segment */
+        handle->ts_recent = tcp_header->ts_value;
+        mss -= TCP_OPTION_TIMESTAMP_SPACE;
+    }
+    handle->mss = mss;
+}
+
+/** \brief Check the timestamp of a received frame (PAWS) and update the timestamp to echo */
+static bool NANO_IP_TCP_CheckTimestamp(nano_ip_tcp_handle_t* const handle, const tcp_header_t* const tcp_header)
+{
+    bool accept = true;
+
+    if (handle->ts_enabled && tcp_header->ts_present)
+    {
+        if (TCP_SEQ_LT(tcp_header->ts_value, handle->ts_recent))
+        {
+            /* Old duplicate frame, resets are still accepted */
+            accept = ((tcp_header->flags & TCP_FLAG_RST) != 0u);
+        }
+        else if (TCP_SEQ_LEQ(tcp_header->seq_number, handle->last_ack_sent))
+        {
+            /* Echo the timestamp of the oldest frame not yet acknowledged */
+            handle->ts_recent = tcp_header->ts_value;
+        }
+        else
+        {
+            /* Frame beyond the last acknowledge sent */
+        }
+    }
+
+    return accept;
+}
+
+/** \brief Remove the timestamps option space from a packet when timestamps are not in use */
+static void NANO_IP_TCP_RemoveTimestampSpace(nano_ip_net_packet_t* const packet)
+{
+    /* Move the data just behind the TCP header */
+    uint16_t i;
+    const uint8_t* const data = packet->current - packet->count;
+    uint8_t* const moved_data = packet->current - packet->count - TCP_OPTION_TIMESTAMP_SPACE;
+    for (i = 0u; i < packet->count; i++)
+    {
+        moved_data[i] = data[i];
+    }
+    packet->current -= TCP_OPTION_TIMESTAMP_SPACE;
+}
+
+/** \brief Initialize the transmit state of a newly established connection */
+static void NANO_IP_TCP_InitTxState(nano_ip_tcp_handle_t* const handle)
+{
+    /* Initial window : min(4 * MSS, max(2 * MSS, 4380)) (RFC 3390) */
+    uint32_t initial_window = 4380u;
+    if (initial_window < (2u * handle->mss))
+    {
+        initial_window = 2u * handle->mss;
+    }
+    if (initial_window > (4u * handle->mss))
+    {
+        initial_window = 4u * handle->mss;
+    }
+
+    handle->tx_unacked_seq_number = handle->seq_number;
+    handle->cwnd = initial_window;
+    handle->ssthresh = TCP_MAX_CWND;
+    handle->recover = handle->seq_number - 1u;
+    handle->dup_ack_count = 0u;
+    handle->fast_recovery = false;
+}
+
+/** \brief Indicate if a segment of the given length fits into the transmit window */
+static bool NANO_IP_TCP_TxWindowIsOpen(const nano_ip_tcp_handle_t* const handle, const uint16_t length)
+{
+    bool ret = false;
+
+    if (handle->tx_segment_count == 0u)
+    {
+        /* Always allow one segment in flight so that a closed window gets probed */
+        ret = true;
+    }
+    else if (handle->tx_segment_count < NANO_IP_TCP_MAX_TX_SEGMENT_COUNT)
+    {
+        /* Send window is the minimum of the congestion window and the peer's window */
+        const uint32_t bytes_in_flight = handle->seq_number - handle->tx_unacked_seq_number;
+        uint32_t window = handle->cwnd;
+        if (window > handle->tx_window)
+        {
+            window = handle->tx_window;
+        }
+        ret = ((bytes_in_flight + length) <= window);
+    }
+    else
+    {
+        /* Retransmission queue is full */
+    }
+
+    return ret;
+}
+
+/** \brief Process the acknowledge number of a received frame */
+static void NANO_IP_TCP_ProcessAck(nano_ip_tcp_handle_t* const handle, const tcp_header_t* const tcp_header, const uint16_t length)
+{
+    bool tx_possible = false;
+    const uint32_t timestamp = NANO_IP_OAL_TIME_GetMsCounter();
+    const uint32_t window = NANO_IP_CAST(uint32_t, tcp_header->window) << handle->tx_window_scale;
+
+    /* Selective acknowledges */
+    if (handle->sack_enabled && (tcp_header->sack_count != 0u))
+    {
+        NANO_IP_TCP_ProcessSackBlocks(handle, tcp_header);
+    }
+
+    if (TCP_SEQ_LT(handle->tx_unacked_seq_number, tcp_header->ack_number))
+    {
+        /* New data acknowledged */
+        bool rtt_valid = false;
+        uint32_t rtt = 0u;
+        const uint32_t acked_bytes = tcp_header->ack_number - handle->tx_unacked_seq_number;
+        handle->tx_unacked_seq_number = tcp_header->ack_number;
+
+        /* Release the fully acknowledged segments */
+        while ((handle->tx_segment_count != 0u) &&
+               TCP_SEQ_LEQ(handle->tx_segments[handle->tx_segment_first].seq_number + handle->tx_segments[handle->tx_segment_first].length, tcp_header->ack_number))
+        {
+            /* Measure the round-trip time on the most recent segment if it has not been retransmitted */
+            rtt_valid = !handle->tx_segments[handle->tx_segment_first].retransmitted;
+            rtt = timestamp - handle->tx_segments[handle->tx_segment_first].tx_timestamp;
+
+            NANO_IP_TCP_ReleaseTxSegment(&handle->tx_segments[handle->tx_segment_first]);
+            handle->tx_segment_first++;
+            if (handle->tx_segment_first == NANO_IP_TCP_MAX_TX_SEGMENT_COUNT)
+            {
+                handle->tx_segment_first = 0u;
+            }
+            handle->tx_segment_count--;
+        }
+
+        /* The echoed timestamp gives a measurement even for retransmitted segments,
+           the echoed value of an acknowledge is valid whatever its value, including 0 */
+        if (handle->ts_enabled && tcp_header->ts_present)
+        {
+            rtt_valid = true;
+            rtt = timestamp - tcp_header->ts_echo;
+        }
+
+        /* Update round-trip time estimation */
+        if (rtt_valid)
+        {
+            NANO_IP_TCP_UpdateRto(handle, rtt);
+        }
+
+        /* Restart the retransmission timeout for the remaining segments */
+        handle->tx_retry_count = 0u;
+        (void)NANO_IP_TIMER_Start(&handle->rto_timer, handle->rto);
+
+        /* Congestion control */
+        NANO_IP_TCP_UpdateCwnd(handle, acked_bytes);
+        tx_possible = true;
+    }
+    else if ((tcp_header->ack_number == handle->tx_unacked_seq_number) && 
+             (length == 0u) && 
+             (window == handle->tx_window) &&
+             (handle->tx_segment_count != 0u))
+    {
+        /* Duplicate acknowledge */
+        handle->dup_ack_count++;
+        if (handle->fast_recovery)
+        {
+            /* Inflate the congestion window for each segment which has left the network */
+            handle->cwnd += handle->mss;
+            tx_possible = true;
+
+            /* Retransmit the holes reported by the selective acknowledges */
+            NANO_IP_TCP_RetransmitLostSegments(handle, false);
+        }
+        else if ((handle->dup_ack_count == TCP_DUP_ACK_THRESHOLD) &&
+                 TCP_SEQ_LT(handle->recover, tcp_header->ack_number))
+        {
+            /* Fast retransmit */
+            uint32_t ssthresh = (handle->seq_number - handle->tx_unacked_seq_number) / 2u;
+            if (ssthresh < (2u * handle->mss))
+            {
+                ssthresh = 2u * handle->mss;
+            }
+            handle->ssthresh = ssthresh;
+            handle->recover = handle->seq_number;
+            NANO_IP_TCP_RetransmitLostSegments(handle, true);
+            handle->fast_retransmit_count++;
+
+            /* Enter fast recovery */
+            handle->cwnd = ssthresh + (TCP_DUP_ACK_THRESHOLD * handle->mss);
+            handle->fast_recovery = true;
+        }
+        else
+        {
+            /* Wait for more duplicates */
+        }
+    }
+    else
+    {
+        /* Old or window update acknowledge */
+    }
+
+    /* Update peer's window */
+    if (window > handle->tx_window)
+    {
+        tx_possible = true;
+    }
+    handle->tx_window = window;
+
+    if (tx_possible)
+    {
+        nano_ip_tcp_event_data_t event_data;
+
+        /* Call the registered callback */
+        (void)MEMSET(&event_data, 0, sizeof(event_data));
+        event_data.error = NIP_ERR_SUCCESS;
+        (void)handle->callback(handle->user_data, TCP_EVENT_TX, &event_data);
+    }
+}
+
+/** \brief Update the congestion window on a new acknowledge */
+static void NANO_IP_TCP_UpdateCwnd(nano_ip_tcp_handle_t* const handle, const uint32_t acked_bytes)
+{
+    if (handle->fast_recovery)
+    {
+        if (TCP_SEQ_LEQ(handle->recover, handle->tx_unacked_seq_number))
+        {
+            /* Full acknowledge : deflate the window and exit fast recovery */
+            uint32_t cwnd = handle->seq_number - handle->tx_unacked_seq_number;
+            if (cwnd < handle->mss)
+            {
+                cwnd = handle->mss;
+            }
+            cwnd += handle->mss;
+            if (cwnd > handle->ssthresh)
+            {
+                cwnd = handle->ssthresh;
+            }
+            handle->cwnd = cwnd;
+            handle->fast_recovery = false;
+        }
+        else
+        {
+            /* Partial acknowledge : retransmit the next holes and partially deflate the window */
+            NANO_IP_TCP_RetransmitLostSegments(handle, true);
+            if (acked_bytes < handle->cwnd)
+            {
+                handle->cwnd -= acked_bytes;
+            }
+            else
+            {
+                handle->cwnd = 0u;
+            }
+            if (acked_bytes >= handle->mss)
+            {
+                handle->cwnd += handle->mss;
+            }
+        }
+    }
+    else if (handle->cwnd < handle->ssthresh)
+    {
+        /* Slow start */
+        if (acked_bytes < handle->mss)
+        {
+            handle->cwnd += acked_bytes;
+        }
+        else
+        {
+            handle->cwnd += handle->mss;
+        }
+    }
+    else
+    {
+        /* Congestion avoidance : one segment per round-trip time */
+        uint32_t increment = (NANO_IP_CAST(uint32_t, handle->mss) * handle->mss) / handle->cwnd;
+        if (increment == 0u)
+        {
+            increment = 1u;
+        }
+        handle->cwnd += increment;
+    }
+    if (handle->cwnd > TCP_MAX_CWND)
+    {
+        handle->cwnd = TCP_MAX_CWND;
+    }
+    handle->dup_ack_count = 0u;
+}
+
+/** \brief Mark the selectively acknowledged segments */
+static void NANO_IP_TCP_ProcessSackBlocks(nano_ip_tcp_handle_t* const handle, const tcp_header_t* const tcp_header)
+{
+    uint8_t i;
+    for (i = 0u; i < tcp_header->sack_count; i++)
+    {
+        uint8_t j;
+        uint8_t index = handle->tx_segment_first;
+        const tcp_sack_block_t* const block = &tcp_header->sack_blocks[i];
+        for (j = 0u; j < handle->tx_segment_count; j++)
+        {
+            nano_ip_tcp_tx_segment_t* const segment = &handle->tx_segments[index];
+            if (TCP_SEQ_LEQ(block->left, segment->seq_number) &&
+                TCP_SEQ_LEQ(segment->seq_number + segment->length, block->right))
+            {
+                segment->sacked = true;
+            }
+            index++;
+            if (index == NANO_IP_TCP_MAX_TX_SEGMENT_COUNT)
+            {
+                index = 0u;
+            }
+        }
+    }
+}
+
+/** \brief Retransmit the segments considered lost */
+static void NANO_IP_TCP_RetransmitLostSegments(nano_ip_tcp_handle_t* const handle, const bool first_segment)
+{
+    uint8_t i;
+    uint8_t index = handle->tx_segment_first;
+    uint32_t highest_sacked = handle->tx_unacked_seq_number;
+
+    /* Look for the highest selectively acknowledged sequence number */
+    for (i = 0u; i < handle->tx_segment_count; i++)
+    {
+        if (handle->tx_segments[index].sacked)
+        {
+            highest_sacked = handle->tx_segments[index].seq_number + handle->tx_segments[index].length;
+        }
+        index++;
+        if (index == NANO_IP_TCP_MAX_TX_SEGMENT_COUNT)
+        {
+            index = 0u;
+        }
+    }
+
+    /* Retransmit the oldest segment if requested and all the holes below the 
+       highest selectively acknowledged segment which have not already been retransmitted */
+    index = handle->tx_segment_first;
+    for (i = 0u; i < handle->tx_segment_count; i++)
+    {
+        nano_ip_tcp_tx_segment_t* const segment = &handle->tx_segments[index];
+        if (((i == 0u) && first_segment) ||
+            (!segment->sacked && !segment->retransmitted && TCP_SEQ_LT(segment->seq_number, highest_sacked)))
+        {
+            NANO_IP_TCP_RetransmitSegment(handle, segment);
+        }
+        index++;
+        if (index == NANO_IP_TCP_MAX_TX_SEGMENT_COUNT)
+        {
+            index = 0u;
+        }
+    }
+}
+
+/** \brief Retransmit a segment */
+static void NANO_IP_TCP_RetransmitSegment(nano_ip_tcp_handle_t* const handle, nano_ip_tcp_tx_segment_t* const segment)
+{
+    /* Resend the segment if the driver has released it */
+    if ((segment->packet->flags & NET_IF_PACKET_FLAG_TX_PENDING) == 0u)
+    {
+        nano_ip_error_t ret;
+        segment->packet->current = segment->packet_end;
+        segment->packet->count = segment->length;
+
+        /* Reference given for the transmission */
+        NANO_IP_PACKET_Retain(segment->packet);
+        ret = NANO_IP_TCP_FinalizeAndSendPacket(handle, (TCP_FLAG_PSH | TCP_FLAG_ACK), segment->seq_number, 0u, segment->packet);
+        if ((ret != NIP_ERR_SUCCESS) && (ret != NIP_ERR_IN_PROGRESS))
+        {
+            (void)NANO_IP_TCP_ReleasePacket(segment->packet);
+        }
+    }
+
+    /* Karn's algorithm: no round-trip time measurement on a retransmitted segment */
+    segment->retransmitted = true;
+}
+
+/** \brief Release the packet of a transmitted segment */
+static void NANO_IP_TCP_ReleaseTxSegment(nano_ip_tcp_tx_segment_t* const segment)
+{
+    /* Drop the retransmission queue reference, if the driver still owns the packet
+       it will be released by the network interface once sent */
+    (void)NANO_IP_TCP_ReleasePacket(segment->packet);
+    segment->packet = NULL;
+}
+
+/** \brief Release all the unacknowledged segments of a handle */
+static void NANO_IP_TCP_ReleaseTxSegments(nano_ip_tcp_handle_t* const handle)
+{
+    while (handle->tx_segment_count != 0u)
+    {
+        NANO_IP_TCP_ReleaseTxSegment(&handle->tx_segments[handle->tx_segment_first]);
+        handle->tx_segment_first++;
+        if (handle->tx_segment_first == NANO_IP_TCP_MAX_TX_SEGMENT_COUNT)
+        {
+            handle->tx_segment_first = 0u;
+        }
+        handle->tx_segment_count--;
+    }
+}
+
+/** \brief Compute the receive window to advertise */
+static uint32_t NANO_IP_TCP_GetRxWindow(const nano_ip_tcp_handle_t* const handle)
+{
+    uint32_t window = 0u;
+
+    /* Free space in the receive buffer */
+    if (handle->rx_buffered < handle->rx_buffer_size)
+    {
+        window = handle->rx_buffer_size - handle->rx_buffered;
+    }
+    if (window > (NANO_IP_CAST(uint32_t, 0xFFFFu) << handle->rx_window_scale))
+    {
+        window = (NANO_IP_CAST(uint32_t, 0xFFFFu) << handle->rx_window_scale);
+    }
+
+    /* Round down to the window scale granularity */
+    window = ((window >> handle->rx_window_scale) << handle->rx_window_scale);
+
+    return window;
+}
+
+/** \brief Process the data of a received frame */
+static bool NANO_IP_TCP_ProcessRxData(nano_ip_tcp_handle_t* const handle, const tcp_header_t* const tcp_header, nano_ip_net_packet_t* const packet)
+{
+    bool release_packet = true;
+    bool ack_now = true;
+    uint32_t seq_number = tcp_header->seq_number;
+    const uint32_t window_end = handle->ack_number + NANO_IP_TCP_GetRxWindow(handle);
+
+    /* Drop the bytes which have already been received */
+    if (TCP_SEQ_LT(seq_number, handle->ack_number))
+    {
+        const uint32_t overlap = handle->ack_number - seq_number;
+        if (overlap < packet->count)
+        {
+            NANO_IP_PACKET_ReadSkipBytes(packet, NANO_IP_CAST(uint16_t, overlap));
+            seq_number = handle->ack_number;
+        }
+        else
+        {
+            packet->count = 0u;
+        }
+    }
+
+    /* Drop the bytes which are outside of the receive window */
+    if (!TCP_SEQ_LT(seq_number, window_end))
+    {
+        packet->count = 0u;
+    }
+    else if (TCP_SEQ_LT(window_end, seq_number + packet->count))
+    {
+        packet->count = NANO_IP_CAST(uint16_t, (window_end - seq_number));
+    }
+    else
+    {
+        /* Whole segment fits into the window */
+    }
+
+    if (packet->count != 0u)
+    {
+        if (seq_number == handle->ack_number)
+        {
+            /* In sequence data, the acknowledge can be delayed unless it fills a gap */
+            ack_now = (handle->rx_ooo_count != 0u);
+            release_packet = NANO_IP_TCP_DeliverRxData(handle, packet);
+
+            /* Fill the gap with the stored out-of-order segments */
+            NANO_IP_TCP_DeliverRxOooSegments(handle);
+        }
+        else
+        {
+            /* Keep the segment until the missing data is received */
+            release_packet = !NANO_IP_TCP_QueueRxOooSegment(handle, seq_number, packet);
+        }
+    }
+
+    /* Acknowledge received data, out-of-order and duplicate segments are acknowledged 
+       immediately to trigger the peer's fast retransmit */
+    if (ack_now)
+    {
+        (void)NANO_IP_TCP_SendControlFrame(handle, TCP_FLAG_ACK);
+    }
+    else
+    {
+        NANO_IP_TCP_DelayAck(handle);
+    }
+
+    return release_packet;
+}
+
+/** \brief Acknowledge in sequence data, the acknowledge is delayed if possible */
+static void NANO_IP_TCP_DelayAck(nano_ip_tcp_handle_t* const handle)
+{
+    /* Check if the data has already been acknowledged by a frame sent from the receive callback */
+    if (handle->last_ack_sent != handle->ack_number)
+    {
+        handle->rx_unacked_segment_count++;
+        if ((NANO_IP_TCP_DELAYED_ACK_TIMEOUT == 0u) ||
+            (handle->rx_unacked_segment_count >= TCP_DELAYED_ACK_SEGMENT_COUNT))
+        {
+            /* Acknowledge at least every second segment (RFC 1122) */
+            (void)NANO_IP_TCP_SendControlFrame(handle, TCP_FLAG_ACK);
+        }
+        else if (handle->rx_unacked_segment_count == 1u)
+        {
+            /* Start the delayed acknowledge timeout */
+            (void)NANO_IP_TIMER_Start(&handle->ack_timer, NANO_IP_TCP_DELAYED_ACK_TIMEOUT);
+        }
+        else
+        {
+            /* Timeout already running */
+        }
+    }
+}
+
+/** \brief Deliver in sequence data to the application */
+static bool NANO_IP_TCP_DeliverRxData(nano_ip_tcp_handle_t* const handle, nano_ip_net_packet_t* const packet)
+{
+    bool release_packet;
+    nano_ip_tcp_event_data_t event_data;
+    const uint16_t length = packet->count;
+
+    /* Update ack number */
+    handle->ack_number += length;
+
+    /* Data received, call the registered callback */
+    (void)MEMSET(&event_data, 0, sizeof(event_data));
+    event_data.error = NIP_ERR_SUCCESS;
+    event_data.packet = packet;
+    release_packet = handle->callback(handle->user_data, TCP_EVENT_RX, &event_data);
+    if (!release_packet)
+    {
+        /* Data is buffered until the application consumes it */
+        handle->rx_buffered += length;
+    }
+
+    return release_packet;
+}
+
+/** \brief Get the sequence number of a received segment */
+static uint32_t NANO_IP_TCP_GetRxSegmentSeqNumber(const nano_ip_net_packet_t* const packet)
+{
+    /* Locate the TCP header behind the IPv4 header */
+    const uint8_t* const ipv4_header = &packet->data[ETHERNET_HEADER_SIZE];
+    const uint8_t* const tcp_header = &ipv4_header[(ipv4_header[0u] & 0x0Fu) * sizeof(uint32_t)];
+
+    return NANO_IP_CAST(uint32_t, NET_READ_32(&tcp_header[4u]));
+}
+
+/** \brief Store an out-of-order segment */
+static bool NANO_IP_TCP_QueueRxOooSegment(nano_ip_tcp_handle_t* const handle, const uint32_t seq_number, nano_ip_net_packet_t* const packet)
+{
+    bool queued = false;
+
+    /* Check if the queue is full */
+    if (handle->rx_ooo_count < NANO_IP_TCP_MAX_RX_OOO_SEGMENT_COUNT)
+    {
+        /* Look for the insertion position */
+        nano_ip_net_packet_t* previous_packet = NULL;
+        nano_ip_net_packet_t* current_packet = handle->rx_ooo_packets.head;
+        while ((current_packet != NULL) && TCP_SEQ_LT(NANO_IP_TCP_GetRxSegmentSeqNumber(current_packet), seq_number))
+        {
+            previous_packet = current_packet;
+            current_packet = current_packet->next;
+        }
+
+        /* Ignore duplicates */
+        if ((current_packet == NULL) || (NANO_IP_TCP_GetRxSegmentSeqNumber(current_packet) != seq_number))
+        {
+            packet->next = current_packet;
+            if (previous_packet == NULL)
+            {
+                handle->rx_ooo_packets.head = packet;
+            }
+            else
+            {
+                previous_packet->next = packet;
+            }
+            if (current_packet == NULL)
+            {
+                handle->rx_ooo_packets.tail = packet;
+            }
+            handle->rx_ooo_count++;
+            queued = true;
+        }
+    }
+
+    return queued;
+}
+
+/** \brief Build the SACK blocks describing the out-of-order segments */
+static uint8_t NANO_IP_TCP_GetSackBlocks(const nano_ip_tcp_handle_t* const handle, tcp_sack_block_t* const blocks, const uint8_t max_count)
+{
+    uint8_t count = 0u;
+    const nano_ip_net_packet_t* packet = handle->rx_ooo_packets.head;
+    while (packet != NULL)
+    {
+        const uint32_t left = NANO_IP_TCP_GetRxSegmentSeqNumber(packet);
+        const uint32_t right = left + packet->count;
+        if ((count != 0u) && TCP_SEQ_LEQ(left, blocks[count - 1u].right))
+        {
+            /* Contiguous segment, extend the current block */
+            if (TCP_SEQ_LT(blocks[count - 1u].right, right))
+            {
+                blocks[count - 1u].right = right;
+            }
+        }
+        else if (count < max_count)
+        {
+            /* New block */
+            blocks[count].left = left;
+            blocks[count].right = right;
+            count++;
+        }
+        else
+        {
+            /* No more room in the option */
+        }
+        packet = packet->next;
+    }
+
+    return count;
+}
+
+/** \brief Deliver the out-of-order segments which are now in sequence */
+static void NANO_IP_TCP_DeliverRxOooSegments(nano_ip_tcp_handle_t* const handle)
+{
+    while ((handle->rx_ooo_packets.head != NULL) && 
+           TCP_SEQ_LEQ(NANO_IP_TCP_GetRxSegmentSeqNumber(handle->rx_ooo_packets.head), handle->ack_number))
+    {
+        bool release_packet = true;
+        nano_ip_net_packet_t* const packet = NANO_IP_PACKET_PopFromQueue(&handle->rx_ooo_packets);
+        const uint32_t seq_number = NANO_IP_TCP_GetRxSegmentSeqNumber(packet);
+        handle->rx_ooo_count--;
+
+        /* Skip the data which has already been received */
+        if (TCP_SEQ_LT(handle->ack_number, seq_number + packet->count))
+        {
+            NANO_IP_PACKET_ReadSkipBytes(packet, NANO_IP_CAST(uint16_t, (handle->ack_number - seq_number)));
+            release_packet = NANO_IP_TCP_DeliverRxData(handle, packet);
+        }
+        if (release_packet)
+        {
+            (void)NANO_IP_TCP_ReleasePacket(packet);
+        }
+    }
+}
+
+/** \brief Release all the out-of-order segments of a handle */
+static void NANO_IP_TCP_ReleaseRxOooSegments(nano_ip_tcp_handle_t* const handle)
+{
+    while (!NANO_IP_PACKET_QueueIsEmpty(&handle->rx_ooo_packets))
+    {
+        (void)NANO_IP_TCP_ReleasePacket(NANO_IP_PACKET_PopFromQueue(&handle->rx_ooo_packets));
+    }
+    handle->rx_ooo_count = 0u;
+}
+
 #endif /* NANO_IP_ENABLE_TCP */
@@ -26,6 +26,7 @@ along with Nano-IP.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "nano_ip_types.h"
 #include "nano_ip_ipv4.h"
+#include "nano_ip_timer.h"
 
 
 
@@ -34,7 +35,20 @@ extern "C"
 {
 #endif /* __cplusplus */
 
+
+/** \brief Maximum number of SACK blocks in a TCP frame */
+#define TCP_MAX_SACK_BLOCK_COUNT        4u
+
   
+/** \brief TCP selective acknowledge block */
+typedef struct _tcp_sack_block_t
+{
+    /** \brief First sequence number of the block */
+    uint32_t left;
+    /** \brief Sequence number following the last byte of the block */
+    uint32_t right;
+} tcp_sack_block_t;
+
 /** \brief TCP header */
 typedef struct _tcp_header_t
 {
@@ -54,6 +68,24 @@ typedef struct _tcp_header_t
     uint8_t flags;
     /** \brief Window size */
     uint16_t window;
+    /** \brief Maximum segment size option (0 if not present) */
+    uint16_t mss;
+    /** \brief Indicate if the window scale option is present */
+    bool ws_present;
+    /** \brief Window scale option */
+    uint8_t window_scale;
+    /** \brief Indicate if the SACK permitted option is present */
+    bool sack_permitted;
+    /** \brief Indicate if the timestamp option is present */
+    bool ts_present;
+    /** \brief Timestamp value */
+    uint32_t ts_value;
+    /** \brief Timestamp echo reply */
+    uint32_t ts_echo;
+    /** \brief Number of SACK blocks */
+    uint8_t sack_count;
+    /** \brief SACK blocks */
+    tcp_sack_block_t sack_blocks[TCP_MAX_SACK_BLOCK_COUNT];
 } tcp_header_t;
 
 /** \brief TCP event */
@@ -127,6 +159,50 @@ typedef enum _nano_ip_tcp_handle_state_t
     TCP_STATE_IDLE = 255u
 } nano_ip_tcp_handle_state_t;
 
+/** \brief TCP transmitted segment waiting for an acknowledge */
+typedef struct _nano_ip_tcp_tx_segment_t
+{
+    /** \brief Packet holding the segment */
+    nano_ip_net_packet_t* packet;
+    /** \brief End of the segment data in the packet */
+    uint8_t* packet_end;
+    /** \brief Sequence number of the first data byte */
+    uint32_t seq_number;
+    /** \brief Data length in bytes */
+    uint16_t length;
+    /** \brief Indicate if the segment has been retransmitted */
+    bool retransmitted;
+    /** \brief Indicate if the segment has been selectively acknowledged */
+    bool sacked;
+    /** \brief Timestamp of the first transmission in milliseconds */
+    uint32_t tx_timestamp;
+} nano_ip_tcp_tx_segment_t;
+
+/** \brief TCP connection statistics */
+typedef struct _nano_ip_tcp_stats_t
+{
+    /** \brief Congestion window in bytes */
+    uint32_t cwnd;
+    /** \brief Slow start threshold in bytes */
+    uint32_t ssthresh;
+    /** \brief Peer's receive window in bytes */
+    uint32_t tx_window;
+    /** \brief Maximum segment size in bytes */
+    uint16_t mss;
+    /** \brief Number of unacknowledged bytes */
+    uint32_t bytes_in_flight;
+    /** \brief Smoothed round-trip time in milliseconds */
+    uint32_t srtt;
+    /** \brief Retransmission timeout in milliseconds */
+    uint32_t rto;
+    /** \brief Number of retransmission timeouts */
+    uint32_t rto_count;
+    /** \brief Number of fast retransmits */
+    uint32_t fast_retransmit_count;
+    /** \brief Indicate if the connection is in fast recovery */
+    bool fast_recovery;
+} nano_ip_tcp_stats_t;
+
 /** \brief TCP handle */
 typedef struct _nano_ip_tcp_handle_t
 {
@@ -148,18 +224,74 @@ typedef struct _nano_ip_tcp_handle_t
     uint32_t seq_number;
     /** \brief Acknowledge number */
     uint32_t ack_number;
-    /** \brief Last packet sent */
-    nano_ip_net_packet_t* last_tx_packet;
-    /** \brief Last packet sent position */
-    uint8_t* last_tx_packet_pos;
-    /** \brief Last packet sent count */
-    uint16_t last_tx_packet_count;
-    /** \brief Last packet IPv4 header */
-    ipv4_header_t last_tx_packet_ipv4_header;
+    /** \brief Sequence number of the oldest unacknowledged byte */
+    uint32_t tx_unacked_seq_number;
+    /** \brief Maximum segment size for transmission */
+    uint16_t mss;
+    /** \brief Peer's receive window size */
+    uint32_t tx_window;
+    /** \brief Indicate if the window scale option is in use */
+    bool ws_enabled;
+    /** \brief Shift count applied to the peer's window */
+    uint8_t tx_window_scale;
+    /** \brief Shift count applied to the advertised receive window */
+    uint8_t rx_window_scale;
+    /** \brief Indicate if selective acknowledges are in use */
+    bool sack_enabled;
+    /** \brief Indicate if the timestamp option is in use */
+    bool ts_enabled;
+    /** \brief Most recent timestamp value to echo to the peer */
+    uint32_t ts_recent;
+    /** \brief Last acknowledge number sent */
+    uint32_t last_ack_sent;
+    /** \brief Number of received segments not yet acknowledged */
+    uint8_t rx_unacked_segment_count;
+    /** \brief Delayed acknowledge timer */
+    nano_ip_timer_t ack_timer;
+    /** \brief Congestion window in bytes */
+    uint32_t cwnd;
+    /** \brief Slow start threshold in bytes */
+    uint32_t ssthresh;
+    /** \brief Highest sequence number sent when the last loss recovery started */
+    uint32_t recover;
+    /** \brief Number of consecutive duplicate acknowledges */
+    uint8_t dup_ack_count;
+    /** \brief Indicate if the connection is in fast recovery */
+    bool fast_recovery;
+    /** \brief Number of retransmission timeouts */
+    uint32_t rto_count;
+    /** \brief Number of fast retransmits */
+    uint32_t fast_retransmit_count;
+    /** \brief Unacknowledged segments */
+    nano_ip_tcp_tx_segment_t tx_segments[NANO_IP_TCP_MAX_TX_SEGMENT_COUNT];
+    /** \brief Index of the oldest unacknowledged segment */
+    uint8_t tx_segment_first;
+    /** \brief Number of unacknowledged segments */
+    uint8_t tx_segment_count;
     /** \brief Retry count */
     uint8_t tx_retry_count;
-    /** \brief State timeout */
-    uint32_t state_timeout;
+    /** \brief Smoothed round-trip time in milliseconds (scaled by 8) */
+    uint32_t srtt;
+    /** \brief Round-trip time variation in milliseconds (scaled by 4) */
+    uint32_t rttvar;
+    /** \brief Indicate if a round-trip time has already been measured */
+    bool rtt_valid;
+    /** \brief Retransmission timeout in milliseconds */
+    uint32_t rto;
+    /** \brief Retransmission timer of the oldest unacknowledged segment */
+    nano_ip_timer_t rto_timer;
+    /** \brief Number of out-of-order segments */
+    uint8_t rx_ooo_count;
+    /** \brief Out-of-order segments sorted by sequence number */
+    nano_ip_packet_queue_t rx_ooo_packets;
+    /** \brief Size in bytes of the receive buffer */
+    uint32_t rx_buffer_size;
+    /** \brief Number of received bytes not yet consumed by the application */
+    uint32_t rx_buffered;
+    /** \brief Last advertised receive window */
+    uint32_t rx_window;
+    /** \brief State timeout timer */
+    nano_ip_timer_t state_timer;
     /** \brief User data */
     void* user_data;
     /** \brief Next handle */
@@ -172,8 +304,6 @@ typedef struct _nano_ip_tcp_module_data_t
 {
     /** \brief IPv4 protocol description */
     nano_ip_ipv4_protocol_t ipv4_protocol;
-    /** \brief IPv4 periodic callback */
-    nano_ip_ipv4_periodic_callback_t ipv4_callback;
     /** \brief Next free local port */
     uint16_t next_free_local_port;
     /** \brief TCP handle list */
@@ -215,6 +345,12 @@ nano_ip_error_t NANO_IP_TCP_SendPacket(nano_ip_tcp_handle_t* const handle, nano_
 /** \brief Indicate if a TCP handle is ready */
 nano_ip_error_t NANO_IP_TCP_HandleIsReady(nano_ip_tcp_handle_t* const handle);
 
+/** \brief Indicate that received data has been consumed by the application to reopen the receive window */
+nano_ip_error_t NANO_IP_TCP_UpdateRxWindow(nano_ip_tcp_handle_t* const handle, const uint32_t consumed_size);
+
+/** \brief Get the statistics of a TCP connection */
+nano_ip_error_t NANO_IP_TCP_GetStats(nano_ip_tcp_handle_t* const handle, nano_ip_tcp_stats_t* const stats);
+
 /** \brief Release a TCP frame */
 nano_ip_error_t NANO_IP_TCP_ReleasePacket(nano_ip_net_packet_t* const packet);
 
@@ -0,0 +1,284 @@
+/*
+Copyright(c) 2017 Cedric Jimenez
+
+This file is part of Nano-IP.
+
+Nano-IP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Nano-IP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with Nano-IP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "nano_ip_timer.h"
+#include "nano_ip_tools.h"
+#include "nano_ip_data.h"
+
+
+/* The OAL time base is in milliseconds */
+#if (NANO_IP_TIMER_TICK_PERIOD == 0u)
+#error "NANO_IP_TIMER_TICK_PERIOD must be at least 1 ms"
+#endif /* NANO_IP_TIMER_TICK_PERIOD */
+
+
+/** \brief Check if tick a is before or equal to tick b (modulo 2^32) */
+#define TIMER_TICK_LEQ(a, b)    (NANO_IP_CAST(int32_t, ((a) - (b))) <= 0)
+
+
+
+/** \brief Link a timer at the head of a list */
+static void NANO_IP_TIMER_Link(nano_ip_timer_t** const list, nano_ip_timer_t* const timer);
+
+/** \brief Unlink a timer from the list holding it */
+static void NANO_IP_TIMER_Unlink(nano_ip_timer_t* const timer);
+
+#if (NANO_IP_ENABLE_RUN_TO_COMPLETION == 0u)
+/** \brief Called on every tick of the OAL timer */
+static void NANO_IP_TIMER_TickCallback(oal_timer_t* const timer, void* const user_data);
+#endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
+
+
+
+/** \brief Initialize the timer module */
+nano_ip_error_t NANO_IP_TIMER_Init(void)
+{
+    nano_ip_error_t ret = NIP_ERR_SUCCESS;
+    nano_ip_timer_module_data_t* const timer_module = &g_nano_ip.timer_module;
+
+    /* Start the wheel at the current time */
+    timer_module->current_tick = 0u;
+    timer_module->current_tick_timestamp = NANO_IP_OAL_TIME_GetMsCounter();
+
+    #if (NANO_IP_ENABLE_RUN_TO_COMPLETION == 0u)
+    /* Create and start the tick timer */
+    ret = NANO_IP_OAL_TIMER_Create(&timer_module->tick_timer, NANO_IP_TIMER_TickCallback, timer_module);
+    if (ret == NIP_ERR_SUCCESS)
+    {
+        ret = NANO_IP_OAL_TIMER_Start(&timer_module->tick_timer, NANO_IP_TIMER_TICK_PERIOD);
+    }
+    #endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
+
+    return ret;
+}
+
+/** \brief Initialize a stack timer */
+nano_ip_error_t NANO_IP_TIMER_InitializeTimer(nano_ip_timer_t* const timer, const nano_ip_timer_callback_t callback, void* const user_data)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+
+    /* Check parameters */
+    if ((timer != NULL) && (callback != NULL))
+    {
+        /* 0 init */
+        MEMSET(timer, 0, sizeof(nano_ip_timer_t));
+
+        /* Save callback */
+        timer->callback = callback;
+        timer->user_data = user_data;
+
+        ret = NIP_ERR_SUCCESS;
+    }
+
+    return ret;
+}
+
+/** \brief Start or restart a stack timer, the callback is called once after timeout milliseconds */
+nano_ip_error_t NANO_IP_TIMER_Start(nano_ip_timer_t* const timer, const uint32_t timeout)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+
+    /* Check parameters */
+    if ((timer != NULL) && (timer->callback != NULL))
+    {
+        uint32_t ticks;
+        nano_ip_timer_module_data_t* const timer_module = &g_nano_ip.timer_module;
+
+        (void)NANO_IP_OAL_MUTEX_Lock(&g_nano_ip.mutex);
+
+        /* Convert the timeout in ticks from the current tick, rounded up so that the timer never expires early */
+        ticks = (NANO_IP_OAL_TIME_GetMsCounter() - timer_module->current_tick_timestamp) + timeout;
+        ticks = (ticks + (NANO_IP_TIMER_TICK_PERIOD - 1u)) / NANO_IP_TIMER_TICK_PERIOD;
+        if (ticks == 0u)
+        {
+            ticks = 1u;
+        }
+
+        /* Store the timer in the slot of its expiry tick */
+        NANO_IP_TIMER_Unlink(timer);
+        timer->expiry_tick = timer_module->current_tick + ticks;
+        NANO_IP_TIMER_Link(&timer_module->slots[timer->expiry_tick % NANO_IP_TIMER_WHEEL_SIZE], timer);
+
+        #if (NANO_IP_ENABLE_RUN_TO_COMPLETION != 0u)
+        /* Outside of NANO_IP_Poll(), the application may be waiting with a timeout computed before this timer was started */
+        if (!g_nano_ip.polling)
+        {
+            (void)NANO_IP_OAL_POLL_Signal(&g_nano_ip.poll);
+        }
+        #endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
+
+        (void)NANO_IP_OAL_MUTEX_Unlock(&g_nano_ip.mutex);
+
+        ret = NIP_ERR_SUCCESS;
+    }
+
+    return ret;
+}
+
+/** \brief Stop a stack timer */
+nano_ip_error_t NANO_IP_TIMER_Stop(nano_ip_timer_t* const timer)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+
+    /* Check parameters */
+    if (timer != NULL)
+    {
+        (void)NANO_IP_OAL_MUTEX_Lock(&g_nano_ip.mutex);
+        NANO_IP_TIMER_Unlink(timer);
+        (void)NANO_IP_OAL_MUTEX_Unlock(&g_nano_ip.mutex);
+
+        ret = NIP_ERR_SUCCESS;
+    }
+
+    return ret;
+}
+
+/** \brief Indicate if a stack timer is running */
+bool NANO_IP_TIMER_IsRunning(const nano_ip_timer_t* const timer)
+{
+    return ((timer != NULL) && (timer->previous_link != NULL));
+}
+
+
+/** \brief Link a timer at the head of a list */
+static void NANO_IP_TIMER_Link(nano_ip_timer_t** const list, nano_ip_timer_t* const timer)
+{
+    timer->next = (*list);
+    if (timer->next != NULL)
+    {
+        timer->next->previous_link = &timer->next;
+    }
+    timer->previous_link = list;
+    (*list) = timer;
+}
+
+/** \brief Unlink a timer from the list holding it */
+static void NANO_IP_TIMER_Unlink(nano_ip_timer_t* const timer)
+{
+    if (timer->previous_link != NULL)
+    {
+        (*timer->previous_link) = timer->next;
+        if (timer->next != NULL)
+        {
+            timer->next->previous_link = timer->previous_link;
+        }
+        timer->previous_link = NULL;
+        timer->next = NULL;
+    }
+}
+
+/** \brief Advance the wheel to the current time and call the callbacks of the expired timers */
+void NANO_IP_TIMER_Process(void)
+{
+    nano_ip_timer_module_data_t* const timer_module = &g_nano_ip.timer_module;
+    uint32_t elapsed_ticks;
+
+    (void)NANO_IP_OAL_MUTEX_Lock(&g_nano_ip.mutex);
+
+    /* Compute the number of elapsed ticks (several ticks may elapse if the wheel has not been advanced in time) */
+    elapsed_ticks = (NANO_IP_OAL_TIME_GetMsCounter() - timer_module->current_tick_timestamp) / NANO_IP_TIMER_TICK_PERIOD;
+    if (elapsed_ticks != 0u)
+    {
+        uint32_t i;
+        uint32_t slot_count = elapsed_ticks;
+        const uint32_t target_tick = timer_module->current_tick + elapsed_ticks;
+        if (slot_count > NANO_IP_TIMER_WHEEL_SIZE)
+        {
+            slot_count = NANO_IP_TIMER_WHEEL_SIZE;
+        }
+
+        /* Move the expired timers of the elapsed ticks' slots to the expired list,
+           the timers due on a later turn of the wheel stay in their slot */
+        for (i = 1u; i <= slot_count; i++)
+        {
+            nano_ip_timer_t* current = timer_module->slots[(timer_module->current_tick + i) % NANO_IP_TIMER_WHEEL_SIZE];
+            while (current != NULL)
+            {
+                nano_ip_timer_t* const next = current->next;
+                if (TIMER_TICK_LEQ(current->expiry_tick, target_tick))
+                {
+                    NANO_IP_TIMER_Unlink(current);
+                    NANO_IP_TIMER_Link(&timer_module->expired, current);
+                }
+                current = next;
+            }
+        }
+        timer_module->current_tick = target_tick;
+        timer_module->current_tick_timestamp += elapsed_ticks * NANO_IP_TIMER_TICK_PERIOD;
+
+        /* Call the expired timers' callbacks, they may start or stop any timer (including the expired ones) */
+        while (timer_module->expired != NULL)
+        {
+            nano_ip_timer_t* const expired_timer = timer_module->expired;
+            NANO_IP_TIMER_Unlink(expired_timer);
+            expired_timer->callback(expired_timer, expired_timer->user_data);
+        }
+    }
+
+    (void)NANO_IP_OAL_MUTEX_Unlock(&g_nano_ip.mutex);
+}
+
+/** \brief Get the time in milliseconds until the next tick with running timers (NANO_IP_MAX_TIMEOUT_VALUE if no timer is running) */
+uint32_t NANO_IP_TIMER_GetNextTimeout(void)
+{
+    uint32_t i;
+    bool found = false;
+    uint32_t timeout = NANO_IP_MAX_TIMEOUT_VALUE;
+    nano_ip_timer_module_data_t* const timer_module = &g_nano_ip.timer_module;
+
+    (void)NANO_IP_OAL_MUTEX_Lock(&g_nano_ip.mutex);
+
+    /* Look for the first non empty slot, its timers may be due on a later turn of the wheel in which case the wake up is early but harmless */
+    for (i = 1u; (i <= NANO_IP_TIMER_WHEEL_SIZE) && !found; i++)
+    {
+        if (timer_module->slots[(timer_module->current_tick + i) % NANO_IP_TIMER_WHEEL_SIZE] != NULL)
+        {
+            found = true;
+            const uint32_t elapsed = NANO_IP_OAL_TIME_GetMsCounter() - timer_module->current_tick_timestamp;
+            const uint32_t deadline = i * NANO_IP_TIMER_TICK_PERIOD;
+            if (deadline > elapsed)
+            {
+                timeout = deadline - elapsed;
+            }
+            else
+            {
+                timeout = 0u;
+            }
+        }
+    }
+
+    (void)NANO_IP_OAL_MUTEX_Unlock(&g_nano_ip.mutex);
+
+    return timeout;
+}
+
+
+#if (NANO_IP_ENABLE_RUN_TO_COMPLETION == 0u)
+
+/** \brief Called on every tick of the OAL timer */
+static void NANO_IP_TIMER_TickCallback(oal_timer_t* const timer, void* const user_data)
+{
+    (void)timer;
+    (void)user_data;
+
+    /* Advance the wheel */
+    NANO_IP_TIMER_Process();
+}
+
+#endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
@@ -0,0 +1,102 @@
+/*
+Copyright(c) 2017 Cedric Jimenez
+
+This file is part of Nano-IP.
+
+Nano-IP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Nano-IP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with Nano-IP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef NANO_IP_TIMER_H
+#define NANO_IP_TIMER_H
+
+#include "nano_ip_types.h"
+#include "nano_ip_error.h"
+#include "nano_ip_cfg.h"
+#include "nano_ip_oal.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+
+/* Pre-declaration of stack timer */
+struct _nano_ip_timer_t;
+
+/** \brief Stack timer callback (called with the stack lock held) */
+typedef void (*nano_ip_timer_callback_t)(struct _nano_ip_timer_t* const timer, void* const user_data);
+
+
+/** \brief Stack timer */
+typedef struct _nano_ip_timer_t
+{
+    /** \brief Tick at which the timer expires */
+    uint32_t expiry_tick;
+    /** \brief Callback */
+    nano_ip_timer_callback_t callback;
+    /** \brief User data */
+    void* user_data;
+    /** \brief Link of the previous timer in the list holding the timer (NULL if the timer is not running) */
+    struct _nano_ip_timer_t** previous_link;
+    /** \brief Next timer */
+    struct _nano_ip_timer_t* next;
+} nano_ip_timer_t;
+
+
+/** \brief Timer module internal data */
+typedef struct _nano_ip_timer_module_data_t
+{
+    #if (NANO_IP_ENABLE_RUN_TO_COMPLETION == 0u)
+    /** \brief OAL timer driving the wheel */
+    oal_timer_t tick_timer;
+    #endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
+    /** \brief Current tick */
+    uint32_t current_tick;
+    /** \brief Timestamp in milliseconds of the current tick */
+    uint32_t current_tick_timestamp;
+    /** \brief Wheel slots, a timer is stored in the slot of its expiry tick */
+    nano_ip_timer_t* slots[NANO_IP_TIMER_WHEEL_SIZE];
+    /** \brief Expired timers waiting for their callback */
+    nano_ip_timer_t* expired;
+} nano_ip_timer_module_data_t;
+
+
+
+/** \brief Initialize the timer module */
+nano_ip_error_t NANO_IP_TIMER_Init(void);
+
+/** \brief Initialize a stack timer */
+nano_ip_error_t NANO_IP_TIMER_InitializeTimer(nano_ip_timer_t* const timer, const nano_ip_timer_callback_t callback, void* const user_data);
+
+/** \brief Start or restart a stack timer, the callback is called once after timeout milliseconds (rounded up to the tick period) */
+nano_ip_error_t NANO_IP_TIMER_Start(nano_ip_timer_t* const timer, const uint32_t timeout);
+
+/** \brief Stop a stack timer */
+nano_ip_error_t NANO_IP_TIMER_Stop(nano_ip_timer_t* const timer);
+
+/** \brief Indicate if a stack timer is running */
+bool NANO_IP_TIMER_IsRunning(const nano_ip_timer_t* const timer);
+
+/** \brief Advance the wheel to the current time and call the callbacks of the expired timers */
+void NANO_IP_TIMER_Process(void);
+
+/** \brief Get the time in milliseconds until the next tick with running timers (NANO_IP_MAX_TIMEOUT_VALUE if no timer is running) */
+uint32_t NANO_IP_TIMER_GetNextTimeout(void);
+
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* NANO_IP_TIMER_H */
@@ -49,7 +49,7 @@ static nano_ip_error_t NANO_IP_UDP_RxFrame(void* user_data, nano_ip_net_if_t* co
 #if (NANO_IP_ENABLE_UDP_CHECKSUM == 1u)
 
 /** \brief Compute the UDP checksum of a buffer */
-static uint16_t NANO_IP_UDP_ComputeCS(const ipv4_header_t* const ipv4_header, uint8_t* const buffer, const uint16_t size);
+static uint16_t NANO_IP_UDP_ComputeCS(const ipv4_header_t* const ipv4_header, uint8_t* const buffer, const uint16_t size, const nano_ip_packet_segment_t* const segments);
 
 #endif /* NANO_IP_ENABLE_UDP_CHECKSUM */
 
@@ -265,7 +265,8 @@ nano_ip_error_t NANO_IP_UDP_SendPacket(nano_ip_udp_handle_t* const handle, const
     if ((handle != NULL) && (packet != NULL))
     {
         ipv4_header_t ipv4_header;
-        uint16_t udp_length = packet->count + UDP_HEADER_SIZE;
+        const uint16_t header_length = packet->count + UDP_HEADER_SIZE;
+        uint16_t udp_length = header_length + NANO_IP_PACKET_GetSegmentsSize(packet);
         uint16_t packet_size = NANO_IP_CAST(uint16_t, packet->current - packet->data);
         uint8_t* const current_pos = packet->current;
         uint8_t* checksum_pos;
@@ -275,7 +276,7 @@ nano_ip_error_t NANO_IP_UDP_SendPacket(nano_ip_udp_handle_t* const handle, const
         #endif /* NANO_IP_ENABLE_UDP_CHECKSUM */
 
         /* Set current position to UDP header */
-        packet->current -= udp_length;
+        packet->current -= header_length;
         #if (NANO_IP_ENABLE_UDP_CHECKSUM == 1u)
         header_start = packet->current;
         #endif /* NANO_IP_ENABLE_UDP_CHECKSUM */
@@ -315,7 +316,7 @@ nano_ip_error_t NANO_IP_UDP_SendPacket(nano_ip_udp_handle_t* const handle, const
 
         /* Write checksum */
         #if (NANO_IP_ENABLE_UDP_CHECKSUM == 1u)
-        checksum = NANO_IP_UDP_ComputeCS(&ipv4_header, header_start, udp_length);
+        checksum = NANO_IP_UDP_ComputeCS(&ipv4_header, header_start, header_length, packet->segments);
         #else
         checksum = 0u;
         #endif /* NANO_IP_ENABLE_UDP_CHECKSUM */
@@ -446,7 +447,7 @@ static nano_ip_error_t NANO_IP_UDP_RxFrame(void* user_data, nano_ip_net_if_t* co
             checksum = NANO_IP_PACKET_Read16bits(packet);
             if ((checksum != 0u) && ((net_if->driver->caps & NETDRV_CAP_UDPIPV4_CS_CHECK) == 0u))
             {
-                null_checksum = NANO_IP_UDP_ComputeCS(ipv4_header, header_start, length + UDP_HEADER_SIZE);
+                null_checksum = NANO_IP_UDP_ComputeCS(ipv4_header, header_start, length + UDP_HEADER_SIZE, NULL);
                 if (null_checksum != 0u)
                 {
                     ret = NIP_ERR_INVALID_CS;
@@ -485,7 +486,8 @@ static nano_ip_error_t NANO_IP_UDP_RxFrame(void* user_data, nano_ip_net_if_t* co
                         release_packet = handle->callback(handle->user_data, UDP_EVENT_RX, &event_data);
                         if (!release_packet)
                         {
-                            packet->flags |= NET_IF_PACKET_FLAG_KEEP_PACKET;
+                            /* Reference held by the receiver until it releases the packet */
+                            NANO_IP_PACKET_Retain(packet);
                         }
                         ret = NIP_ERR_SUCCESS;
                     }
@@ -512,10 +514,19 @@ static nano_ip_error_t NANO_IP_UDP_RxFrame(void* user_data, nano_ip_net_if_t* co
 
 #if (NANO_IP_ENABLE_UDP_CHECKSUM == 1u)
 
-/** \brief Compute the UDP checksum of a buffer */
-static uint16_t NANO_IP_UDP_ComputeCS(const ipv4_header_t* const ipv4_header, uint8_t* const buffer, const uint16_t size)
+/** \brief Compute the UDP checksum of a buffer followed by payload segments */
+static uint16_t NANO_IP_UDP_ComputeCS(const ipv4_header_t* const ipv4_header, uint8_t* const buffer, const uint16_t size, const nano_ip_packet_segment_t* const segments)
 {
     uint8_t pseudo_header[UDP_PSEUDO_HEADER_SIZE];
+    uint32_t sum;
+    uint32_t offset = size;
+    uint16_t total_size = size;
+    const nano_ip_packet_segment_t* segment = segments;
+    while (segment != NULL)
+    {
+        total_size += segment->size;
+        segment = segment->next;
+    }
 
     /* Fill pseudo header */
     pseudo_header[0u] = NANO_IP_CAST(uint8_t, (ipv4_header->src_address >> 24u));
@@ -528,11 +539,20 @@ static uint16_t NANO_IP_UDP_ComputeCS(const ipv4_header_t* const ipv4_header, ui
     pseudo_header[7u] = NANO_IP_CAST(uint8_t, (ipv4_header->dest_address & 0xFFu));
     pseudo_header[8u] = 0;
     pseudo_header[9u] = UDP_PROTOCOL;
-    pseudo_header[10u] = NANO_IP_CAST(uint8_t, (size >> 8u));
-    pseudo_header[11u] = NANO_IP_CAST(uint8_t, (size & 0x00FFu));
+    pseudo_header[10u] = NANO_IP_CAST(uint8_t, (total_size >> 8u));
+    pseudo_header[11u] = NANO_IP_CAST(uint8_t, (total_size & 0x00FFu));
 
     /* Compute checksum with the pseudo header */
-    return NANO_IP_ComputeInternetCS(pseudo_header, sizeof(pseudo_header), buffer, size);
+    sum = NANO_IP_AddToInternetCS(0u, pseudo_header, sizeof(pseudo_header), 0u);
+    sum = NANO_IP_AddToInternetCS(sum, buffer, size, 0u);
+    segment = segments;
+    while (segment != NULL)
+    {
+        sum = NANO_IP_AddToInternetCS(sum, segment->data, segment->size, offset);
+        offset += segment->size;
+        segment = segment->next;
+    }
+    return NANO_IP_FinalizeInternetCS(sum);
 }
 
 #endif /* NANO_IP_ENABLE_UDP_CHECKSUM */
@@ -42,6 +42,16 @@ typedef enum _nano_ip_socket_event_flags_t
 } nano_ip_socket_event_flags_t;
 
 
+#if (NANO_IP_ENABLE_RUN_TO_COMPLETION != 0u)
+/** \brief In run-to-completion mode the socket events are only processed by NANO_IP_Poll() in the application's context,
+           a blocking call would never return: all the sockets are non-blocking */
+#define SOCKET_BLOCKING_ALLOWED     false
+#else
+/** \brief Blocking sockets are allowed */
+#define SOCKET_BLOCKING_ALLOWED     true
+#endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
+
+
 
 
 
@@ -55,6 +65,14 @@ static bool NANO_IP_SOCKET_UdpCallback(void* const user_data, const nano_ip_udp_
 /** \brief Callback for TCP sockets */
 static bool NANO_IP_SOCKET_TcpCallback(void* const user_data, const nano_ip_tcp_event_t event, const nano_ip_tcp_event_data_t* const event_data);
 
+#if (NANO_IP_ENABLE_TCP == 1u)
+/** \brief Send the segment being filled if allowed by the Nagle algorithm and the socket options */
+static nano_ip_error_t NANO_IP_SOCKET_TcpPush(nano_ip_socket_t* const socket, const bool force);
+
+/** \brief Wait for the data queued on a TCP socket to be acknowledged */
+static nano_ip_error_t NANO_IP_SOCKET_TcpDrain(nano_ip_socket_t* const socket);
+#endif /* NANO_IP_ENABLE_TCP */
+
 
 
 /** \brief Initialize the socket module */
@@ -129,7 +147,7 @@ nano_ip_error_t NANO_IP_SOCKET_Allocate(uint32_t* const socket_id, const nano_ip
         {
             /* 0 init */
             socket->type = type;
-            socket->options = 0u;
+            socket->options = (SOCKET_BLOCKING_ALLOWED ? 0u : NANO_IP_CAST(uint32_t, NIPSOCK_OPT_NON_BLOCK));
             NANO_IP_PACKET_ResetQueue(&socket->rx_packets);
             #if (NANO_IP_ENABLE_SOCKET_POLL == 1u)
             socket->poll = NULL;
@@ -163,6 +181,7 @@ nano_ip_error_t NANO_IP_SOCKET_Allocate(uint32_t* const socket_id, const nano_ip
                         socket->accept_pending_sockets = NULL;
                         socket->accepted_sockets = NULL;
                         socket->next = NULL;
+                        socket->tx_packet = NULL;
 
                         ret = NANO_IP_TCP_InitializeHandle(&socket->connection_handle.tcp, NANO_IP_SOCKET_TcpCallback, socket);
                         if (ret == NIP_ERR_SUCCESS)
@@ -222,7 +241,32 @@ nano_ip_error_t NANO_IP_SOCKET_Release(const uint32_t socket_id)
             case NIPSOCK_TCP:
             {
                 /* TCP */
-                ret = NANO_IP_TCP_Close(&socket->connection_handle.tcp);
+
+                /* Wait for the queued data to be acknowledged before sending the FIN */
+                const nano_ip_error_t drain_ret = NANO_IP_SOCKET_TcpDrain(socket);
+                if (socket->is_free)
+                {
+                    /* Socket has been released while waiting */
+                    ret = NIP_ERR_FAILURE;
+                }
+                else
+                {
+                    /* Drop the data which could not be sent */
+                    if (socket->tx_packet != NULL)
+                    {
+                        (void)NANO_IP_TCP_ReleasePacket(socket->tx_packet);
+                        socket->tx_packet = NULL;
+                    }
+
+                    ret = NANO_IP_TCP_Close(&socket->connection_handle.tcp);
+                    if ((ret == NIP_ERR_SUCCESS) && (drain_ret != NIP_ERR_SUCCESS))
+                    {
+                        /* Socket is released but some data has been discarded */
+                        (void)NANO_IP_OAL_FLAGS_Set(&socket->sync_flags, 0xFFFFFFFFu, false);
+                        socket->is_free = true;
+                        ret = drain_ret;
+                    }
+                }
                 break;
             }
             
@@ -412,6 +456,9 @@ nano_ip_error_t NANO_IP_SOCKET_ReceiveFrom(const uint32_t socket_id, void* const
                         }
                         while (((*received) != size) && (!NANO_IP_PACKET_QueueIsEmpty(&socket->rx_packets)));
 
+                        /* Free space in the receive window */
+                        (void)NANO_IP_TCP_UpdateRxWindow(&socket->connection_handle.tcp, NANO_IP_CAST(uint32_t, (*received)));
+
                         /* Fill endpoint */
                         if (end_point != NULL)
                         {
@@ -586,36 +633,52 @@ nano_ip_error_t NANO_IP_SOCKET_SendTo(const uint32_t socket_id, const void* cons
             {
                 /* TCP */
 
-                /* The whole data must fit into one datagram */
-                bool resend = false;
-                nano_ip_net_packet_t* packet = NULL;
-                uint16_t packet_size = NANO_IP_CAST(uint16_t, size);
-                do
+                /* Coalesce data into segments of maximum segment size */
+                bool wait_more = true;
+                const uint8_t* const buffer = NANO_IP_CAST(const uint8_t*, data);
+                ret = NIP_ERR_SUCCESS;
+                while ((ret == NIP_ERR_SUCCESS) && wait_more && ((*sent) < size))
                 {
-                    ret = NANO_IP_TCP_AllocatePacket(&packet, packet_size);
+                    /* Allocate a new segment if needed */
+                    if (socket->tx_packet == NULL)
+                    {
+                        ret = NANO_IP_TCP_AllocatePacket(&socket->tx_packet, socket->connection_handle.tcp.mss);
+                        if (ret != NIP_ERR_SUCCESS)
+                        {
+                            socket->tx_packet = NULL;
+                        }
+                    }
                     if (ret == NIP_ERR_SUCCESS)
                     {
-                        /* Copy data to send */
-                        NANO_IP_PACKET_WriteBuffer(packet, data, packet_size);
+                        /* Append data to the segment */
+                        uint16_t packet_size = socket->connection_handle.tcp.mss - socket->tx_packet->count;
+                        if ((size - (*sent)) < packet_size)
+                        {
+                            packet_size = NANO_IP_CAST(uint16_t, (size - (*sent)));
+                        }
+                        NANO_IP_PACKET_WriteBuffer(socket->tx_packet, &buffer[(*sent)], packet_size);
+                        (*sent) += packet_size;
 
-                        /* Send packet */
-                        ret = NANO_IP_TCP_SendPacket(&socket->connection_handle.tcp, packet);
-                        if (ret == NIP_ERR_SUCCESS)
+                        /* Send the segment if allowed */
+                        ret = NANO_IP_SOCKET_TcpPush(socket, false);
+                        if ((ret == NIP_ERR_BUSY) && (socket->tx_packet->count < socket->connection_handle.tcp.mss))
                         {
-                            /* Packet has been sent */
-                            (*sent) = packet_size;
+                            /* Data is buffered in the segment until the send window opens */
+                            ret = NIP_ERR_SUCCESS;
                         }
-                        else if ((ret == NIP_ERR_IN_PROGRESS) || (ret == NIP_ERR_BUSY))
+                        else if (ret == NIP_ERR_BUSY)
                         {
-                            /* If busy, the packet must be released manually and resent later */
-                            if (ret == NIP_ERR_BUSY)
+                            /* Check for non-blocking socket */
+                            if ((socket->options & NIPSOCK_OPT_NON_BLOCK) != 0)
                             {
-                                resend = true;
-                                (void)NANO_IP_TCP_ReleasePacket(packet);
+                                /* Report the partial write if some data has already been buffered */
+                                if ((*sent) != 0u)
+                                {
+                                    ret = NIP_ERR_SUCCESS;
+                                }
+                                wait_more = false;
                             }
-
-                            /* Check for non-blocking socket */
-                            if ((socket->options & NIPSOCK_OPT_NON_BLOCK) == 0)
+                            else
                             {
                                 /* Wait ready */
                                 uint32_t mask = SOCKET_EVENT_TX | SOCKET_EVENT_ERROR;
@@ -643,12 +706,10 @@ nano_ip_error_t NANO_IP_SOCKET_SendTo(const uint32_t socket_id, const void* cons
                         }
                         else
                         {
-                            /* Error, release packet */
-                            (void)NANO_IP_TCP_ReleasePacket(packet);
+                            /* Segment sent, held back or dropped on error */
                         }
                     }
                 }
-                while ((ret == NIP_ERR_SUCCESS) && (resend));
                 
                 break;
             }
@@ -850,6 +911,29 @@ nano_ip_error_t NANO_IP_SOCKET_Connect(const uint32_t socket_id, const nano_ip_s
     return ret;
 }
 
+/** \brief Get the TCP statistics of a connected socket */
+nano_ip_error_t NANO_IP_SOCKET_GetTcpStats(const uint32_t socket_id, nano_ip_tcp_stats_t* const stats)
+{
+    nano_ip_socket_t* socket;
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+
+    (void)NANO_IP_OAL_MUTEX_Lock(&g_nano_ip.mutex);
+
+    /* Check parameters */
+    socket = NANO_IP_SOCKET_Get(socket_id);
+    if ((socket != NULL) && 
+        (stats != NULL) &&
+        (socket->type == NIPSOCK_TCP))
+    {
+        /* Get statistics */
+        ret = NANO_IP_TCP_GetStats(&socket->connection_handle.tcp, stats);
+    }
+
+    (void)NANO_IP_OAL_MUTEX_Unlock(&g_nano_ip.mutex);
+
+    return ret;
+}
+
 #endif /* NANO_IP_ENABLE_TCP */
 
 
@@ -863,7 +947,7 @@ nano_ip_error_t NANO_IP_SOCKET_SetNonBlocking(const uint32_t socket_id, const bo
 
     /* Check parameters */
     socket = NANO_IP_SOCKET_Get(socket_id);
-    if (socket != NULL)
+    if ((socket != NULL) && (non_blocking || SOCKET_BLOCKING_ALLOWED))
     {
         /* Apply option */
         if (non_blocking)
@@ -883,6 +967,46 @@ nano_ip_error_t NANO_IP_SOCKET_SetNonBlocking(const uint32_t socket_id, const bo
     return ret;
 }
 
+/** \brief Set/unset an option to a socket */
+nano_ip_error_t NANO_IP_SOCKET_SetOption(const uint32_t socket_id, const nano_ip_socket_option_t option, const bool enable)
+{
+    nano_ip_socket_t* socket;
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+
+    (void)NANO_IP_OAL_MUTEX_Lock(&g_nano_ip.mutex);
+
+    /* Check parameters */
+    socket = NANO_IP_SOCKET_Get(socket_id);
+    if ((socket != NULL) &&
+        (((option == NIPSOCK_OPT_NON_BLOCK) && (enable || SOCKET_BLOCKING_ALLOWED)) || 
+         (((option == NIPSOCK_OPT_TCP_NODELAY) || (option == NIPSOCK_OPT_TCP_CORK)) && (socket->type == NIPSOCK_TCP))))
+    {
+        /* Apply option */
+        if (enable)
+        {
+            socket->options |= NANO_IP_CAST(uint32_t, option);
+        }
+        else
+        {
+            socket->options &= ~(NANO_IP_CAST(uint32_t, option));
+        }
+
+        #if (NANO_IP_ENABLE_TCP == 1u)
+        /* Send the data which is not held back anymore */
+        if (socket->type == NIPSOCK_TCP)
+        {
+            (void)NANO_IP_SOCKET_TcpPush(socket, false);
+        }
+        #endif /* NANO_IP_ENABLE_TCP */
+
+        ret = NIP_ERR_SUCCESS;
+    }
+
+    (void)NANO_IP_OAL_MUTEX_Unlock(&g_nano_ip.mutex);
+
+    return ret;
+}
+
 
 #if (NANO_IP_ENABLE_SOCKET_POLL == 1u)
 
@@ -977,11 +1101,17 @@ nano_ip_error_t NANO_IP_SOCKET_Poll(nano_ip_socket_poll_data_t* const poll_datas
                 /* Wait for a poll event */
                 if ((ret == NIP_ERR_SUCCESS) && ((*poll_count) == 0u))
                 {
+                    #if (NANO_IP_ENABLE_RUN_TO_COMPLETION != 0u)
+                    /* No event can occur before the application calls NANO_IP_Poll() again */
+                    (void)timeout;
+                    ret = NIP_ERR_TIMEOUT;
+                    #else
                     uint32_t flags = NANO_IP_OAL_FLAGS_ALL;
                     (void)NANO_IP_OAL_FLAGS_Reset(&poll->sync_flags, NANO_IP_OAL_FLAGS_ALL);
                     (void)NANO_IP_OAL_MUTEX_Unlock(&g_nano_ip.mutex);
                     ret = NANO_IP_OAL_FLAGS_Wait(&poll->sync_flags, &flags, true, timeout);
                     (void)NANO_IP_OAL_MUTEX_Lock(&g_nano_ip.mutex);
+                    #endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
                 }
             }
             while ((ret == NIP_ERR_SUCCESS) && ((*poll_count) == 0u));
@@ -1112,6 +1242,9 @@ static bool NANO_IP_SOCKET_TcpCallback(void* const user_data, const nano_ip_tcp_
 
             case TCP_EVENT_TX:
             {
+                /* Send the data held back by the Nagle algorithm */
+                (void)NANO_IP_SOCKET_TcpPush(socket, false);
+
                 /* Signal ready to transmit */
                 (void)NANO_IP_OAL_FLAGS_Set(&socket->sync_flags, SOCKET_EVENT_TX, false);
 
@@ -1227,6 +1360,13 @@ static bool NANO_IP_SOCKET_TcpCallback(void* const user_data, const nano_ip_tcp_
 
             case TCP_EVENT_CLOSED:
             {
+                /* Drop the data not yet sent */
+                if (socket->tx_packet != NULL)
+                {
+                    (void)NANO_IP_TCP_ReleasePacket(socket->tx_packet);
+                    socket->tx_packet = NULL;
+                }
+
                 /* Update parent socket */
                 if (socket->parent != NULL)
                 {
@@ -1264,5 +1404,95 @@ static bool NANO_IP_SOCKET_TcpCallback(void* const user_data, const nano_ip_tcp_
     return release_packet;    
 }
 
+#if (NANO_IP_ENABLE_TCP == 1u)
+
+/** \brief Send the segment being filled if allowed by the Nagle algorithm and the socket options */
+static nano_ip_error_t NANO_IP_SOCKET_TcpPush(nano_ip_socket_t* const socket, const bool force)
+{
+    nano_ip_error_t ret = NIP_ERR_SUCCESS;
+    nano_ip_net_packet_t* const packet = socket->tx_packet;
+
+    if (packet != NULL)
+    {
+        /* Full segments are always sent, small segments are held back while the socket is corked
+           or, unless the Nagle algorithm is disabled, while previously sent data is unacknowledged */
+        const nano_ip_tcp_handle_t* const tcp_handle = &socket->connection_handle.tcp;
+        if (force ||
+            (packet->count >= tcp_handle->mss) ||
+            (((socket->options & NIPSOCK_OPT_TCP_CORK) == 0u) &&
+             (((socket->options & NIPSOCK_OPT_TCP_NODELAY) != 0u) || (tcp_handle->tx_segment_count == 0u))))
+        {
+            ret = NANO_IP_TCP_SendPacket(&socket->connection_handle.tcp, packet);
+            if ((ret == NIP_ERR_SUCCESS) || (ret == NIP_ERR_IN_PROGRESS))
+            {
+                /* Segment is queued in the transmit window */
+                socket->tx_packet = NULL;
+                ret = NIP_ERR_SUCCESS;
+            }
+            else if (ret == NIP_ERR_BUSY)
+            {
+                /* Segment is kept until the transmit window opens */
+            }
+            else
+            {
+                /* Error, drop the segment */
+                (void)NANO_IP_TCP_ReleasePacket(packet);
+                socket->tx_packet = NULL;
+            }
+        }
+    }
+
+    return ret;
+}
+
+/** \brief Wait for the data queued on a TCP socket to be acknowledged */
+static nano_ip_error_t NANO_IP_SOCKET_TcpDrain(nano_ip_socket_t* const socket)
+{
+    nano_ip_error_t ret = NIP_ERR_SUCCESS;
+    const nano_ip_tcp_handle_t* const tcp_handle = &socket->connection_handle.tcp;
+    bool drained;
+
+    do
+    {
+        /* Send the data held back by the Nagle algorithm */
+        (void)NANO_IP_SOCKET_TcpPush(socket, true);
+
+        /* Check if all the data has been acknowledged */
+        drained = ((socket->tx_packet == NULL) && (tcp_handle->tx_segment_count == 0u));
+        if (!drained)
+        {
+            if (((socket->options & NIPSOCK_OPT_NON_BLOCK) != 0) ||
+                (tcp_handle->state != TCP_STATE_ESTABLISHED))
+            {
+                /* Unable to wait, the remaining data will be discarded */
+                ret = NIP_ERR_BUSY;
+            }
+            else
+            {
+                /* Wait for an acknowledge, the connection is closed by the retransmission
+                   timer if the peer stops acknowledging */
+                uint32_t mask = SOCKET_EVENT_TX | SOCKET_EVENT_ERROR;
+                (void)NANO_IP_OAL_MUTEX_Unlock(&g_nano_ip.mutex);
+                ret = NANO_IP_OAL_FLAGS_Wait(&socket->sync_flags, &mask, true, NANO_IP_MAX_TIMEOUT_VALUE);
+                (void)NANO_IP_OAL_MUTEX_Lock(&g_nano_ip.mutex);
+                if (socket->is_free)
+                {
+                    ret = NIP_ERR_FAILURE;
+                }
+                if ((ret == NIP_ERR_SUCCESS) && ((mask & SOCKET_EVENT_ERROR) != 0))
+                {
+                    /* Connection lost */
+                    ret = NIP_ERR_CONN_RESET;
+                }
+            }
+        }
+    }
+    while (!drained && (ret == NIP_ERR_SUCCESS));
+
+    return ret;
+}
+
+#endif /* NANO_IP_ENABLE_TCP */
+
 
 #endif /* NANO_IP_ENABLE_SOCKET */
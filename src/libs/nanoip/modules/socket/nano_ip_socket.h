@@ -91,7 +91,11 @@ typedef enum _nano_ip_socket_type_t
 typedef enum _nano_ip_socket_option_t
 {
     /** \brief Non blocking socket */
-    NIPSOCK_OPT_NON_BLOCK = 1u
+    NIPSOCK_OPT_NON_BLOCK = 1u,
+    /** \brief TCP : disable the Nagle algorithm, small segments are sent immediately */
+    NIPSOCK_OPT_TCP_NODELAY = 2u,
+    /** \brief TCP : only send full segments until the option is removed */
+    NIPSOCK_OPT_TCP_CORK = 4u
 } nano_ip_socket_option_t;
 
 
@@ -147,6 +151,8 @@ typedef struct _nano_ip_socket_t
     struct _nano_ip_socket_t* accepted_sockets;
     /** \brief Next socket */
     struct _nano_ip_socket_t* next;
+    /** \brief Segment being filled with the data to send */
+    nano_ip_net_packet_t* tx_packet;
     #endif /* NANO_IP_ENABLE_TCP */
 
 } nano_ip_socket_t;
@@ -185,7 +191,8 @@ nano_ip_error_t NANO_IP_SOCKET_Init(void);
 /** \brief Allocate a socket */
 nano_ip_error_t NANO_IP_SOCKET_Allocate(uint32_t* const socket_id, const nano_ip_socket_type_t type);
 
-/** \brief Release a socket */
+/** \brief Release a socket, a blocking TCP socket first waits for its queued data to be acknowledged
+           (the socket is always released but an error is returned if unacknowledged data is discarded) */
 nano_ip_error_t NANO_IP_SOCKET_Release(const uint32_t socket_id);
 
 /** \brief Bind a socket to a specific address and port */
@@ -214,11 +221,17 @@ nano_ip_error_t NANO_IP_SOCKET_Accept(const uint32_t socket_id, uint32_t* const
 /** \brief Connect a socket to a specific address and port */
 nano_ip_error_t NANO_IP_SOCKET_Connect(const uint32_t socket_id, const nano_ip_socket_endpoint_t* const end_point);
 
+/** \brief Get the TCP statistics of a connected socket */
+nano_ip_error_t NANO_IP_SOCKET_GetTcpStats(const uint32_t socket_id, nano_ip_tcp_stats_t* const stats);
+
 #endif /* NANO_IP_ENABLE_TCP */
 
-/** \brief Set/unset the non-blocking option to a socket */
+/** \brief Set/unset the non-blocking option to a socket (the sockets can't be made blocking in run-to-completion mode) */
 nano_ip_error_t NANO_IP_SOCKET_SetNonBlocking(const uint32_t socket_id, const bool non_blocking);
 
+/** \brief Set/unset an option to a socket */
+nano_ip_error_t NANO_IP_SOCKET_SetOption(const uint32_t socket_id, const nano_ip_socket_option_t option, const bool enable);
+
 #if (NANO_IP_ENABLE_SOCKET_POLL == 1u)
 /** \brief Wait for events on an array of sockets */
 nano_ip_error_t NANO_IP_SOCKET_Poll(nano_ip_socket_poll_data_t* const poll_datas, const uint32_t count, const uint32_t timeout, uint32_t* const poll_count);
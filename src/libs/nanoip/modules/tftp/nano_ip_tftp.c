@@ -39,7 +39,7 @@ static bool NANO_IP_TFTP_SendError(nano_ip_tftp_t* const tftp_module, const nano
 static void NANO_IP_TFTP_EndOfTransfer(nano_ip_tftp_t* const tftp_module);
 
 /** \brief TFTP timer callback */
-static void NANO_IP_TFTP_TimerCallback(oal_timer_t* const timer, void* const user_data);
+static void NANO_IP_TFTP_TimerCallback(nano_ip_timer_t* const timer, void* const user_data);
 
 
 
@@ -65,8 +65,8 @@ nano_ip_error_t NANO_IP_TFTP_Init(nano_ip_tftp_t* const tftp_module, const uint3
         tftp_module->timeout = timeout;
         MEMCPY(&tftp_module->callbacks, callbacks, sizeof(nano_ip_tftp_callbacks_t));
 
-        /* Create timer */
-        ret = NANO_IP_OAL_TIMER_Create(&tftp_module->timer, NANO_IP_TFTP_TimerCallback, tftp_module);
+        /* Initialize timer */
+        ret = NANO_IP_TIMER_InitializeTimer(&tftp_module->timer, NANO_IP_TFTP_TimerCallback, tftp_module);
     }
 
     return ret;
@@ -104,7 +104,7 @@ nano_ip_error_t NANO_IP_TFTP_Stop(nano_ip_tftp_t* const tftp_module)
         /* Stop timer */
         if ((ret == NIP_ERR_SUCCESS) && (tftp_module->req_type != TFTP_REQ_IDLE))
         {
-            ret = NANO_IP_OAL_TIMER_Stop(&tftp_module->timer);
+            ret = NANO_IP_TIMER_Stop(&tftp_module->timer);
         }
     }
 
@@ -150,7 +150,7 @@ nano_ip_error_t NANO_IP_TFTP_SendReadWriteRequest(nano_ip_tftp_t* const tftp_mod
                 tftp_module->req_type = opcode;
 
                 /* Start timer */
-                (void)NANO_IP_OAL_TIMER_Start(&tftp_module->timer, TFTP_MIN_TIMEOUT_VALUE);
+                (void)NANO_IP_TIMER_Start(&tftp_module->timer, tftp_module->timeout);
 
                 ret = NIP_ERR_SUCCESS;
             }
@@ -210,7 +210,7 @@ void NANO_IP_TFTP_ProcessReadWriteRequest(nano_ip_tftp_t* const tftp_module, nan
                     if (STRNCMP(TFTP_TRANSFER_MODE, mode, packet->count) == 0)
                     {
                         /* Start timer */
-                        (void)NANO_IP_OAL_TIMER_Start(&tftp_module->timer, TFTP_MIN_TIMEOUT_VALUE);
+                        (void)NANO_IP_TIMER_Start(&tftp_module->timer, tftp_module->timeout);
 
                         /* Notify start of transfert */
                         tftp_error = tftp_module->callbacks.req_received(tftp_module->user_data, opcode, filename);
@@ -552,7 +552,7 @@ static void NANO_IP_TFTP_EndOfTransfer(nano_ip_tftp_t* const tftp_module)
     tftp_module->req_type = TFTP_REQ_IDLE;
 
     /* Stop timer */
-    (void)NANO_IP_OAL_TIMER_Stop(&tftp_module->timer);
+    (void)NANO_IP_TIMER_Stop(&tftp_module->timer);
 
     /* Notify user */
     tftp_module->callbacks.end_of_transfert(tftp_module->user_data, tftp_module->last_error);
@@ -561,17 +561,16 @@ static void NANO_IP_TFTP_EndOfTransfer(nano_ip_tftp_t* const tftp_module)
 }
 
 /** \brief TFTP timer callback */
-static void NANO_IP_TFTP_TimerCallback(oal_timer_t* const timer, void* const user_data)
+static void NANO_IP_TFTP_TimerCallback(nano_ip_timer_t* const timer, void* const user_data)
 {
     nano_ip_tftp_t* const tftp_module = NANO_IP_CAST(nano_ip_tftp_t*, user_data);
-    (void)timer;
 
     /* Check parameters */
     if ((tftp_module != NULL) && (tftp_module->req_type != TFTP_REQ_IDLE))
     {
         /* Check timeout */
-        const uint32_t timestamp = NANO_IP_OAL_TIME_GetMsCounter();
-        if ((tftp_module->last_rx_packet_timestamp + tftp_module->timeout) <= timestamp)
+        const uint32_t elapsed = NANO_IP_OAL_TIME_GetMsCounter() - tftp_module->last_rx_packet_timestamp;
+        if (elapsed >= tftp_module->timeout)
         {
             /* Timeout */
             tftp_module->last_error = TFTP_ERR_TIMEOUT;
@@ -579,6 +578,11 @@ static void NANO_IP_TFTP_TimerCallback(oal_timer_t* const timer, void* const use
             /* End of transfer */
             NANO_IP_TFTP_EndOfTransfer(tftp_module);
         }
+        else
+        {
+            /* A packet has been received in the meantime, wait for the remaining time */
+            (void)NANO_IP_TIMER_Start(timer, tftp_module->timeout - elapsed);
+        }
     }
 }
 
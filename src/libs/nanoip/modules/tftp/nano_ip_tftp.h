@@ -27,6 +27,7 @@ along with Nano-IP.  If not, see <http://www.gnu.org/licenses/>.
 #include "nano_ip_types.h"
 #include "nano_ip_oal.h"
 #include "nano_ip_udp.h"
+#include "nano_ip_timer.h"
 
 
 
@@ -165,7 +166,7 @@ typedef struct _nano_ip_tftp_t
     /** \brief Indicate if a transfert is in progress */
     nano_ip_tftp_req_type_t req_type;
     /** \brief Timer */
-    oal_timer_t timer;
+    nano_ip_timer_t timer;
     /** \brief Timestamp of the last received packet */
     uint32_t last_rx_packet_timestamp;
     /** \brief Timeout in milliseconds */
@@ -43,6 +43,8 @@ static nano_ip_error_t NANO_IP_LOCALHOST_GetNextRxPacket(void* const user_data,
 static nano_ip_error_t NANO_IP_LOCALHOST_GetNextTxPacket(void* const user_data, nano_ip_net_packet_t** const packet);
 /** \brief Get the link state of the localhost interface driver */
 static nano_ip_error_t NANO_IP_LOCALHOST_DrvGetLinkState(void* const user_data, net_link_state_t* const state);
+/** \brief Enable or disable the reception notifications of the localhost interface driver */
+static nano_ip_error_t NANO_IP_LOCALHOST_DrvSetRxNotification(void* const user_data, const bool enabled);
 
 
 /** \brief Localhost interface driver */
@@ -59,7 +61,14 @@ static const nano_ip_net_driver_t localhost_driver = {
                                                     NANO_IP_LOCALHOST_DrvAddRxPacket,
                                                     NANO_IP_LOCALHOST_GetNextRxPacket,
                                                     NANO_IP_LOCALHOST_GetNextTxPacket,
-                                                    NANO_IP_LOCALHOST_DrvGetLinkState
+                                                    NANO_IP_LOCALHOST_DrvGetLinkState,
+                                                    NULL, /* send_packets() */
+                                                    NULL, /* add_rx_packets() */
+                                                    NULL, /* get_next_rx_packets() */
+                                                    NULL, /* get_next_tx_packets() */
+                                                    NANO_IP_LOCALHOST_DrvSetRxNotification,
+                                                    NULL, /* poll() */
+                                                    NULL /* get_poll_handle() */
                                              };
 
 
@@ -125,17 +134,23 @@ static nano_ip_error_t NANO_IP_LOCALHOST_DrvSendPacket(void* const user_data, na
     /* Check parameters */
     if ((localhost_drv_inst != NULL) && (packet != NULL))
     {
+        bool notify_rx;
+
         /* Lock interface */
         (void)NANO_IP_OAL_MUTEX_Lock(&localhost_drv_inst->mutex);
 
         /* Add packet to the received packet list */
         NANO_IP_PACKET_AddToQueue(localhost_drv_inst->received_packets, packet);
+        notify_rx = !localhost_drv_inst->rx_notification_disabled;
 
         /* Unlock interface */
         (void)NANO_IP_OAL_MUTEX_Unlock(&localhost_drv_inst->mutex);
 
         /* Notify packet reception */
-        localhost_drv_inst->callbacks.packet_received(localhost_drv_inst->callbacks.stack_data, false);
+        if (notify_rx)
+        {
+            localhost_drv_inst->callbacks.packet_received(localhost_drv_inst->callbacks.stack_data, false);
+        }
 
         /* Notify packet transmission */
         localhost_drv_inst->callbacks.packet_sent(localhost_drv_inst->callbacks.stack_data, false);
@@ -211,4 +226,22 @@ static nano_ip_error_t NANO_IP_LOCALHOST_DrvGetLinkState(void* const user_data,
     return ret;
 }
 
+/** \brief Enable or disable the reception notifications of the localhost interface driver */
+static nano_ip_error_t NANO_IP_LOCALHOST_DrvSetRxNotification(void* const user_data, const bool enabled)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+    localhost_drv_t* localhost_drv_inst = NANO_IP_CAST(localhost_drv_t*, user_data);
+
+    /* Check parameters */
+    if (localhost_drv_inst != NULL)
+    {
+        (void)NANO_IP_OAL_MUTEX_Lock(&localhost_drv_inst->mutex);
+        localhost_drv_inst->rx_notification_disabled = !enabled;
+        (void)NANO_IP_OAL_MUTEX_Unlock(&localhost_drv_inst->mutex);
+        ret = NIP_ERR_SUCCESS;
+    }
+
+    return ret;
+}
+
 #endif /* NANO_IP_ENABLE_LOCALHOST */
@@ -41,6 +41,8 @@ typedef struct _localhost_drv_t
     nano_ip_packet_queue_t* received_packets;
     /** \brief Interface's mutex */
     oal_mutex_t mutex;
+    /** \brief Indicate if the reception notifications are disabled */
+    bool rx_notification_disabled;
 } localhost_drv_t;
 
 /** \brief Localhost module internal data */
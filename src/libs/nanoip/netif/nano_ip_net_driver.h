@@ -22,7 +22,9 @@ along with Nano-IP.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "nano_ip_error.h"
 #include "nano_ip_packet_allocator.h"
+#include "nano_ip_packet_funcs.h"
 #include "nano_ip_ipv4_def.h"
+#include "nano_ip_oal.h"
 
 /*    Network drivers capabilities */
 
@@ -63,6 +65,9 @@ along with Nano-IP.  If not, see <http://www.gnu.org/licenses/>.
 /** \brief UDP/IPv4 checksum verification */
 #define NETDRV_CAP_UDPIPV4_CS_CHECK             2048u
 
+/** \brief Transmission of packets with chained payload segments (otherwise the stack linearizes them) */
+#define NETDRV_CAP_TX_GATHER                    4096u
+
 
 #ifdef __cplusplus
 extern "C"
@@ -161,10 +166,133 @@ typedef struct _nano_ip_net_driver_t
     nano_ip_error_t(*get_next_tx_packet)(void* const user_data, nano_ip_net_packet_t** const packet);
     /** \brief Get the link state*/
     nano_ip_error_t (*get_link_state)(void* const user_data, net_link_state_t* const state);
+
+    /** \brief Send a queue of packets (optional, the queue is emptied) */
+    nano_ip_error_t (*send_packets)(void* const user_data, nano_ip_packet_queue_t* const packets);
+    /** \brief Add a queue of packets for reception (optional, the queue is emptied) */
+    nano_ip_error_t (*add_rx_packets)(void* const user_data, nano_ip_packet_queue_t* const packets);
+    /** \brief Append up to max_count received packets to a queue (optional) */
+    nano_ip_error_t (*get_next_rx_packets)(void* const user_data, nano_ip_packet_queue_t* const packets, const uint32_t max_count);
+    /** \brief Append up to max_count sent packets to a queue (optional) */
+    nano_ip_error_t (*get_next_tx_packets)(void* const user_data, nano_ip_packet_queue_t* const packets, const uint32_t max_count);
+    /** \brief Enable or disable the packet_received() notifications (optional, received packets are still queued while disabled) */
+    nano_ip_error_t (*set_rx_notification)(void* const user_data, const bool enabled);
+    /** \brief Process the driver events in the caller's context (optional, run-to-completion mode: the driver then has no task of its own) */
+    nano_ip_error_t (*poll)(void* const user_data);
+    /** \brief Get the handle which becomes ready when poll() has events to process (optional, run-to-completion mode) */
+    nano_ip_error_t (*get_poll_handle)(void* const user_data, oal_poll_handle_t* const handle);
 } nano_ip_net_driver_t;
 
 
 
+/** \brief Send a queue of packets, the queue is emptied (uses send_packet() if the driver has no send_packets() operation) */
+static inline nano_ip_error_t NANO_IP_NET_DRIVER_SendPackets(const nano_ip_net_driver_t* const driver, nano_ip_packet_queue_t* const packets)
+{
+    nano_ip_error_t ret = NIP_ERR_SUCCESS;
+    if (driver->send_packets != NULL)
+    {
+        ret = driver->send_packets(driver->user_data, packets);
+    }
+    else
+    {
+        /* Each packet is handed to the driver as with individual calls, the first error is reported */
+        nano_ip_net_packet_t* packet = NANO_IP_PACKET_PopFromQueue(packets);
+        while (packet != NULL)
+        {
+            const nano_ip_error_t err = driver->send_packet(driver->user_data, packet);
+            if (ret == NIP_ERR_SUCCESS)
+            {
+                ret = err;
+            }
+            packet = NANO_IP_PACKET_PopFromQueue(packets);
+        }
+    }
+    return ret;
+}
+
+/** \brief Add a queue of packets for reception, the queue is emptied (uses add_rx_packet() if the driver has no add_rx_packets() operation) */
+static inline nano_ip_error_t NANO_IP_NET_DRIVER_AddRxPackets(const nano_ip_net_driver_t* const driver, nano_ip_packet_queue_t* const packets)
+{
+    nano_ip_error_t ret = NIP_ERR_SUCCESS;
+    if (driver->add_rx_packets != NULL)
+    {
+        ret = driver->add_rx_packets(driver->user_data, packets);
+    }
+    else
+    {
+        nano_ip_net_packet_t* packet = NANO_IP_PACKET_PopFromQueue(packets);
+        while (packet != NULL)
+        {
+            const nano_ip_error_t err = driver->add_rx_packet(driver->user_data, packet);
+            if (ret == NIP_ERR_SUCCESS)
+            {
+                ret = err;
+            }
+            packet = NANO_IP_PACKET_PopFromQueue(packets);
+        }
+    }
+    return ret;
+}
+
+/** \brief Append up to max_count received packets to a queue, returns NIP_ERR_PACKET_NOT_FOUND if no packet has been received
+           (uses get_next_rx_packet() if the driver has no get_next_rx_packets() operation) */
+static inline nano_ip_error_t NANO_IP_NET_DRIVER_GetNextRxPackets(const nano_ip_net_driver_t* const driver, nano_ip_packet_queue_t* const packets, const uint32_t max_count)
+{
+    nano_ip_error_t ret = NIP_ERR_PACKET_NOT_FOUND;
+    if (driver->get_next_rx_packets != NULL)
+    {
+        ret = driver->get_next_rx_packets(driver->user_data, packets, max_count);
+    }
+    else
+    {
+        uint32_t count = 0u;
+        nano_ip_net_packet_t* packet = NULL;
+        while ((count < max_count) && (driver->get_next_rx_packet(driver->user_data, &packet) == NIP_ERR_SUCCESS))
+        {
+            NANO_IP_PACKET_AddToQueue(packets, packet);
+            ret = NIP_ERR_SUCCESS;
+            count++;
+        }
+    }
+    return ret;
+}
+
+/** \brief Append up to max_count sent packets to a queue, returns NIP_ERR_PACKET_NOT_FOUND if no packet has been sent
+           (uses get_next_tx_packet() if the driver has no get_next_tx_packets() operation) */
+static inline nano_ip_error_t NANO_IP_NET_DRIVER_GetNextTxPackets(const nano_ip_net_driver_t* const driver, nano_ip_packet_queue_t* const packets, const uint32_t max_count)
+{
+    nano_ip_error_t ret = NIP_ERR_PACKET_NOT_FOUND;
+    if (driver->get_next_tx_packets != NULL)
+    {
+        ret = driver->get_next_tx_packets(driver->user_data, packets, max_count);
+    }
+    else
+    {
+        uint32_t count = 0u;
+        nano_ip_net_packet_t* packet = NULL;
+        while ((count < max_count) && (driver->get_next_tx_packet(driver->user_data, &packet) == NIP_ERR_SUCCESS))
+        {
+            NANO_IP_PACKET_AddToQueue(packets, packet);
+            ret = NIP_ERR_SUCCESS;
+            count++;
+        }
+    }
+    return ret;
+}
+
+/** \brief Enable or disable the reception notifications of a driver (no-op if the driver has no set_rx_notification() operation) */
+static inline nano_ip_error_t NANO_IP_NET_DRIVER_SetRxNotification(const nano_ip_net_driver_t* const driver, const bool enabled)
+{
+    nano_ip_error_t ret = NIP_ERR_SUCCESS;
+    if (driver->set_rx_notification != NULL)
+    {
+        ret = driver->set_rx_notification(driver->user_data, enabled);
+    }
+    return ret;
+}
+
+
+
 
 #ifdef __cplusplus
 }
@@ -40,13 +40,29 @@ typedef enum _nano_ip_net_if_event_flags_t
     /** \brief Link state changed */
     NETIF_LINK_STATE_CHANGED = 8u,
     /** \brief Periodic timer */
-    NETIF_PERIODIC_TIMER = 16u
+    NETIF_PERIODIC_TIMER = 16u,
+    /** \brief Reception mode changed */
+    NETIF_RX_MODE_CHANGED = 32u
 } nano_ip_net_if_event_flags_t;
 
 
 
+#if (NANO_IP_ENABLE_RUN_TO_COMPLETION == 0u)
 /** \brief Rx task */
 static void NANO_IP_NET_IF_RxTask(void* param);
+/** \brief Process the received packets according to the reception mode of a network interface */
+static void NANO_IP_NET_IF_RxPoll(nano_ip_net_if_t* const net_if);
+#endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
+/** \brief Process up to max_count received packets, returns the number of processed packets */
+static uint32_t NANO_IP_NET_IF_ProcessRxPackets(nano_ip_net_if_t* const net_if, const uint32_t max_count);
+/** \brief Apply the reception mode requested for a network interface */
+static void NANO_IP_NET_IF_ApplyRxMode(nano_ip_net_if_t* const net_if);
+/** \brief Decode received packets under a single stack lock and give them back to the driver */
+static void NANO_IP_NET_IF_DecodeRxPackets(nano_ip_net_if_t* const net_if, nano_ip_packet_queue_t* const rx_packets);
+/** \brief Release the packets which have been sent by the driver */
+static void NANO_IP_NET_IF_ReleaseTxPackets(nano_ip_net_if_t* const net_if);
+/** \brief Update the link state of a network interface from its driver */
+static void NANO_IP_NET_IF_CheckLinkState(nano_ip_net_if_t* const net_if);
 
 /** \brief Called when a packet has been received */
 static void NANO_IP_NET_IF_PacketReceivedCallback(void* const stack_data, const bool from_isr);
@@ -56,8 +72,10 @@ static void NANO_IP_NET_IF_PacketSentCallback(void* const stack_data, const bool
 static void NANO_IP_NET_IF_NetDrvErrorCallback(void* const stack_data, const bool from_isr);
 /** \brief Called when the link state has changed */
 static void NANO_IP_NET_IF_LinkStateChangedCallback(void* const stack_data, const bool from_isr);
+/** \brief Notify a driver event to a network interface */
+static void NANO_IP_NET_IF_NotifyEvent(nano_ip_net_if_t* const net_if, const uint32_t event, const bool from_isr);
 /** \brief Called when the periodic timer has elapsed */
-static void NANO_IP_NET_IF_PeriodicTimerCallback(oal_timer_t* const timer, void* const user_data);
+static void NANO_IP_NET_IF_PeriodicTimerCallback(nano_ip_timer_t* const timer, void* const user_data);
 
 
 /** \brief Initialize a network interface */
@@ -78,6 +96,10 @@ nano_ip_error_t NANO_IP_NET_IF_Init(nano_ip_net_if_t* const net_if, const char*
 
         /* Save name */
         net_if->name = name;
+
+        /* Default reception mode */
+        net_if->rx_mode = NETIF_RX_MODE_INTERRUPT;
+        net_if->rx_poll_budget = NANO_IP_NET_IF_RX_POLL_BUDGET;
         
         /* Create network interface synchronization flags */
         ret = NANO_IP_OAL_FLAGS_Create(&net_if->sync_flags);
@@ -85,7 +107,7 @@ nano_ip_error_t NANO_IP_NET_IF_Init(nano_ip_net_if_t* const net_if, const char*
         /* Create network interface timer */
         if (ret == NIP_ERR_SUCCESS)
         {
-            ret = NANO_IP_OAL_TIMER_Create(&net_if->timer, NANO_IP_NET_IF_PeriodicTimerCallback, net_if);
+            ret = NANO_IP_TIMER_InitializeTimer(&net_if->timer, NANO_IP_NET_IF_PeriodicTimerCallback, net_if);
         }
 
         /* Initialize network interface driver */
@@ -105,22 +127,41 @@ nano_ip_error_t NANO_IP_NET_IF_Init(nano_ip_net_if_t* const net_if, const char*
         {
             uint32_t i;
             nano_ip_net_packet_t* packet;
+            nano_ip_packet_queue_t rx_packets;
+            NANO_IP_PACKET_ResetQueue(&rx_packets);
             for (i = 0; (i < rx_packet_count) && (ret == NIP_ERR_SUCCESS); i++)
             {
                 ret = g_nano_ip.packet_allocator->allocate(g_nano_ip.packet_allocator->allocator_data, &packet, rx_packet_size);
                 if (ret == NIP_ERR_SUCCESS)
                 {
                     packet->flags = NET_IF_PACKET_FLAG_RX;
-                    ret = net_if->driver->add_rx_packet(net_if->driver->user_data, packet);
+                    NANO_IP_PACKET_AddToQueue(&rx_packets, packet);
                 }
             }
+            if (ret == NIP_ERR_SUCCESS)
+            {
+                ret = NANO_IP_NET_DRIVER_AddRxPackets(net_if->driver, &rx_packets);
+            }
         }
 
+        #if (NANO_IP_ENABLE_RUN_TO_COMPLETION != 0u)
+        /* Wake up the stack poll when the driver has events to process */
+        if ((ret == NIP_ERR_SUCCESS) && (net_if->driver->get_poll_handle != NULL))
+        {
+            oal_poll_handle_t handle;
+            ret = net_if->driver->get_poll_handle(net_if->driver->user_data, &handle);
+            if (ret == NIP_ERR_SUCCESS)
+            {
+                ret = NANO_IP_OAL_POLL_AddHandle(&g_nano_ip.poll, handle);
+            }
+        }
+        #else
         /* Create the Rx task */
         if (ret == NIP_ERR_SUCCESS)
         {
             ret = NANO_IP_OAL_TASK_Create(&net_if->task, "NanoIP NANO_IP_NET_IF_RxTask()", NANO_IP_NET_IF_RxTask, net_if);
         }
+        #endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
 
     }
 
@@ -140,7 +181,7 @@ nano_ip_error_t NANO_IP_NET_IF_Up(nano_ip_net_if_t* const net_if)
         if (ret == NIP_ERR_SUCCESS)
         {
             /* Start the timer */
-            ret = NANO_IP_OAL_TIMER_Start(&net_if->timer, NET_IF_PERIODIC_TASK_PERIOD);
+            ret = NANO_IP_TIMER_Start(&net_if->timer, NET_IF_PERIODIC_TASK_PERIOD);
         }
     }
 
@@ -160,7 +201,7 @@ nano_ip_error_t NANO_IP_NET_IF_Down(nano_ip_net_if_t* const net_if)
         if (ret == NIP_ERR_SUCCESS)
         {
             /* Stop the timer */
-            ret = NANO_IP_OAL_TIMER_Stop(&net_if->timer);
+            ret = NANO_IP_TIMER_Stop(&net_if->timer);
         }
     }
 
@@ -210,6 +251,85 @@ nano_ip_error_t NANO_IP_NET_IF_SetIpv4Address(nano_ip_net_if_t* const net_if, co
     return ret;
 }
 
+/** \brief Set the reception mode of a network interface */
+nano_ip_error_t NANO_IP_NET_IF_SetRxMode(nano_ip_net_if_t* const net_if, const nano_ip_net_if_rx_mode_t rx_mode, const uint32_t poll_budget)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+
+    /* Check parameters */
+    if ((net_if != NULL) && 
+        ((rx_mode == NETIF_RX_MODE_INTERRUPT) || ((rx_mode == NETIF_RX_MODE_ADAPTIVE) && (poll_budget != 0u))))
+    {
+        /* Save the requested mode */
+        (void)NANO_IP_OAL_MUTEX_Lock(&g_nano_ip.mutex);
+        net_if->rx_mode_request = rx_mode;
+        net_if->rx_poll_budget_request = poll_budget;
+        (void)NANO_IP_OAL_MUTEX_Unlock(&g_nano_ip.mutex);
+
+        /* The interface task applies it between two reception rounds since 
+           it may be polling the driver with its notifications masked */
+        ret = NANO_IP_OAL_FLAGS_Set(&net_if->sync_flags, NETIF_RX_MODE_CHANGED, false);
+    }
+
+    return ret;
+}
+
+#if (NANO_IP_ENABLE_RUN_TO_COMPLETION != 0u)
+
+/** \brief Process the pending events of a network interface in the caller's context, returns the number of processed received packets (at most budget) */
+uint32_t NANO_IP_NET_IF_Poll(nano_ip_net_if_t* const net_if, const uint32_t budget)
+{
+    uint32_t count = 0u;
+
+    /* Check parameters */
+    if (net_if != NULL)
+    {
+        uint32_t flags = NANO_IP_OAL_FLAGS_ALL;
+        nano_ip_error_t ret;
+
+        /* Let the driver process its events, it notifies them through the callbacks */
+        if (net_if->driver->poll != NULL)
+        {
+            net_if->driver_polling = true;
+            (void)net_if->driver->poll(net_if->driver->user_data);
+            net_if->driver_polling = false;
+        }
+
+        /* Get the pending network interface events without waiting */
+        ret = NANO_IP_OAL_FLAGS_Wait(&net_if->sync_flags, &flags, true, 0u);
+        if (ret == NIP_ERR_SUCCESS)
+        {
+            if ((flags & NETIF_RX_MODE_CHANGED) != 0u)
+            {
+                /* Reception mode changed */
+                NANO_IP_NET_IF_ApplyRxMode(net_if);
+            }
+            if ((flags & NETIF_PACKET_RECEIVED) != 0u)
+            {
+                /* Packets received, keep the event pending if the budget has been exhausted */
+                count = NANO_IP_NET_IF_ProcessRxPackets(net_if, budget);
+                if (count == budget)
+                {
+                    (void)NANO_IP_OAL_FLAGS_Set(&net_if->sync_flags, NETIF_PACKET_RECEIVED, false);
+                }
+            }
+            if ((flags & NETIF_PACKET_SENT) != 0u)
+            {
+                /* Packets sent */
+                NANO_IP_NET_IF_ReleaseTxPackets(net_if);
+            }
+            if ((flags & (NETIF_LINK_STATE_CHANGED | NETIF_PERIODIC_TIMER)) != 0u)
+            {
+                /* Link state event or periodic link state polling */
+                NANO_IP_NET_IF_CheckLinkState(net_if);
+            }
+        }
+    }
+
+    return count;
+}
+
+#else
 
 /** \brief Rx task */
 static void NANO_IP_NET_IF_RxTask(void* param)
@@ -226,67 +346,26 @@ static void NANO_IP_NET_IF_RxTask(void* param)
             uint32_t flags = NANO_IP_OAL_FLAGS_ALL;
             bool check_link_state = false;
 
-            /* Wait for a network interface event */
-            nano_ip_error_t ret = NANO_IP_OAL_FLAGS_Wait(&net_if->sync_flags, &flags, true, NANO_IP_MAX_TIMEOUT_VALUE);
-            if (ret == NIP_ERR_SUCCESS)
+            /* Wait for a network interface event (only check for pending events while polling the driver) */
+            const uint32_t timeout = (net_if->rx_polling ? 0u : NANO_IP_MAX_TIMEOUT_VALUE);
+            nano_ip_error_t ret = NANO_IP_OAL_FLAGS_Wait(&net_if->sync_flags, &flags, true, timeout);
+            if ((ret == NIP_ERR_SUCCESS) || net_if->rx_polling)
             {
                 /* Check flags */
-                if ((flags & NETIF_PACKET_RECEIVED) != 0u)
+                if ((flags & NETIF_RX_MODE_CHANGED) != 0u)
+                {
+                    /* Reception mode changed */
+                    NANO_IP_NET_IF_ApplyRxMode(net_if);
+                }
+                if (((flags & NETIF_PACKET_RECEIVED) != 0u) || net_if->rx_polling)
                 {
-                    /* Packet received */
-                    nano_ip_net_packet_t* packet = NULL;
-                    do
-                    {
-                        /* Get received packet */
-                        ret = net_if->driver->get_next_rx_packet(net_if->driver->user_data, &packet);
-                        if (ret == NIP_ERR_SUCCESS)
-                        {
-                            /* Decode packet */
-                            packet->net_if = net_if;
-                            if ((packet->flags & NET_IF_PACKET_FLAG_ERROR) == 0u)
-                            {
-                                (void)NANO_IP_OAL_MUTEX_Lock(&g_nano_ip.mutex);
-                                (void)NANO_IP_ETHERNET_RxFrame(net_if, packet);
-                                (void)NANO_IP_OAL_MUTEX_Unlock(&g_nano_ip.mutex);
-                            }
-
-                            /* Check if packet is still in use */
-                            if ((packet->flags & NET_IF_PACKET_FLAG_KEEP_PACKET) == 0u)
-                            {
-                                if ((packet->flags & NET_IF_PACKET_FLAG_TX) == 0u)
-                                {
-                                    /* Requeue packet for reception */
-                                    packet->flags = NET_IF_PACKET_FLAG_RX;
-                                    packet->current = NANO_IP_CAST(uint8_t*, packet->data);
-                                    (void)net_if->driver->add_rx_packet(net_if->driver->user_data, packet);
-                                }
-                                else
-                                {
-                                    /* Release packet */
-                                    (void)g_nano_ip.packet_allocator->release(g_nano_ip.packet_allocator->allocator_data, packet);
-                                }
-                            }
-                        }
-                    } while (ret == NIP_ERR_SUCCESS);
+                    /* Packets received */
+                    NANO_IP_NET_IF_RxPoll(net_if);
                 }
                 if ((flags & NETIF_PACKET_SENT) != 0u)
                 {
-                    /* Packet sent */
-                    nano_ip_net_packet_t* packet = NULL;
-                    do
-                    {
-                        /* Get sent packet */
-                        ret = net_if->driver->get_next_tx_packet(net_if->driver->user_data, &packet);
-                        if (ret == NIP_ERR_SUCCESS)
-                        {
-                            /* Release packet */
-                            if ((packet->flags & NET_IF_PACKET_FLAG_KEEP_PACKET) == 0u)
-                            {
-                                ret = g_nano_ip.packet_allocator->release(g_nano_ip.packet_allocator->allocator_data, packet);
-                            }
-                        }
-                    } 
-                    while (ret == NIP_ERR_SUCCESS);
+                    /* Packets sent */
+                    NANO_IP_NET_IF_ReleaseTxPackets(net_if);
                 }
                 if ((flags & NETIF_DRV_ERROR) != 0u)
                 {
@@ -299,26 +378,14 @@ static void NANO_IP_NET_IF_RxTask(void* param)
                 }
                 if ((flags & NETIF_PERIODIC_TIMER) != 0u)
                 {
-                    /* Periodic timer */
-                    (void)NANO_IP_OAL_MUTEX_Lock(&g_nano_ip.mutex);
-                    ret = NANO_IP_ETHERNET_PeriodicTask();
-                    (void)NANO_IP_OAL_MUTEX_Unlock(&g_nano_ip.mutex);
+                    /* Periodic timer : link state polling, protocol timeouts are handled by the stack timers */
                     check_link_state = true;
                 }
                 
                 /* Check link state */
                 if (check_link_state)
                 {
-                    net_link_state_t link_state = NLS_DOWN;
-                    ret = net_if->driver->get_link_state(net_if->driver->user_data, &link_state);
-                    if (ret == NIP_ERR_SUCCESS)
-                    {
-                        if (link_state != net_if->link_state)
-                        {
-                            NANO_IP_LOG_INFO("[%s] : link state => %d", net_if->name, link_state);
-                            net_if->link_state = link_state;
-                        }
-                    }
+                    NANO_IP_NET_IF_CheckLinkState(net_if);
                 }
             }
         }
@@ -326,6 +393,173 @@ static void NANO_IP_NET_IF_RxTask(void* param)
 }
 
 
+/** \brief Process the received packets according to the reception mode of a network interface */
+static void NANO_IP_NET_IF_RxPoll(nano_ip_net_if_t* const net_if)
+{
+    bool drained = true;
+
+    if (net_if->rx_mode == NETIF_RX_MODE_ADAPTIVE)
+    {
+        /* Process at most a budget of packets so that the other events are not delayed under load */
+        const uint32_t budget = net_if->rx_poll_budget;
+        if (NANO_IP_NET_IF_ProcessRxPackets(net_if, budget) == budget)
+        {
+            /* Budget exhausted, the interface is under load: mask the driver notifications and keep on polling */
+            if (!net_if->rx_polling)
+            {
+                (void)NANO_IP_NET_DRIVER_SetRxNotification(net_if->driver, false);
+                net_if->rx_polling = true;
+            }
+            drained = false;
+        }
+    }
+    else
+    {
+        /* Process all the received packets */
+        (void)NANO_IP_NET_IF_ProcessRxPackets(net_if, 0xFFFFFFFFu);
+    }
+
+    /* Driver drained while polling: re-arm its notifications */
+    if (drained && net_if->rx_polling)
+    {
+        net_if->rx_polling = false;
+        (void)NANO_IP_NET_DRIVER_SetRxNotification(net_if->driver, true);
+
+        /* Packets received between the last poll and the re-arm have not been notified */
+        (void)NANO_IP_OAL_FLAGS_Set(&net_if->sync_flags, NETIF_PACKET_RECEIVED, false);
+    }
+}
+
+#endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
+
+/** \brief Apply the reception mode requested for a network interface */
+static void NANO_IP_NET_IF_ApplyRxMode(nano_ip_net_if_t* const net_if)
+{
+    (void)NANO_IP_OAL_MUTEX_Lock(&g_nano_ip.mutex);
+    net_if->rx_mode = net_if->rx_mode_request;
+    net_if->rx_poll_budget = net_if->rx_poll_budget_request;
+    (void)NANO_IP_OAL_MUTEX_Unlock(&g_nano_ip.mutex);
+
+    /* Leaving the adaptive mode while polling the driver: re-arm its notifications */
+    if ((net_if->rx_mode != NETIF_RX_MODE_ADAPTIVE) && net_if->rx_polling)
+    {
+        net_if->rx_polling = false;
+        (void)NANO_IP_NET_DRIVER_SetRxNotification(net_if->driver, true);
+
+        /* Packets received while polling have not been notified */
+        (void)NANO_IP_OAL_FLAGS_Set(&net_if->sync_flags, NETIF_PACKET_RECEIVED, false);
+    }
+}
+
+/** \brief Process up to max_count received packets, returns the number of processed packets */
+static uint32_t NANO_IP_NET_IF_ProcessRxPackets(nano_ip_net_if_t* const net_if, const uint32_t max_count)
+{
+    nano_ip_error_t ret;
+    uint32_t count = 0u;
+    nano_ip_packet_queue_t rx_packets;
+    NANO_IP_PACKET_ResetQueue(&rx_packets);
+    do
+    {
+        /* Get a burst of received packets */
+        uint32_t burst_size = max_count - count;
+        if (burst_size > NANO_IP_NET_IF_BURST_SIZE)
+        {
+            burst_size = NANO_IP_NET_IF_BURST_SIZE;
+        }
+        ret = NANO_IP_NET_DRIVER_GetNextRxPackets(net_if->driver, &rx_packets, burst_size);
+        if (ret == NIP_ERR_SUCCESS)
+        {
+            const nano_ip_net_packet_t* packet = rx_packets.head;
+            while (packet != NULL)
+            {
+                count++;
+                packet = packet->next;
+            }
+
+            /* Decode the burst */
+            NANO_IP_NET_IF_DecodeRxPackets(net_if, &rx_packets);
+        }
+    }
+    while ((ret == NIP_ERR_SUCCESS) && (count < max_count));
+
+    return count;
+}
+
+/** \brief Decode received packets under a single stack lock and give them back to the driver */
+static void NANO_IP_NET_IF_DecodeRxPackets(nano_ip_net_if_t* const net_if, nano_ip_packet_queue_t* const rx_packets)
+{
+    nano_ip_packet_queue_t free_rx_packets;
+    nano_ip_net_packet_t* packet = NANO_IP_PACKET_PopFromQueue(rx_packets);
+    NANO_IP_PACKET_ResetQueue(&free_rx_packets);
+
+    /* Decode the whole burst under a single lock */
+    (void)NANO_IP_OAL_MUTEX_Lock(&g_nano_ip.mutex);
+    while (packet != NULL)
+    {
+        packet->net_if = net_if;
+        if ((packet->flags & NET_IF_PACKET_FLAG_ERROR) == 0u)
+        {
+            (void)NANO_IP_ETHERNET_RxFrame(net_if, packet);
+        }
+
+        /* Drop the reception reference, the packet is requeued once the upper layers have dropped theirs */
+        packet->flags &= ~NET_IF_PACKET_FLAG_TX_PENDING;
+        if (NANO_IP_PACKET_RecycleRx(packet))
+        {
+            NANO_IP_PACKET_AddToQueue(&free_rx_packets, packet);
+        }
+        packet = NANO_IP_PACKET_PopFromQueue(rx_packets);
+    }
+    (void)NANO_IP_OAL_MUTEX_Unlock(&g_nano_ip.mutex);
+
+    /* Give the packets back to the driver for reception */
+    (void)NANO_IP_NET_DRIVER_AddRxPackets(net_if->driver, &free_rx_packets);
+}
+
+/** \brief Release the packets which have been sent by the driver */
+static void NANO_IP_NET_IF_ReleaseTxPackets(nano_ip_net_if_t* const net_if)
+{
+    nano_ip_error_t ret;
+    nano_ip_packet_queue_t tx_packets;
+    NANO_IP_PACKET_ResetQueue(&tx_packets);
+    do
+    {
+        /* Get a burst of sent packets */
+        ret = NANO_IP_NET_DRIVER_GetNextTxPackets(net_if->driver, &tx_packets, NANO_IP_NET_IF_BURST_SIZE);
+        if (ret == NIP_ERR_SUCCESS)
+        {
+            /* Drop the transmission references (a packet is freed unless its owner keeps a reference, ex: for retransmission).
+               The stack lock is needed: the packet flags are shared with their owner and freeing a packet
+               calls the release callbacks of its payload segments */
+            nano_ip_net_packet_t* packet = NANO_IP_PACKET_PopFromQueue(&tx_packets);
+            (void)NANO_IP_OAL_MUTEX_Lock(&g_nano_ip.mutex);
+            while (packet != NULL)
+            {
+                packet->flags &= ~NET_IF_PACKET_FLAG_TX_PENDING;
+                (void)g_nano_ip.packet_allocator->release(g_nano_ip.packet_allocator->allocator_data, packet);
+                packet = NANO_IP_PACKET_PopFromQueue(&tx_packets);
+            }
+            (void)NANO_IP_OAL_MUTEX_Unlock(&g_nano_ip.mutex);
+        }
+    } 
+    while (ret == NIP_ERR_SUCCESS);
+}
+
+/** \brief Update the link state of a network interface from its driver */
+static void NANO_IP_NET_IF_CheckLinkState(nano_ip_net_if_t* const net_if)
+{
+    net_link_state_t link_state = NLS_DOWN;
+    const nano_ip_error_t ret = net_if->driver->get_link_state(net_if->driver->user_data, &link_state);
+    if (ret == NIP_ERR_SUCCESS)
+    {
+        if (link_state != net_if->link_state)
+        {
+            NANO_IP_LOG_INFO("[%s] : link state => %d", net_if->name, link_state);
+            net_if->link_state = link_state;
+        }
+    }
+}
+
 /** \brief Called when a packet has been received */
 static void NANO_IP_NET_IF_PacketReceivedCallback(void* const stack_data, const bool from_isr)
 {
@@ -334,7 +568,7 @@ static void NANO_IP_NET_IF_PacketReceivedCallback(void* const stack_data, const
     /* Check parameters */
     if (net_if != NULL)
     {
-        (void)NANO_IP_OAL_FLAGS_Set(&net_if->sync_flags, NETIF_PACKET_RECEIVED, from_isr);
+        NANO_IP_NET_IF_NotifyEvent(net_if, NETIF_PACKET_RECEIVED, from_isr);
     }
 }
 
@@ -346,7 +580,7 @@ static void NANO_IP_NET_IF_PacketSentCallback(void* const stack_data, const bool
     /* Check parameters */
     if (net_if != NULL)
     {
-        (void)NANO_IP_OAL_FLAGS_Set(&net_if->sync_flags, NETIF_PACKET_SENT, from_isr);
+        NANO_IP_NET_IF_NotifyEvent(net_if, NETIF_PACKET_SENT, from_isr);
     }
 }
 
@@ -358,7 +592,7 @@ static void NANO_IP_NET_IF_NetDrvErrorCallback(void* const stack_data, const boo
     /* Check parameters */
     if (net_if != NULL)
     {
-        (void)NANO_IP_OAL_FLAGS_Set(&net_if->sync_flags, NETIF_DRV_ERROR, from_isr);
+        NANO_IP_NET_IF_NotifyEvent(net_if, NETIF_DRV_ERROR, from_isr);
     }
 }
 
@@ -370,19 +604,34 @@ static void NANO_IP_NET_IF_LinkStateChangedCallback(void* const stack_data, cons
     /* Check parameters */
     if (net_if != NULL)
     {
-        (void)NANO_IP_OAL_FLAGS_Set(&net_if->sync_flags, NETIF_LINK_STATE_CHANGED, from_isr);
+        NANO_IP_NET_IF_NotifyEvent(net_if, NETIF_LINK_STATE_CHANGED, from_isr);
+    }
+}
+
+/** \brief Notify a driver event to a network interface */
+static void NANO_IP_NET_IF_NotifyEvent(nano_ip_net_if_t* const net_if, const uint32_t event, const bool from_isr)
+{
+    (void)NANO_IP_OAL_FLAGS_Set(&net_if->sync_flags, event, from_isr);
+
+    #if (NANO_IP_ENABLE_RUN_TO_COMPLETION != 0u)
+    /* Wake up the stack poll unless the event comes from the driver poll operation, the events are then processed right after it */
+    if (!net_if->driver_polling)
+    {
+        (void)NANO_IP_OAL_POLL_Signal(&g_nano_ip.poll);
     }
+    #endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
 }
 
 /** \brief Called when the periodic timer has elapsed */
-static void NANO_IP_NET_IF_PeriodicTimerCallback(oal_timer_t* const timer, void* const user_data)
+static void NANO_IP_NET_IF_PeriodicTimerCallback(nano_ip_timer_t* const timer, void* const user_data)
 {
     nano_ip_net_if_t* const net_if = NANO_IP_CAST(nano_ip_net_if_t*, user_data);
-    (void)timer;
 
     /* Check parameters */
     if (net_if != NULL)
     {
+        /* The stack timers are processed before the network interfaces in run-to-completion mode, no wake up is needed */
         (void)NANO_IP_OAL_FLAGS_Set(&net_if->sync_flags, NETIF_PERIODIC_TIMER, false);
+        (void)NANO_IP_TIMER_Start(timer, NET_IF_PERIODIC_TASK_PERIOD);
     }
 }
@@ -25,6 +25,7 @@ along with Nano-IP.  If not, see <http://www.gnu.org/licenses/>.
 #include "nano_ip_ipv4_def.h"
 #include "nano_ip_net_driver.h"
 #include "nano_ip_ethernet_def.h"
+#include "nano_ip_timer.h"
 
 
 
@@ -35,6 +36,16 @@ extern "C"
 
 
 
+/** \brief Network interface reception modes */
+typedef enum _nano_ip_net_if_rx_mode_t
+{
+    /** \brief Every driver notification wakes up the interface task which processes all the received packets */
+    NETIF_RX_MODE_INTERRUPT = 0u,
+    /** \brief Under load, driver notifications are masked and the interface task polls the driver until it is drained */
+    NETIF_RX_MODE_ADAPTIVE = 1u
+} nano_ip_net_if_rx_mode_t;
+
+
 /** \brief Network interface */
 typedef struct _nano_ip_net_if_t
 {
@@ -57,10 +68,25 @@ typedef struct _nano_ip_net_if_t
     /** \brief Synchronization flags */
     oal_flags_t sync_flags;
     /** \brief Periodic timer */
-    oal_timer_t timer;
+    nano_ip_timer_t timer;
     /** \brief Link state */
     net_link_state_t link_state;
 
+    /** \brief Reception mode */
+    nano_ip_net_if_rx_mode_t rx_mode;
+    /** \brief Maximum number of packets processed per polling round in adaptive reception mode */
+    uint32_t rx_poll_budget;
+    /** \brief Reception mode requested by the application, applied by the interface task */
+    nano_ip_net_if_rx_mode_t rx_mode_request;
+    /** \brief Polling budget requested by the application, applied by the interface task */
+    uint32_t rx_poll_budget_request;
+    /** \brief Indicate if the interface task is polling the driver with its reception notifications masked */
+    bool rx_polling;
+    #if (NANO_IP_ENABLE_RUN_TO_COMPLETION != 0u)
+    /** \brief Indicate that the driver events are being processed by its poll operation */
+    bool driver_polling;
+    #endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
+
     /** \brief Next interface */
     struct _nano_ip_net_if_t* next;
 } nano_ip_net_if_t;
@@ -84,6 +110,16 @@ nano_ip_error_t NANO_IP_NET_IF_SetMacAddress(nano_ip_net_if_t* const net_if, con
 /** \brief Set the IPv4 address of a network interface */
 nano_ip_error_t NANO_IP_NET_IF_SetIpv4Address(nano_ip_net_if_t* const net_if, const ipv4_address_t address, const ipv4_address_t netmask);
 
+/** \brief Set the reception mode of a network interface */
+nano_ip_error_t NANO_IP_NET_IF_SetRxMode(nano_ip_net_if_t* const net_if, const nano_ip_net_if_rx_mode_t rx_mode, const uint32_t poll_budget);
+
+#if (NANO_IP_ENABLE_RUN_TO_COMPLETION != 0u)
+
+/** \brief Process the pending events of a network interface in the caller's context, returns the number of processed received packets (at most budget) */
+uint32_t NANO_IP_NET_IF_Poll(nano_ip_net_if_t* const net_if, const uint32_t budget);
+
+#endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
+
 
 
 
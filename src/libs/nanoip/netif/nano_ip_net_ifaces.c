@@ -221,6 +221,35 @@ nano_ip_error_t NANO_IP_NET_IFACES_SetIpv4Address(const uint8_t iface, const ipv
     return ret;
 }
 
+/** \brief Set the reception mode of a network interface */
+nano_ip_error_t NANO_IP_NET_IFACES_SetRxMode(const uint8_t iface, const nano_ip_net_if_rx_mode_t rx_mode, const uint32_t poll_budget)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+    nano_ip_net_ifaces_module_data_t* const net_ifaces_module = &g_nano_ip.net_ifaces_module;
+
+    (void)NANO_IP_OAL_MUTEX_Lock(&g_nano_ip.mutex);
+
+    /* Check parameters */
+    if (iface < net_ifaces_module->net_ifaces_count)
+    {
+        /* Look for the network interface */
+        nano_ip_net_if_t* net_if = NANO_IP_NET_IF_LookForNetIf(iface);
+        if (net_if != NULL)
+        {
+            /* Set the reception mode */
+            ret = NANO_IP_NET_IF_SetRxMode(net_if, rx_mode, poll_budget);
+        }
+        else
+        {
+            ret = NIP_ERR_NETIF_NOT_FOUND;
+        }
+    }
+
+    (void)NANO_IP_OAL_MUTEX_Unlock(&g_nano_ip.mutex);
+
+    return ret;
+}
+
 /** \brief Look for a network interface */
 static nano_ip_net_if_t* NANO_IP_NET_IF_LookForNetIf(const uint8_t iface)
 {
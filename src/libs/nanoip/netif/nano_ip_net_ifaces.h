@@ -74,6 +74,9 @@ nano_ip_error_t NANO_IP_NET_IFACES_SetMacAddress(const uint8_t iface, const uint
 /** \brief Set the IPv4 address of a network interface */
 nano_ip_error_t NANO_IP_NET_IFACES_SetIpv4Address(const uint8_t iface, const ipv4_address_t address, const ipv4_address_t netmask, const ipv4_address_t gateway_address);
 
+/** \brief Set the reception mode of a network interface */
+nano_ip_error_t NANO_IP_NET_IFACES_SetRxMode(const uint8_t iface, const nano_ip_net_if_rx_mode_t rx_mode, const uint32_t poll_budget);
+
 
 #ifdef __cplusplus
 }
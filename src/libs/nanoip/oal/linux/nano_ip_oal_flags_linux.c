@@ -19,6 +19,16 @@ along with Nano-IP.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "nano_ip_oal_flags.h"
 
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <limits.h>
+#include <errno.h>
+
+
+/** \brief Futex system call */
+static long NANO_IP_OAL_FLAGS_Futex(uint32_t* const address, const int operation, const uint32_t value, const struct timespec* const timeout);
+
 
 /** \brief Create a synchronization flag */
 nano_ip_error_t NANO_IP_OAL_FLAGS_Create(oal_flags_t* const flags)
@@ -28,15 +38,9 @@ nano_ip_error_t NANO_IP_OAL_FLAGS_Create(oal_flags_t* const flags)
     /* Check parameters */
     if (flags != NULL)
     {
-    	ret = NIP_ERR_RESOURCE;
-        if (pthread_mutex_init(&flags->mutex, NULL) == 0)
-        {
-        	if (pthread_cond_init(&flags->cond_var, NULL) == 0)
-        	{
-        		flags->flags = 0u;
-				ret = NIP_ERR_SUCCESS;
-        	}
-        }
+        flags->flags = 0u;
+        flags->waiters = 0u;
+        ret = NIP_ERR_SUCCESS;
     }
 
     return ret;
@@ -50,8 +54,6 @@ nano_ip_error_t NANO_IP_OAL_FLAGS_Destroy(oal_flags_t* const flags)
     /* Check parameters */
     if (flags != NULL)
     {
-    	pthread_mutex_destroy(&flags->mutex);
-        pthread_cond_destroy(&flags->cond_var);
         flags->flags = 0u;
         ret = NIP_ERR_SUCCESS;
     }
@@ -67,9 +69,7 @@ nano_ip_error_t NANO_IP_OAL_FLAGS_Reset(oal_flags_t* const flags, const uint32_t
     /* Check parameters */
     if (flags != NULL)
     {
-		pthread_mutex_lock(&flags->mutex);
-        flags->flags &= ~(flag_mask);
-        pthread_mutex_unlock(&flags->mutex);
+        (void)__atomic_fetch_and(&flags->flags, ~(flag_mask), __ATOMIC_SEQ_CST);
         ret = NIP_ERR_SUCCESS;
     }
 
@@ -85,10 +85,18 @@ nano_ip_error_t NANO_IP_OAL_FLAGS_Set(oal_flags_t* const flags, const uint32_t f
     /* Check parameters */
     if (flags != NULL)
     {
-    	pthread_mutex_lock(&flags->mutex);
-        flags->flags |= flag_mask;
-        pthread_cond_broadcast(&flags->cond_var);
-        pthread_mutex_unlock(&flags->mutex);
+        const uint32_t previous_flags = __atomic_fetch_or(&flags->flags, flag_mask, __ATOMIC_SEQ_CST);
+
+        /* Enter the kernel only if the flags have changed and someone is waiting,
+           all the waiters are woken up only if there are several of them since they may wait for different flags */
+        if ((previous_flags | flag_mask) != previous_flags)
+        {
+            const uint32_t waiters = __atomic_load_n(&flags->waiters, __ATOMIC_SEQ_CST);
+            if (waiters != 0u)
+            {
+                (void)NANO_IP_OAL_FLAGS_Futex(&flags->flags, FUTEX_WAKE_PRIVATE, ((waiters == 1u) ? 1u : NANO_IP_CAST(uint32_t, INT_MAX)), NULL);
+            }
+        }
         ret = NIP_ERR_SUCCESS;
     }
 
@@ -103,45 +111,63 @@ nano_ip_error_t NANO_IP_OAL_FLAGS_Wait(oal_flags_t* const flags, uint32_t* const
     /* Check parameters */
     if ((flags != NULL) && (flag_mask != NULL))
     {
-        struct timespec abstimeout;
-        clock_gettime(CLOCK_REALTIME, &abstimeout);
-        abstimeout.tv_sec += NANO_IP_CAST(time_t, timeout / 1000u);
-        abstimeout.tv_nsec += NANO_IP_CAST(long, (timeout % 1000u) * 1000000u);
-        abstimeout.tv_sec += abstimeout.tv_nsec / 1000000;
-        abstimeout.tv_nsec = abstimeout.tv_nsec % 1000000;
-
-    	pthread_mutex_lock(&flags->mutex);
-        uint32_t active_flags;
+        bool deadline_valid = false;
+        bool timed_out = false;
+        struct timespec deadline;
+        uint32_t active_flags = 0u;
+
+        ret = NIP_ERR_IN_PROGRESS;
         do
         {
-            active_flags = flags->flags & (*flag_mask);
-            if (active_flags == 0u) 
+            /* Fast path : the flags are already set */
+            uint32_t current_flags = __atomic_load_n(&flags->flags, __ATOMIC_SEQ_CST);
+            active_flags = current_flags & (*flag_mask);
+            if (active_flags != 0u)
             {
-                if (pthread_cond_timedwait(&flags->cond_var, &flags->mutex, &abstimeout) == 0)
+                if (!reset_flags ||
+                    __atomic_compare_exchange_n(&flags->flags, &current_flags, (current_flags & ~(active_flags)), false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
                 {
                     ret = NIP_ERR_SUCCESS;
                 }
-                else
-                {
-                    ret = NIP_ERR_TIMEOUT;
-                }
             }
-            else
+            else if (timed_out)
             {
-                ret = NIP_ERR_SUCCESS;
+                /* The flags have been checked a last time after the deadline */
+                ret = NIP_ERR_TIMEOUT;
             }
-        }
-        while ((ret == NIP_ERR_SUCCESS) && (active_flags == 0u));
-        if (ret == NIP_ERR_SUCCESS)
-        {
-            if (reset_flags)
+            else
             {
-                flags->flags &= ~(active_flags);
+                /* The deadline is computed on the monotonic clock so that it is not affected by wall clock changes */
+                if (!deadline_valid)
+                {
+                    (void)clock_gettime(CLOCK_MONOTONIC, &deadline);
+                    deadline.tv_sec += NANO_IP_CAST(time_t, timeout / 1000u);
+                    deadline.tv_nsec += NANO_IP_CAST(long, (timeout % 1000u) * 1000000u);
+                    deadline.tv_sec += deadline.tv_nsec / 1000000000;
+                    deadline.tv_nsec = deadline.tv_nsec % 1000000000;
+                    deadline_valid = true;
+                }
+
+                /* Sleep until the flags word changes or the deadline is reached */
+                (void)__atomic_add_fetch(&flags->waiters, 1u, __ATOMIC_SEQ_CST);
+                if (NANO_IP_OAL_FLAGS_Futex(&flags->flags, FUTEX_WAIT_BITSET_PRIVATE, current_flags, &deadline) != 0)
+                {
+                    timed_out = (errno == ETIMEDOUT);
+                }
+                (void)__atomic_sub_fetch(&flags->waiters, 1u, __ATOMIC_SEQ_CST);
             }
         }
+        while (ret == NIP_ERR_IN_PROGRESS);
+
         (*flag_mask) = active_flags;
-        pthread_mutex_unlock(&flags->mutex);
     }
 
     return ret;
 }
+
+/** \brief Futex system call */
+static long NANO_IP_OAL_FLAGS_Futex(uint32_t* const address, const int operation, const uint32_t value, const struct timespec* const timeout)
+{
+    /* FUTEX_WAIT_BITSET takes an absolute CLOCK_MONOTONIC timeout */
+    return syscall(SYS_futex, address, operation, value, timeout, NULL, FUTEX_BITSET_MATCH_ANY);
+}
@@ -0,0 +1,183 @@
+/*
+Copyright(c) 2017 Cedric Jimenez
+
+This file is part of Nano-IP.
+
+Nano-IP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Nano-IP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with Nano-IP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "nano_ip_oal_poll.h"
+#include "nano_ip_tools.h"
+
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+
+/** \brief Create a poll set */
+nano_ip_error_t NANO_IP_OAL_POLL_Create(oal_poll_t* const poll)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+
+    /* Check parameters */
+    if (poll != NULL)
+    {
+        /* The timeout and the signals are a timer and an event file descriptors polled with the other handles */
+        ret = NIP_ERR_RESOURCE;
+        poll->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        poll->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        poll->event_fd = eventfd(0u, EFD_NONBLOCK | EFD_CLOEXEC);
+        if ((poll->epoll_fd >= 0) && (poll->timer_fd >= 0) && (poll->event_fd >= 0))
+        {
+            ret = NANO_IP_OAL_POLL_AddHandle(poll, poll->timer_fd);
+            if (ret == NIP_ERR_SUCCESS)
+            {
+                ret = NANO_IP_OAL_POLL_AddHandle(poll, poll->event_fd);
+            }
+        }
+        if (ret != NIP_ERR_SUCCESS)
+        {
+            if (poll->epoll_fd >= 0)
+            {
+                (void)close(poll->epoll_fd);
+                poll->epoll_fd = -1;
+            }
+            if (poll->timer_fd >= 0)
+            {
+                (void)close(poll->timer_fd);
+                poll->timer_fd = -1;
+            }
+            if (poll->event_fd >= 0)
+            {
+                (void)close(poll->event_fd);
+                poll->event_fd = -1;
+            }
+        }
+    }
+
+    return ret;
+}
+
+/** \brief Add a pollable handle to a poll set */
+nano_ip_error_t NANO_IP_OAL_POLL_AddHandle(oal_poll_t* const poll, const oal_poll_handle_t handle)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+
+    /* Check parameters */
+    if ((poll != NULL) && (handle >= 0))
+    {
+        /* Level triggered: the set stays ready as long as one of its handles is ready */
+        struct epoll_event event;
+        NANO_IP_memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.fd = handle;
+        if (epoll_ctl(poll->epoll_fd, EPOLL_CTL_ADD, handle, &event) == 0)
+        {
+            ret = NIP_ERR_SUCCESS;
+        }
+        else
+        {
+            ret = NIP_ERR_RESOURCE;
+        }
+    }
+
+    return ret;
+}
+
+/** \brief Make a poll set ready after timeout milliseconds at the latest (NANO_IP_MAX_TIMEOUT_VALUE = only on its handles' events) */
+nano_ip_error_t NANO_IP_OAL_POLL_SetTimeout(oal_poll_t* const poll, const uint32_t timeout)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+
+    /* Check parameters */
+    if (poll != NULL)
+    {
+        /* Re-arming the timer also clears its previous expiration, a null value disarms it */
+        struct itimerspec timerspec;
+        NANO_IP_memset(&timerspec, 0, sizeof(timerspec));
+        if (timeout == 0u)
+        {
+            timerspec.it_value.tv_nsec = 1;
+        }
+        else if (timeout != NANO_IP_MAX_TIMEOUT_VALUE)
+        {
+            timerspec.it_value.tv_sec = NANO_IP_CAST(time_t, timeout / 1000u);
+            timerspec.it_value.tv_nsec = NANO_IP_CAST(long, (timeout % 1000u) * 1000000u);
+        }
+        else
+        {
+            /* No timeout */
+        }
+
+        if (timerfd_settime(poll->timer_fd, 0, &timerspec, NULL) == 0)
+        {
+            ret = NIP_ERR_SUCCESS;
+        }
+        else
+        {
+            ret = NIP_ERR_RESOURCE;
+        }
+    }
+
+    return ret;
+}
+
+/** \brief Make a poll set ready until it is acknowledged (can be called from any task) */
+nano_ip_error_t NANO_IP_OAL_POLL_Signal(oal_poll_t* const poll)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+
+    /* Check parameters */
+    if (poll != NULL)
+    {
+        const uint64_t value = 1u;
+        (void)write(poll->event_fd, &value, sizeof(value));
+        ret = NIP_ERR_SUCCESS;
+    }
+
+    return ret;
+}
+
+/** \brief Acknowledge the signals of a poll set */
+nano_ip_error_t NANO_IP_OAL_POLL_Acknowledge(oal_poll_t* const poll)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+
+    /* Check parameters */
+    if (poll != NULL)
+    {
+        uint64_t value;
+        (void)read(poll->event_fd, &value, sizeof(value));
+        ret = NIP_ERR_SUCCESS;
+    }
+
+    return ret;
+}
+
+/** \brief Get the handle of a poll set, ready when one of its handles is ready or when its timeout has elapsed */
+nano_ip_error_t NANO_IP_OAL_POLL_GetHandle(const oal_poll_t* const poll, oal_poll_handle_t* const handle)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+
+    /* Check parameters */
+    if ((poll != NULL) && (handle != NULL))
+    {
+        /* An epoll file descriptor is itself pollable */
+        (*handle) = poll->epoll_fd;
+        ret = NIP_ERR_SUCCESS;
+    }
+
+    return ret;
+}
@@ -20,10 +20,39 @@ along with Nano-IP.  If not, see <http://www.gnu.org/licenses/>.
 #include "nano_ip_oal_timer.h"
 #include "nano_ip_tools.h"
 
-#include <signal.h>
+#include <sys/timerfd.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <errno.h>
 
-/** \brief Windows' timer standard callback function */
-static void NANO_IP_OAL_TIMER_Callback(sigval_t sigval);
+
+/** \brief Maximum number of timer expirations handled per wake up of the dispatcher task */
+#define OAL_TIMER_MAX_EVENTS    16
+
+
+/** \brief Timer dispatcher data */
+typedef struct _oal_timer_dispatcher_t
+{
+    /** \brief Initialization control */
+    pthread_once_t once;
+    /** \brief Initialization status */
+    nano_ip_error_t init_status;
+    /** \brief Epoll instance multiplexing all the timers */
+    int epoll_fd;
+    /** \brief Dispatcher task */
+    pthread_t task;
+} oal_timer_dispatcher_t;
+
+
+/** \brief Timer dispatcher shared by all the timers */
+static oal_timer_dispatcher_t s_dispatcher = { PTHREAD_ONCE_INIT, NIP_ERR_RESOURCE, -1, 0 };
+
+
+/** \brief Initialize the timer dispatcher */
+static void NANO_IP_OAL_TIMER_InitDispatcher(void);
+
+/** \brief Timer dispatcher task */
+static void* NANO_IP_OAL_TIMER_DispatcherTask(void* const param);
 
 
 /** \brief Create a timer */
@@ -34,24 +63,33 @@ nano_ip_error_t NANO_IP_OAL_TIMER_Create(oal_timer_t* const timer, const fp_time
     /* Check parameters */
     if ((timer != NULL) && (callback != NULL))
     {
-        /* Create timer */
-    	struct sigevent sigev;
-    	NANO_IP_memset(&sigev, 0, sizeof(sigev));
-
-    	sigev.sigev_notify = SIGEV_THREAD;
-    	sigev.sigev_value.sival_ptr = timer;
-    	sigev._sigev_un._sigev_thread._function = NANO_IP_OAL_TIMER_Callback;
-
-    	if (timer_create(CLOCK_MONOTONIC, &sigev, &timer->timer) == 0)
+        /* Start the dispatcher on first use */
+        (void)pthread_once(&s_dispatcher.once, NANO_IP_OAL_TIMER_InitDispatcher);
+        ret = s_dispatcher.init_status;
+        if (ret == NIP_ERR_SUCCESS)
         {
-            /* Save user data */
+            /* Create timer */
             timer->callback = callback;
             timer->user_data = user_data;
-            ret = NIP_ERR_SUCCESS;
-        }
-        else
-        {
-            ret = NIP_ERR_RESOURCE;
+            timer->fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+            if (timer->fd >= 0)
+            {
+                /* Register it to the dispatcher */
+                struct epoll_event event;
+                NANO_IP_memset(&event, 0, sizeof(event));
+                event.events = EPOLLIN;
+                event.data.ptr = timer;
+                if (epoll_ctl(s_dispatcher.epoll_fd, EPOLL_CTL_ADD, timer->fd, &event) != 0)
+                {
+                    (void)close(timer->fd);
+                    timer->fd = -1;
+                    ret = NIP_ERR_RESOURCE;
+                }
+            }
+            else
+            {
+                ret = NIP_ERR_RESOURCE;
+            }
         }
     }
 
@@ -66,20 +104,20 @@ nano_ip_error_t NANO_IP_OAL_TIMER_Start(oal_timer_t* const timer, const uint32_t
     /* Check parameters */
     if ((timer != NULL) && (period != 0u))
     {
-    	struct itimerspec timerspec;
-    	timerspec.it_value.tv_sec = NANO_IP_CAST(time_t, period / 1000u);
-    	timerspec.it_value.tv_nsec = NANO_IP_CAST(long, (period % 1000u) * 1000000u);
-    	timerspec.it_interval.tv_sec = timerspec.it_value.tv_sec;
-    	timerspec.it_interval.tv_nsec = timerspec.it_value.tv_nsec;
-
-    	if (timer_settime(timer->timer, 0, &timerspec, NULL) == 0)
-    	{
-    		ret = NIP_ERR_SUCCESS;
-    	}
-    	else
-    	{
-    		ret = NIP_ERR_RESOURCE;
-    	}
+        struct itimerspec timerspec;
+        timerspec.it_value.tv_sec = NANO_IP_CAST(time_t, period / 1000u);
+        timerspec.it_value.tv_nsec = NANO_IP_CAST(long, (period % 1000u) * 1000000u);
+        timerspec.it_interval.tv_sec = timerspec.it_value.tv_sec;
+        timerspec.it_interval.tv_nsec = timerspec.it_value.tv_nsec;
+
+        if (timerfd_settime(timer->fd, 0, &timerspec, NULL) == 0)
+        {
+            ret = NIP_ERR_SUCCESS;
+        }
+        else
+        {
+            ret = NIP_ERR_RESOURCE;
+        }
     }
 
     return ret;
@@ -93,26 +131,70 @@ nano_ip_error_t NANO_IP_OAL_TIMER_Stop(oal_timer_t* const timer)
     /* Check parameters */
     if (timer != NULL)
     {
-    	struct itimerspec timerspec;
-    	NANO_IP_memset(&timerspec, 0, sizeof(timerspec));
-
-		if (timer_settime(timer->timer, 0, &timerspec, NULL) == 0)
-		{
-			ret = NIP_ERR_SUCCESS;
-		}
-		else
-		{
-			ret = NIP_ERR_RESOURCE;
-		}
+        /* Disarming also clears the pending expirations */
+        struct itimerspec timerspec;
+        NANO_IP_memset(&timerspec, 0, sizeof(timerspec));
+
+        if (timerfd_settime(timer->fd, 0, &timerspec, NULL) == 0)
+        {
+            ret = NIP_ERR_SUCCESS;
+        }
+        else
+        {
+            ret = NIP_ERR_RESOURCE;
+        }
     }
 
     return ret;
 }
 
-/** \brief Windows' timer standard callback function */
-static void NANO_IP_OAL_TIMER_Callback(sigval_t sigval)
+/** \brief Initialize the timer dispatcher */
+static void NANO_IP_OAL_TIMER_InitDispatcher(void)
 {
-    oal_timer_t* const timer = NANO_IP_CAST(oal_timer_t*, sigval.sival_ptr);
-    fp_timer_callback_t callback = NANO_IP_CAST(fp_timer_callback_t, timer->callback);
-    callback(timer, timer->user_data);
+    s_dispatcher.epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (s_dispatcher.epoll_fd >= 0)
+    {
+        if (pthread_create(&s_dispatcher.task, NULL, NANO_IP_OAL_TIMER_DispatcherTask, &s_dispatcher) == 0)
+        {
+            s_dispatcher.init_status = NIP_ERR_SUCCESS;
+        }
+        else
+        {
+            (void)close(s_dispatcher.epoll_fd);
+            s_dispatcher.epoll_fd = -1;
+        }
+    }
+}
+
+/** \brief Timer dispatcher task */
+static void* NANO_IP_OAL_TIMER_DispatcherTask(void* const param)
+{
+    oal_timer_dispatcher_t* const dispatcher = NANO_IP_CAST(oal_timer_dispatcher_t*, param);
+
+    /* Task loop */
+    while (true)
+    {
+        struct epoll_event events[OAL_TIMER_MAX_EVENTS];
+        const int count = epoll_wait(dispatcher->epoll_fd, events, OAL_TIMER_MAX_EVENTS, -1);
+        int i;
+        for (i = 0; i < count; i++)
+        {
+            oal_timer_t* const timer = NANO_IP_CAST(oal_timer_t*, events[i].data.ptr);
+            uint64_t expirations = 0u;
+
+            /* Acknowledge the expirations, nothing is read if the timer has been stopped or restarted in the meantime,
+               missed expirations are coalesced into a single call */
+            if (read(timer->fd, &expirations, sizeof(expirations)) == NANO_IP_CAST(ssize_t, sizeof(expirations)))
+            {
+                fp_timer_callback_t callback = NANO_IP_CAST(fp_timer_callback_t, timer->callback);
+                callback(timer, timer->user_data);
+            }
+        }
+        if ((count < 0) && (errno != EINTR))
+        {
+            break;
+        }
+    }
+
+    return NULL;
 }
@@ -40,29 +40,57 @@ typedef pthread_mutex_t oal_mutex_t;
 /** \brief Flags */
 typedef struct _oal_flags_t
 {
-    /** \brief Flags */
+    /** \brief Flags, also used as the futex word */
     uint32_t flags;
-    /** \brief Mutex */
-    pthread_mutex_t mutex;
-    /** \brief Condition variable */
-    pthread_cond_t cond_var;
+    /** \brief Number of tasks sleeping on the futex */
+    uint32_t waiters;
 } oal_flags_t;
 
 
 /** \brief Timer */
 typedef struct _oal_timer_t
 {
-    /** \brief Timer */
-    timer_t timer;
+    /** \brief Timer file descriptor, multiplexed with the other timers by the timer dispatcher task */
+    int fd;
     /** \brief Callback */
     void* callback;
     /** \brief User data */
     void* user_data;
 } oal_timer_t;
 
+/** \brief Pollable handle */
+typedef int oal_poll_handle_t;
+
+/** \brief Poll set */
+typedef struct _oal_poll_t
+{
+    /** \brief Epoll instance of the poll set */
+    int epoll_fd;
+    /** \brief Timer file descriptor implementing the timeout */
+    int timer_fd;
+    /** \brief Event file descriptor implementing the signals */
+    int event_fd;
+} oal_poll_t;
+
 /** \brief Maximum timeout value */
 #define NANO_IP_MAX_TIMEOUT_VALUE   0xFFFFFFFFu
 
 
+/** \brief Thread local storage specifier */
+#define NANO_IP_OAL_THREAD_LOCAL                            __thread
+
+/** \brief Atomically read a 32 bits value */
+#define NANO_IP_OAL_ATOMIC_LOAD32(ptr)                      __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+
+/** \brief Atomically replace a 32 bits value if it is equal to the expected value, returns true if the value has been replaced */
+#define NANO_IP_OAL_ATOMIC_CAS32(ptr, expected, desired)    __sync_bool_compare_and_swap((ptr), (expected), (desired))
+
+/** \brief Atomically add a value to a 32 bits value, returns the new value */
+#define NANO_IP_OAL_ATOMIC_ADD32(ptr, value)                __atomic_add_fetch((ptr), (value), __ATOMIC_ACQ_REL)
+
+/** \brief Prevent the reads before the barrier to be reordered with the reads after it */
+#define NANO_IP_OAL_READ_BARRIER()                          __atomic_thread_fence(__ATOMIC_ACQUIRE)
+
+
 
 #endif /* NANO_IP_OAL_TYPES_H */
@@ -27,6 +27,8 @@ along with Nano-IP.  If not, see <http://www.gnu.org/licenses/>.
 #include "nano_ip_oal_flags.h"
 #include "nano_ip_oal_time.h"
 #include "nano_ip_oal_timer.h"
+#include "nano_ip_oal_poll.h"
+#include "nano_ip_oal_seqlock.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -0,0 +1,90 @@
+/*
+Copyright(c) 2017 Cedric Jimenez
+
+This file is part of Nano-IP.
+
+Nano-IP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Nano-IP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with Nano-IP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef NANO_IP_OAL_SEQLOCK_H
+#define NANO_IP_OAL_SEQLOCK_H
+
+#include "nano_ip_types.h"
+#include "nano_ip_error.h"
+#include "nano_ip_oal_types.h"
+#include "nano_ip_oal_mutex.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+
+/** \brief Sequence lock: writers are serialized by a mutex, readers do not lock and retry if a write occured during their read */
+typedef struct _oal_seqlock_t
+{
+    /** \brief Sequence counter (odd while a write is in progress) */
+    uint32_t sequence;
+    /** \brief Writers mutex */
+    oal_mutex_t mutex;
+} oal_seqlock_t;
+
+
+
+/** \brief Create a sequence lock */
+static inline nano_ip_error_t NANO_IP_OAL_SEQLOCK_Create(oal_seqlock_t* const seqlock)
+{
+    seqlock->sequence = 0u;
+    return NANO_IP_OAL_MUTEX_Create(&seqlock->mutex);
+}
+
+/** \brief Start a write section (must not be nested with a read section on the same sequence lock) */
+static inline void NANO_IP_OAL_SEQLOCK_WriteLock(oal_seqlock_t* const seqlock)
+{
+    (void)NANO_IP_OAL_MUTEX_Lock(&seqlock->mutex);
+    (void)NANO_IP_OAL_ATOMIC_ADD32(&seqlock->sequence, 1u);
+}
+
+/** \brief End a write section */
+static inline void NANO_IP_OAL_SEQLOCK_WriteUnlock(oal_seqlock_t* const seqlock)
+{
+    (void)NANO_IP_OAL_ATOMIC_ADD32(&seqlock->sequence, 1u);
+    (void)NANO_IP_OAL_MUTEX_Unlock(&seqlock->mutex);
+}
+
+/** \brief Start a read section, returns the sequence to give to NANO_IP_OAL_SEQLOCK_ReadRetry() */
+static inline uint32_t NANO_IP_OAL_SEQLOCK_ReadBegin(oal_seqlock_t* const seqlock)
+{
+    uint32_t sequence;
+    do
+    {
+        sequence = NANO_IP_OAL_ATOMIC_LOAD32(&seqlock->sequence);
+    }
+    while ((sequence & 1u) != 0u);
+    return sequence;
+}
+
+/** \brief End a read section, returns true if the data read may be inconsistent and the read section must be restarted */
+static inline bool NANO_IP_OAL_SEQLOCK_ReadRetry(oal_seqlock_t* const seqlock, const uint32_t sequence)
+{
+    NANO_IP_OAL_READ_BARRIER();
+    return (NANO_IP_OAL_ATOMIC_LOAD32(&seqlock->sequence) != sequence);
+}
+
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* NANO_IP_OAL_SEQLOCK_H */
@@ -0,0 +1,77 @@
+/*
+Copyright(c) 2017 Cedric Jimenez
+
+This file is part of Nano-IP.
+
+Nano-IP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Nano-IP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with Nano-IP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "nano_ip_oal_poll.h"
+
+
+/* Without operating system the stack is polled by the superloop, there is nothing to wait for */
+
+
+/** \brief Create a poll set */
+nano_ip_error_t NANO_IP_OAL_POLL_Create(oal_poll_t* const poll)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+
+    /* Check parameters */
+    if (poll != NULL)
+    {
+        (*poll) = 0u;
+        ret = NIP_ERR_SUCCESS;
+    }
+
+    return ret;
+}
+
+/** \brief Add a pollable handle to a poll set */
+nano_ip_error_t NANO_IP_OAL_POLL_AddHandle(oal_poll_t* const poll, const oal_poll_handle_t handle)
+{
+    (void)poll;
+    (void)handle;
+    return NIP_ERR_SUCCESS;
+}
+
+/** \brief Make a poll set ready after timeout milliseconds at the latest (NANO_IP_MAX_TIMEOUT_VALUE = only on its handles' events) */
+nano_ip_error_t NANO_IP_OAL_POLL_SetTimeout(oal_poll_t* const poll, const uint32_t timeout)
+{
+    (void)poll;
+    (void)timeout;
+    return NIP_ERR_SUCCESS;
+}
+
+/** \brief Make a poll set ready until it is acknowledged (can be called from any task) */
+nano_ip_error_t NANO_IP_OAL_POLL_Signal(oal_poll_t* const poll)
+{
+    (void)poll;
+    return NIP_ERR_SUCCESS;
+}
+
+/** \brief Acknowledge the signals of a poll set */
+nano_ip_error_t NANO_IP_OAL_POLL_Acknowledge(oal_poll_t* const poll)
+{
+    (void)poll;
+    return NIP_ERR_SUCCESS;
+}
+
+/** \brief Get the handle of a poll set, ready when one of its handles is ready or when its timeout has elapsed */
+nano_ip_error_t NANO_IP_OAL_POLL_GetHandle(const oal_poll_t* const poll, oal_poll_handle_t* const handle)
+{
+    (void)poll;
+    (void)handle;
+    return NIP_ERR_FAILURE;
+}
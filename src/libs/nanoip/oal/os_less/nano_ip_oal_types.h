@@ -61,9 +61,31 @@ typedef struct _oal_timer_t
     struct _oal_timer_t* next;
 } oal_timer_t;
 
+/** \brief Pollable handle (unused) */
+typedef uint8_t oal_poll_handle_t;
+
+/** \brief Poll set (unused) */
+typedef uint8_t oal_poll_t;
+
 /** \brief Maximum timeout value */
 #define NANO_IP_MAX_TIMEOUT_VALUE   0
 
+
+/** \brief Thread local storage specifier (single thread of execution) */
+#define NANO_IP_OAL_THREAD_LOCAL
+
+/** \brief Atomically read a 32 bits value (single thread of execution) */
+#define NANO_IP_OAL_ATOMIC_LOAD32(ptr)                      (*(ptr))
+
+/** \brief Atomically replace a 32 bits value if it is equal to the expected value, returns true if the value has been replaced (single thread of execution) */
+#define NANO_IP_OAL_ATOMIC_CAS32(ptr, expected, desired)    (((*(ptr)) == (expected)) ? (((*(ptr)) = (desired)), true) : false)
+
+/** \brief Atomically add a value to a 32 bits value, returns the new value (single thread of execution) */
+#define NANO_IP_OAL_ATOMIC_ADD32(ptr, value)                ((*(ptr)) += (value))
+
+/** \brief Prevent the reads before the barrier to be reordered with the reads after it (single thread of execution) */
+#define NANO_IP_OAL_READ_BARRIER()
+
 /** \brief Indicate that the tasks must not contain infinite loop */
 #define NANO_IP_OAL_TASK_NO_INFINITE_LOOP
 
@@ -57,9 +57,31 @@ typedef struct _oal_timer_t
     void* user_data;
 } oal_timer_t;
 
+/** \brief Pollable handle */
+typedef HANDLE oal_poll_handle_t;
+
+/** \brief Poll set (unused) */
+typedef uint8_t oal_poll_t;
+
 /** \brief Maximum timeout value */
 #define NANO_IP_MAX_TIMEOUT_VALUE   INFINITE
 
 
+/** \brief Thread local storage specifier */
+#define NANO_IP_OAL_THREAD_LOCAL                            __declspec(thread)
+
+/** \brief Atomically read a 32 bits value */
+#define NANO_IP_OAL_ATOMIC_LOAD32(ptr)                      ((uint32_t)InterlockedCompareExchange((volatile LONG*)(ptr), 0, 0))
+
+/** \brief Atomically replace a 32 bits value if it is equal to the expected value, returns true if the value has been replaced */
+#define NANO_IP_OAL_ATOMIC_CAS32(ptr, expected, desired)    (InterlockedCompareExchange((volatile LONG*)(ptr), (LONG)(desired), (LONG)(expected)) == (LONG)(expected))
+
+/** \brief Atomically add a value to a 32 bits value, returns the new value */
+#define NANO_IP_OAL_ATOMIC_ADD32(ptr, value)                ((uint32_t)InterlockedAdd((volatile LONG*)(ptr), (LONG)(value)))
+
+/** \brief Prevent the reads before the barrier to be reordered with the reads after it */
+#define NANO_IP_OAL_READ_BARRIER()                          MemoryBarrier()
+
+
 
 #endif /* NANO_IP_OAL_TYPES_H */
@@ -19,6 +19,49 @@ along with Nano-IP.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "nano_ip_big_small_packet_allocator.h"
 #include "nano_ip_tools.h"
+#include "nano_ip_packet_funcs.h"
+
+
+#if (NANO_IP_PACKET_ALLOCATOR_CACHE_SIZE != 0u)
+
+/** \brief Number of buffers moved at once between a thread cache and the free buffers stacks */
+#define BIG_SMALL_CACHE_BATCH_SIZE      ((NANO_IP_PACKET_ALLOCATOR_CACHE_SIZE + 1u) / 2u)
+
+/** \brief Mask of the buffer index in a free buffers stack head */
+#define BIG_SMALL_STACK_INDEX_MASK      0x0000FFFFu
+
+/** \brief Mask of the ABA tag in a free buffers stack head */
+#define BIG_SMALL_STACK_TAG_MASK        0xFFFF0000u
+
+/** \brief Increment of the ABA tag in a free buffers stack head */
+#define BIG_SMALL_STACK_TAG_INCREMENT   0x00010000u
+
+
+/** \brief Free buffers cache */
+typedef struct _big_small_buffer_cache_t
+{
+    /** \brief Number of buffers in the cache */
+    uint16_t count;
+    /** \brief Buffers (LIFO) */
+    big_small_buffer_desc_t* buffers[NANO_IP_PACKET_ALLOCATOR_CACHE_SIZE];
+} big_small_buffer_cache_t;
+
+/** \brief Free buffers caches of a thread */
+typedef struct _big_small_thread_cache_t
+{
+    /** \brief Allocator which owns the cached buffers */
+    const big_small_packet_allocator_data_t* allocator;
+    /** \brief Small buffers cache */
+    big_small_buffer_cache_t small_buffers;
+    /** \brief Big buffers cache */
+    big_small_buffer_cache_t big_buffers;
+} big_small_thread_cache_t;
+
+/** \brief Free buffers caches of the calling thread */
+static NANO_IP_OAL_THREAD_LOCAL big_small_thread_cache_t s_thread_cache;
+
+#endif /* NANO_IP_PACKET_ALLOCATOR_CACHE_SIZE */
+
 
 /** \brief Allocate a packet */
 static nano_ip_error_t NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_Allocate(void* const allocator_data, nano_ip_net_packet_t** const packet, const uint16_t size);
@@ -26,12 +69,33 @@ static nano_ip_error_t NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_Allocate(void* const a
 /** \brief Release a packet */
 static nano_ip_error_t NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_Release(void* const allocator_data, nano_ip_net_packet_t* const packet);
 
+/** \brief Get a free small or big buffer */
+static nano_ip_error_t NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_GetBuffer(big_small_packet_allocator_data_t* const allocator, const bool big, big_small_buffer_desc_t** const buffer);
+
+/** \brief Give back a small or big buffer */
+static nano_ip_error_t NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_PutBuffer(big_small_packet_allocator_data_t* const allocator, const bool big, big_small_buffer_desc_t* const buffer);
+
+#if (NANO_IP_PACKET_ALLOCATOR_CACHE_SIZE == 0u)
+
 /** \brief Allocate a buffer */
 static nano_ip_error_t NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_AllocateBuffer(big_small_buffer_desc_t** const free_buffers, big_small_buffer_desc_t** used_buffers, big_small_buffer_desc_t** allocated_buffer);
 
 /** \brief Release a buffer */
 static nano_ip_error_t NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_ReleaseBuffer(big_small_buffer_desc_t* allocated_buffer, big_small_buffer_desc_t** const free_buffers, big_small_buffer_desc_t** used_buffers);
 
+#else
+
+/** \brief Get the cache of the calling thread for the small or big buffers (NULL if the thread cache belongs to another allocator) */
+static big_small_buffer_cache_t* NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_GetThreadCache(const big_small_packet_allocator_data_t* const allocator, const bool big);
+
+/** \brief Pop a buffer from a free buffers stack */
+static big_small_buffer_desc_t* NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_PopFreeBuffer(uint32_t* const free_head, big_small_buffer_desc_t* const descs);
+
+/** \brief Push an array of buffers on a free buffers stack */
+static void NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_PushFreeBuffers(uint32_t* const free_head, big_small_buffer_desc_t* const descs, big_small_buffer_desc_t* const * const buffers, const uint16_t count);
+
+#endif /* NANO_IP_PACKET_ALLOCATOR_CACHE_SIZE */
+
 
 /** \brief Initialize the packet allocator */
 nano_ip_error_t NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_Init(nano_ip_net_packet_allocator_t* const allocator, big_small_packet_allocator_data_t* const allocator_data)
@@ -56,18 +120,38 @@ nano_ip_error_t NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_Init(nano_ip_net_packet_alloc
         for (i = 0u; i < allocator_data->big_buffers_count; i++)
         {
             allocator_data->big_buffers_descs[i].data = &allocator_data->big_buffers[i * allocator_data->big_buffer_size];
+            allocator_data->big_buffers_descs[i].used = false;
+            allocator_data->big_buffers_descs[i].previous = NULL;
             allocator_data->big_buffers_descs[i].next = &allocator_data->big_buffers_descs[i + 1u];
         }
         allocator_data->big_buffers_descs[i - 1u].next = NULL;
         for (i = 0u; i < allocator_data->small_buffers_count; i++)
         {
             allocator_data->small_buffers_descs[i].data = &allocator_data->small_buffers[i * allocator_data->small_buffer_size];
+            allocator_data->small_buffers_descs[i].used = false;
+            allocator_data->small_buffers_descs[i].previous = NULL;
             allocator_data->small_buffers_descs[i].next = &allocator_data->small_buffers_descs[i + 1u];
         }
         allocator_data->small_buffers_descs[i - 1u].next = NULL;
         allocator_data->internal_data.free_big_buffers = allocator_data->big_buffers_descs;
         allocator_data->internal_data.free_small_buffers = allocator_data->small_buffers_descs;
 
+        #if (NANO_IP_PACKET_ALLOCATOR_CACHE_SIZE != 0u)
+        /* Initialize the lock-free free buffers stacks */
+        for (i = 0u; i < allocator_data->big_buffers_count; i++)
+        {
+            allocator_data->big_buffers_descs[i].free_next = NANO_IP_CAST(uint32_t, i) + 2u;
+        }
+        allocator_data->big_buffers_descs[i - 1u].free_next = 0u;
+        for (i = 0u; i < allocator_data->small_buffers_count; i++)
+        {
+            allocator_data->small_buffers_descs[i].free_next = NANO_IP_CAST(uint32_t, i) + 2u;
+        }
+        allocator_data->small_buffers_descs[i - 1u].free_next = 0u;
+        allocator_data->internal_data.free_big_head = 1u;
+        allocator_data->internal_data.free_small_head = 1u;
+        #endif /* NANO_IP_PACKET_ALLOCATOR_CACHE_SIZE */
+
         /* Initialize mutex */
         ret = NANO_IP_OAL_MUTEX_Create(&allocator_data->internal_data.mutex);
     }
@@ -87,24 +171,26 @@ static nano_ip_error_t NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_Allocate(void* const a
     {
         big_small_buffer_desc_t* buffer = NULL;
 
+        #if (NANO_IP_PACKET_ALLOCATOR_CACHE_SIZE == 0u)
         /* Lock allocator */
         (void)NANO_IP_OAL_MUTEX_Lock(&allocator->internal_data.mutex);
+        #endif /* NANO_IP_PACKET_ALLOCATOR_CACHE_SIZE */
 
         /* Check requested size */
         if (size <= allocator->small_buffer_size)
         {
             /* Small buffer */
-            ret = NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_AllocateBuffer(&allocator->internal_data.free_small_buffers, &allocator->internal_data.used_small_buffers, &buffer);
+            ret = NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_GetBuffer(allocator, false, &buffer);
             if (ret != NIP_ERR_SUCCESS)
             {
                 /* Try to allocate a big buffer instead */
-                ret = NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_AllocateBuffer(&allocator->internal_data.free_big_buffers, &allocator->internal_data.used_big_buffers, &buffer);
+                ret = NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_GetBuffer(allocator, true, &buffer);
             }
         }
         else if (size <= allocator->big_buffer_size)
         {
             /* Big buffer */
-            ret = NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_AllocateBuffer(&allocator->internal_data.free_big_buffers, &allocator->internal_data.used_big_buffers, &buffer);
+            ret = NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_GetBuffer(allocator, true, &buffer);
         }
         else
         {
@@ -123,11 +209,15 @@ static nano_ip_error_t NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_Allocate(void* const a
             pkt->flags = 0u;
             pkt->allocator_data = buffer;
             pkt->net_if = NULL;
+            pkt->segments = NULL;
+            pkt->ref_count = 1u;
             (*packet) = pkt;
         }
 
+        #if (NANO_IP_PACKET_ALLOCATOR_CACHE_SIZE == 0u)
         /* Unlock allocator */
         (void)NANO_IP_OAL_MUTEX_Unlock(&allocator->internal_data.mutex);
+        #endif /* NANO_IP_PACKET_ALLOCATOR_CACHE_SIZE */
     }
 
     return ret;
@@ -144,38 +234,175 @@ static nano_ip_error_t NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_Release(void* const al
     {
         big_small_buffer_desc_t* buffer = NANO_IP_CAST(big_small_buffer_desc_t*, packet->allocator_data);
 
-        /* Lock allocator */
-        (void)NANO_IP_OAL_MUTEX_Lock(&allocator->internal_data.mutex);
+        /* Drop a reference, the buffer is released with the last one */
+        if (!NANO_IP_PACKET_Unref(packet))
+        {
+            /* Packet is still in use */
+            ret = NIP_ERR_SUCCESS;
+        }
+        else
+        {
+            /* Release the payload segments */
+            NANO_IP_PACKET_ReleaseSegments(packet);
 
-        /* Check packet size */
-        if (packet->size <= allocator->small_buffer_size)
+            #if (NANO_IP_PACKET_ALLOCATOR_CACHE_SIZE == 0u)
+            /* Lock allocator */
+            (void)NANO_IP_OAL_MUTEX_Lock(&allocator->internal_data.mutex);
+            #endif /* NANO_IP_PACKET_ALLOCATOR_CACHE_SIZE */
+
+            /* Check which buffers array the buffer belongs to (a small request may have been served by a big buffer) */
+            if ((buffer >= allocator->small_buffers_descs) && (buffer < &allocator->small_buffers_descs[allocator->small_buffers_count]))
+            {
+                /* Small buffer */
+                ret = NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_PutBuffer(allocator, false, buffer);
+            }
+            else if ((buffer >= allocator->big_buffers_descs) && (buffer < &allocator->big_buffers_descs[allocator->big_buffers_count]))
+            {
+                /* Big buffer */
+                ret = NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_PutBuffer(allocator, true, buffer);
+            }
+            else
+            {
+                /* Buffer not allocated by this allocator */
+                ret = NIP_ERR_PACKET_NOT_FOUND;
+            }
+
+            #if (NANO_IP_PACKET_ALLOCATOR_CACHE_SIZE == 0u)
+            /* Unlock allocator */
+            (void)NANO_IP_OAL_MUTEX_Unlock(&allocator->internal_data.mutex);
+            #endif /* NANO_IP_PACKET_ALLOCATOR_CACHE_SIZE */
+        }
+    }
+
+    return ret;
+}
+
+/** \brief Get a free small or big buffer */
+static nano_ip_error_t NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_GetBuffer(big_small_packet_allocator_data_t* const allocator, const bool big, big_small_buffer_desc_t** const buffer)
+{
+    nano_ip_error_t ret = NIP_ERR_RESOURCE;
+
+    #if (NANO_IP_PACKET_ALLOCATOR_CACHE_SIZE == 0u)
+
+    /* Take the buffer from the free buffers list */
+    if (big)
+    {
+        ret = NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_AllocateBuffer(&allocator->internal_data.free_big_buffers, &allocator->internal_data.used_big_buffers, buffer);
+    }
+    else
+    {
+        ret = NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_AllocateBuffer(&allocator->internal_data.free_small_buffers, &allocator->internal_data.used_small_buffers, buffer);
+    }
+
+    #else
+
+    uint32_t* const free_head = (big ? &allocator->internal_data.free_big_head : &allocator->internal_data.free_small_head);
+    big_small_buffer_desc_t* const descs = (big ? allocator->big_buffers_descs : allocator->small_buffers_descs);
+    big_small_buffer_cache_t* const cache = NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_GetThreadCache(allocator, big);
+    if (cache != NULL)
+    {
+        /* Refill the thread cache from the free buffers stack if empty */
+        if (cache->count == 0u)
         {
-            /* Small buffer */
-            ret = NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_ReleaseBuffer(buffer, &allocator->internal_data.free_small_buffers, &allocator->internal_data.used_small_buffers);
-            if (ret != NIP_ERR_SUCCESS)
+            bool refill = true;
+            while (refill && (cache->count < BIG_SMALL_CACHE_BATCH_SIZE))
             {
-                /* Try to release a big buffer instead */
-                ret = NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_ReleaseBuffer(buffer, &allocator->internal_data.free_big_buffers, &allocator->internal_data.used_big_buffers);
+                big_small_buffer_desc_t* const free_buffer = NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_PopFreeBuffer(free_head, descs);
+                if (free_buffer != NULL)
+                {
+                    cache->buffers[cache->count] = free_buffer;
+                    cache->count++;
+                }
+                else
+                {
+                    refill = false;
+                }
             }
         }
-        else if (packet->size <= allocator->big_buffer_size)
+
+        /* Take the buffer from the thread cache */
+        if (cache->count != 0u)
         {
-            /* Big buffer */
-            ret = NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_ReleaseBuffer(buffer, &allocator->internal_data.free_big_buffers, &allocator->internal_data.used_big_buffers);
+            cache->count--;
+            (*buffer) = cache->buffers[cache->count];
+            ret = NIP_ERR_SUCCESS;
+        }
+    }
+    else
+    {
+        /* Take the buffer directly from the free buffers stack */
+        (*buffer) = NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_PopFreeBuffer(free_head, descs);
+        if ((*buffer) != NULL)
+        {
+            ret = NIP_ERR_SUCCESS;
+        }
+    }
+    if (ret == NIP_ERR_SUCCESS)
+    {
+        (*buffer)->used = true;
+    }
+
+    #endif /* NANO_IP_PACKET_ALLOCATOR_CACHE_SIZE */
+
+    return ret;
+}
+
+/** \brief Give back a small or big buffer */
+static nano_ip_error_t NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_PutBuffer(big_small_packet_allocator_data_t* const allocator, const bool big, big_small_buffer_desc_t* const buffer)
+{
+    nano_ip_error_t ret = NIP_ERR_PACKET_NOT_FOUND;
+
+    #if (NANO_IP_PACKET_ALLOCATOR_CACHE_SIZE == 0u)
+
+    /* Move the buffer back to the free buffers list */
+    if (big)
+    {
+        ret = NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_ReleaseBuffer(buffer, &allocator->internal_data.free_big_buffers, &allocator->internal_data.used_big_buffers);
+    }
+    else
+    {
+        ret = NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_ReleaseBuffer(buffer, &allocator->internal_data.free_small_buffers, &allocator->internal_data.used_small_buffers);
+    }
+
+    #else
+
+    /* Check that the buffer is in use */
+    if (buffer->used)
+    {
+        uint32_t* const free_head = (big ? &allocator->internal_data.free_big_head : &allocator->internal_data.free_small_head);
+        big_small_buffer_desc_t* const descs = (big ? allocator->big_buffers_descs : allocator->small_buffers_descs);
+        big_small_buffer_cache_t* const cache = NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_GetThreadCache(allocator, big);
+        buffer->used = false;
+        if (cache != NULL)
+        {
+            /* Flush the oldest half of the thread cache to the free buffers stack if full */
+            if (cache->count == NANO_IP_PACKET_ALLOCATOR_CACHE_SIZE)
+            {
+                NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_PushFreeBuffers(free_head, descs, cache->buffers, BIG_SMALL_CACHE_BATCH_SIZE);
+                cache->count -= BIG_SMALL_CACHE_BATCH_SIZE;
+                (void)MEMCPY(&cache->buffers[0u], &cache->buffers[BIG_SMALL_CACHE_BATCH_SIZE], cache->count * sizeof(big_small_buffer_desc_t*));
+            }
+
+            /* Put the buffer in the thread cache */
+            cache->buffers[cache->count] = buffer;
+            cache->count++;
         }
         else
         {
-            /* Buffer too big to be allocated */
-            ret = NIP_ERR_PACKET_TOO_BIG;
+            /* Put the buffer directly on the free buffers stack */
+            NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_PushFreeBuffers(free_head, descs, &buffer, 1u);
         }
 
-        /* Unlock allocator */
-        (void)NANO_IP_OAL_MUTEX_Unlock(&allocator->internal_data.mutex);
+        ret = NIP_ERR_SUCCESS;
     }
 
+    #endif /* NANO_IP_PACKET_ALLOCATOR_CACHE_SIZE */
+
     return ret;
 }
 
+#if (NANO_IP_PACKET_ALLOCATOR_CACHE_SIZE == 0u)
+
 /** \brief Allocate a buffer */
 static nano_ip_error_t NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_AllocateBuffer(big_small_buffer_desc_t** const free_buffers, big_small_buffer_desc_t** used_buffers, big_small_buffer_desc_t** allocated_buffer)
 {
@@ -189,7 +416,13 @@ static nano_ip_error_t NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_AllocateBuffer(big_sma
         (*free_buffers) = (*free_buffers)->next;
 
         /* Add the buffer to the used buffers list */
+        (*allocated_buffer)->used = true;
+        (*allocated_buffer)->previous = NULL;
         (*allocated_buffer)->next = (*used_buffers);
+        if ((*used_buffers) != NULL)
+        {
+            (*used_buffers)->previous = (*allocated_buffer);
+        }
         (*used_buffers) = (*allocated_buffer);
 
         ret = NIP_ERR_SUCCESS;
@@ -203,36 +436,112 @@ static nano_ip_error_t NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_ReleaseBuffer(big_smal
 {
     nano_ip_error_t ret = NIP_ERR_PACKET_NOT_FOUND;
 
-    /* Look for the buffer in the used buffers list */
-    big_small_buffer_desc_t* used_buffer = (*used_buffers);
-    big_small_buffer_desc_t* previous_used_buffer = NULL;
-    while ((used_buffer != NULL) && (ret != NIP_ERR_SUCCESS))
+    /* Check that the buffer is in the used buffers list */
+    if (allocated_buffer->used)
     {
-        if (used_buffer == allocated_buffer)
+        /* Remove the buffer from the used buffers list */
+        if (allocated_buffer->previous != NULL)
         {
-            /* Remove the buffer from the used buffers list */
-            if (previous_used_buffer != NULL)
-            {
-                previous_used_buffer->next = allocated_buffer->next;
-            }
-            else
-            {
-                (*used_buffers) = allocated_buffer->next;
-            }
+            allocated_buffer->previous->next = allocated_buffer->next;
+        }
+        else
+        {
+            (*used_buffers) = allocated_buffer->next;
+        }
+        if (allocated_buffer->next != NULL)
+        {
+            allocated_buffer->next->previous = allocated_buffer->previous;
+        }
 
-            /* Add the buffer to the free buffers list */
-            allocated_buffer->next = (*free_buffers);
-            (*free_buffers) = allocated_buffer;
+        /* Add the buffer to the free buffers list */
+        allocated_buffer->used = false;
+        allocated_buffer->previous = NULL;
+        allocated_buffer->next = (*free_buffers);
+        (*free_buffers) = allocated_buffer;
 
-            ret = NIP_ERR_SUCCESS;
+        ret = NIP_ERR_SUCCESS;
+    }
+
+    return ret;
+}
+
+#else
+
+/** \brief Get the cache of the calling thread for the small or big buffers (NULL if the thread cache belongs to another allocator) */
+static big_small_buffer_cache_t* NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_GetThreadCache(const big_small_packet_allocator_data_t* const allocator, const bool big)
+{
+    big_small_buffer_cache_t* cache = NULL;
+
+    /* The first allocator used by a thread owns its cache */
+    if (s_thread_cache.allocator == NULL)
+    {
+        s_thread_cache.allocator = allocator;
+    }
+    if (s_thread_cache.allocator == allocator)
+    {
+        if (big)
+        {
+            cache = &s_thread_cache.big_buffers;
         }
         else
         {
-            /* Next buffer */
-            previous_used_buffer = used_buffer;
-            used_buffer = used_buffer->next;
+            cache = &s_thread_cache.small_buffers;
         }
     }
 
-    return ret;
-}
\ No newline at end of file
+    return cache;
+}
+
+/** \brief Pop a buffer from a free buffers stack */
+static big_small_buffer_desc_t* NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_PopFreeBuffer(uint32_t* const free_head, big_small_buffer_desc_t* const descs)
+{
+    big_small_buffer_desc_t* buffer = NULL;
+    bool done = false;
+
+    while (!done)
+    {
+        const uint32_t head = NANO_IP_OAL_ATOMIC_LOAD32(free_head);
+        const uint32_t index = (head & BIG_SMALL_STACK_INDEX_MASK);
+        if (index == 0u)
+        {
+            /* Empty stack */
+            buffer = NULL;
+            done = true;
+        }
+        else
+        {
+            /* The tag is incremented so that a concurrent pop/push of the same buffer makes the exchange fail */
+            uint32_t new_head;
+            buffer = &descs[index - 1u];
+            new_head = ((head + BIG_SMALL_STACK_TAG_INCREMENT) & BIG_SMALL_STACK_TAG_MASK) | NANO_IP_OAL_ATOMIC_LOAD32(&buffer->free_next);
+            done = NANO_IP_OAL_ATOMIC_CAS32(free_head, head, new_head);
+        }
+    }
+
+    return buffer;
+}
+
+/** \brief Push an array of buffers on a free buffers stack */
+static void NANO_IP_BIG_SMALL_PACKET_ALLOCATOR_PushFreeBuffers(uint32_t* const free_head, big_small_buffer_desc_t* const descs, big_small_buffer_desc_t* const * const buffers, const uint16_t count)
+{
+    uint16_t i;
+    uint32_t head;
+    uint32_t new_head;
+
+    /* Chain the buffers together */
+    for (i = 1u; i < count; i++)
+    {
+        buffers[i - 1u]->free_next = NANO_IP_CAST(uint32_t, (buffers[i] - descs)) + 1u;
+    }
+
+    /* Insert the chain on top of the stack */
+    do
+    {
+        head = NANO_IP_OAL_ATOMIC_LOAD32(free_head);
+        buffers[count - 1u]->free_next = (head & BIG_SMALL_STACK_INDEX_MASK);
+        new_head = ((head + BIG_SMALL_STACK_TAG_INCREMENT) & BIG_SMALL_STACK_TAG_MASK) | (NANO_IP_CAST(uint32_t, (buffers[0u] - descs)) + 1u);
+    }
+    while (!NANO_IP_OAL_ATOMIC_CAS32(free_head, head, new_head));
+}
+
+#endif /* NANO_IP_PACKET_ALLOCATOR_CACHE_SIZE */
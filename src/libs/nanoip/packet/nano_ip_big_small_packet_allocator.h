@@ -74,8 +74,16 @@ typedef struct _big_small_buffer_desc_t
     void* data;
     /** \brief Packet */
     nano_ip_net_packet_t packet;
+    /** \brief Indicate if the buffer is in the used buffers list */
+    bool used;
+    /** \brief Previous buffer (used buffers list only) */
+    struct _big_small_buffer_desc_t* previous;
     /** \brief Next buffer */
     struct _big_small_buffer_desc_t* next;
+    #if (NANO_IP_PACKET_ALLOCATOR_CACHE_SIZE != 0u)
+    /** \brief Index + 1 of the next buffer in the free buffers stack (0 = last buffer) */
+    uint32_t free_next;
+    #endif /* NANO_IP_PACKET_ALLOCATOR_CACHE_SIZE */
 } big_small_buffer_desc_t;
 
 
@@ -92,6 +100,13 @@ typedef struct _big_small_packet_allocator_internal_data_t
     /** \brief Used small buffers list */
     big_small_buffer_desc_t* used_small_buffers;
 
+    #if (NANO_IP_PACKET_ALLOCATOR_CACHE_SIZE != 0u)
+    /** \brief Lock-free free big buffers stack (index + 1 of the top buffer in the 16 LSB, ABA tag in the 16 MSB) */
+    uint32_t free_big_head;
+    /** \brief Lock-free free small buffers stack (index + 1 of the top buffer in the 16 LSB, ABA tag in the 16 MSB) */
+    uint32_t free_small_head;
+    #endif /* NANO_IP_PACKET_ALLOCATOR_CACHE_SIZE */
+
     /** \brief Mutex */
     oal_mutex_t mutex;
 } big_small_packet_allocator_internal_data_t;
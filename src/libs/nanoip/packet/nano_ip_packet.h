@@ -29,8 +29,8 @@ along with Nano-IP.  If not, see <http://www.gnu.org/licenses/>.
 /** \brief Flag indicating that the packet is used for transmission */
 #define NET_IF_PACKET_FLAG_TX                   2u
 
-/** \brief Flag indicating that the packet should not be released on reception */
-#define NET_IF_PACKET_FLAG_KEEP_PACKET          4u
+/** \brief Flag indicating that the packet is owned by the driver for transmission */
+#define NET_IF_PACKET_FLAG_TX_PENDING           8u
 
 /** \brief Flag indicating that the packet transmission or reception has failed */
 #define NET_IF_PACKET_FLAG_ERROR                128u
@@ -46,6 +46,24 @@ extern "C"
 typedef struct _nano_ip_net_if_t nano_ip_net_if_t;
 
 
+/** \brief Payload segment chained after the data of a packet (gather transmission) */
+typedef struct _nano_ip_packet_segment_t
+{
+    /** \brief Data (must stay valid until the segment is released) */
+    const uint8_t* data;
+    /** \brief Size in bytes */
+    uint16_t size;
+
+    /** \brief Called when the packet referencing the segment is released, with the stack lock held (optional) */
+    void (*release)(void* const user_data);
+    /** \brief User data for the release callback */
+    void* user_data;
+
+    /** \brief Next segment */
+    struct _nano_ip_packet_segment_t* next;
+} nano_ip_packet_segment_t;
+
+
 /** \brief Network packet */
 typedef struct _nano_ip_net_packet_t
 {
@@ -64,10 +82,15 @@ typedef struct _nano_ip_net_packet_t
 
     /** \brief Allocator specific data */
     void* allocator_data;
+    /** \brief Number of references on the packet (must be updated atomically) */
+    uint32_t ref_count;
 
     /** \brief Network interface which received the packet */
     nano_ip_net_if_t* net_if;
 
+    /** \brief Payload segments sent after the count bytes of data */
+    nano_ip_packet_segment_t* segments;
+
     /** \brief Next packet */
     struct _nano_ip_net_packet_t* next;
 } nano_ip_net_packet_t;
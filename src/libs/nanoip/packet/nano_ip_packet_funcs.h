@@ -23,6 +23,7 @@ along with Nano-IP.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "nano_ip_packet.h"
 #include "nano_ip_tools.h"
+#include "nano_ip_oal_types.h"
 
 
 /** \brief Read a 16 bits value in network order from a buffer */
@@ -84,6 +85,25 @@ static inline nano_ip_net_packet_t* NANO_IP_PACKET_PopFromQueue(nano_ip_packet_q
     return  packet;
 }
 
+/** \brief Move all the packets of a packet queue at the end of another packet queue */
+static inline void NANO_IP_PACKET_AppendQueue(nano_ip_packet_queue_t* const packet_queue, nano_ip_packet_queue_t* const packets)
+{
+    if (packets->head != NULL)
+    {
+        if (packet_queue->tail == NULL)
+        {
+            packet_queue->head = packets->head;
+        }
+        else
+        {
+            packet_queue->tail->next = packets->head;
+        }
+        packet_queue->tail = packets->tail;
+        packets->head = NULL;
+        packets->tail = NULL;
+    }
+}
+
 
 /** \brief Read an 8bits integer from a packet */
 static inline uint8_t NANO_IP_PACKET_Read8bits(nano_ip_net_packet_t* const packet)
@@ -204,6 +224,88 @@ static inline void NANO_IP_PACKET_WriteZeros(nano_ip_net_packet_t* const packet,
     NANO_IP_PACKET_WriteSkipBytes(packet, size);
 }
 
+/** \brief Chain a payload segment at the end of a packet */
+static inline void NANO_IP_PACKET_AddSegment(nano_ip_net_packet_t* const packet, nano_ip_packet_segment_t* const segment)
+{
+    nano_ip_packet_segment_t** last = &packet->segments;
+    while ((*last) != NULL)
+    {
+        last = &(*last)->next;
+    }
+    segment->next = NULL;
+    (*last) = segment;
+}
+
+/** \brief Get the total size in bytes of the payload segments of a packet */
+static inline uint16_t NANO_IP_PACKET_GetSegmentsSize(const nano_ip_net_packet_t* const packet)
+{
+    uint16_t size = 0u;
+    const nano_ip_packet_segment_t* segment = packet->segments;
+    while (segment != NULL)
+    {
+        size += segment->size;
+        segment = segment->next;
+    }
+    return size;
+}
+
+/** \brief Copy the payload segments of a packet at its current position */
+static inline void NANO_IP_PACKET_WriteSegments(nano_ip_net_packet_t* const packet, const nano_ip_packet_segment_t* const segments)
+{
+    const nano_ip_packet_segment_t* segment = segments;
+    while (segment != NULL)
+    {
+        NANO_IP_PACKET_WriteBuffer(packet, segment->data, segment->size);
+        segment = segment->next;
+    }
+}
+
+/** \brief Detach the payload segments of a packet and notify their owners */
+static inline void NANO_IP_PACKET_ReleaseSegments(nano_ip_net_packet_t* const packet)
+{
+    nano_ip_packet_segment_t* segment = packet->segments;
+    packet->segments = NULL;
+    while (segment != NULL)
+    {
+        nano_ip_packet_segment_t* const next = segment->next;
+        if (segment->release != NULL)
+        {
+            segment->release(segment->user_data);
+        }
+        segment = next;
+    }
+}
+
+/** \brief Take an additional reference on a packet */
+static inline void NANO_IP_PACKET_Retain(nano_ip_net_packet_t* const packet)
+{
+    (void)NANO_IP_OAL_ATOMIC_ADD32(&packet->ref_count, 1u);
+}
+
+/** \brief Drop a reference on a packet, returns true if it was the last one (or if the packet has no reference left) */
+static inline bool NANO_IP_PACKET_Unref(nano_ip_net_packet_t* const packet)
+{
+    bool last = true;
+    if (NANO_IP_OAL_ATOMIC_LOAD32(&packet->ref_count) != 0u)
+    {
+        last = (NANO_IP_OAL_ATOMIC_ADD32(&packet->ref_count, 0xFFFFFFFFu) == 0u);
+    }
+    return last;
+}
+
+/** \brief Drop a reference on a received packet, returns true if it was the last one (the packet is then ready for a new reception) */
+static inline bool NANO_IP_PACKET_RecycleRx(nano_ip_net_packet_t* const packet)
+{
+    const bool last = NANO_IP_PACKET_Unref(packet);
+    if (last)
+    {
+        packet->flags = NET_IF_PACKET_FLAG_RX;
+        packet->current = NANO_IP_CAST(uint8_t*, packet->data);
+        packet->ref_count = 1u;
+    }
+    return last;
+}
+
 
 #ifdef __cplusplus
 }
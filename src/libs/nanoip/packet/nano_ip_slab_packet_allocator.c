@@ -0,0 +1,309 @@
+/*
+Copyright(c) 2017 Cedric Jimenez
+
+This file is part of Nano-IP.
+
+Nano-IP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Nano-IP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with Nano-IP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "nano_ip_slab_packet_allocator.h"
+#include "nano_ip_tools.h"
+#include "nano_ip_packet_funcs.h"
+
+/** \brief Allocate a packet */
+static nano_ip_error_t NANO_IP_SLAB_PACKET_ALLOCATOR_Allocate(void* const allocator_data, nano_ip_net_packet_t** const packet, const uint16_t size);
+
+/** \brief Release a packet */
+static nano_ip_error_t NANO_IP_SLAB_PACKET_ALLOCATOR_Release(void* const allocator_data, nano_ip_net_packet_t* const packet);
+
+/** \brief Check that a buffer description belongs to one of the size classes of the allocator */
+static bool NANO_IP_SLAB_PACKET_ALLOCATOR_IsOwned(const slab_packet_allocator_data_t* const allocator, const slab_buffer_desc_t* const buffer);
+
+
+/** \brief Initialize the packet allocator */
+nano_ip_error_t NANO_IP_SLAB_PACKET_ALLOCATOR_Init(nano_ip_net_packet_allocator_t* const allocator, slab_packet_allocator_data_t* const allocator_data)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+
+    /* Check parameters */
+    if ((allocator != NULL) && (allocator_data != NULL) && 
+        (allocator_data->classes != NULL) && (allocator_data->classes_count != 0u))
+    {
+        uint8_t class_index;
+
+        /* Check that the classes are sorted by increasing buffer size */
+        ret = NIP_ERR_SUCCESS;
+        for (class_index = 1u; class_index < allocator_data->classes_count; class_index++)
+        {
+            if (allocator_data->classes[class_index].buffer_size <= allocator_data->classes[class_index - 1u].buffer_size)
+            {
+                ret = NIP_ERR_INVALID_ARG;
+            }
+        }
+        if (ret == NIP_ERR_SUCCESS)
+        {
+            /* 0 init */
+            MEMSET(allocator, 0, sizeof(nano_ip_net_packet_allocator_t));
+
+            /* Initialize allocator */
+            allocator->allocate = NANO_IP_SLAB_PACKET_ALLOCATOR_Allocate;
+            allocator->release = NANO_IP_SLAB_PACKET_ALLOCATOR_Release;
+            allocator->allocator_data = allocator_data;
+
+            /* Initialize buffers lists */
+            for (class_index = 0u; class_index < allocator_data->classes_count; class_index++)
+            {
+                uint16_t i;
+                slab_packet_allocator_class_t* const size_class = &allocator_data->classes[class_index];
+                size_class->free_buffers = NULL;
+                for (i = size_class->buffers_count; i > 0u; i--)
+                {
+                    slab_buffer_desc_t* const buffer = &size_class->buffers_descs[i - 1u];
+                    buffer->data = &size_class->buffers[(i - 1u) * size_class->buffer_size];
+                    buffer->size_class = size_class;
+                    buffer->used = false;
+                    buffer->next = size_class->free_buffers;
+                    size_class->free_buffers = buffer;
+                }
+                MEMSET(&size_class->stats, 0, sizeof(slab_packet_allocator_stats_t));
+            }
+
+            /* Initialize mutex */
+            ret = NANO_IP_OAL_MUTEX_Create(&allocator_data->mutex);
+        }
+    }
+
+    return ret;
+}
+
+/** \brief Get the statistics of a size class */
+nano_ip_error_t NANO_IP_SLAB_PACKET_ALLOCATOR_GetStats(slab_packet_allocator_data_t* const allocator_data, const uint8_t class_index, slab_packet_allocator_stats_t* const stats)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+
+    /* Check parameters */
+    if ((allocator_data != NULL) && (class_index < allocator_data->classes_count) && (stats != NULL))
+    {
+        /* Copy statistics */
+        (void)NANO_IP_OAL_MUTEX_Lock(&allocator_data->mutex);
+        MEMCPY(stats, &allocator_data->classes[class_index].stats, sizeof(slab_packet_allocator_stats_t));
+        (void)NANO_IP_OAL_MUTEX_Unlock(&allocator_data->mutex);
+
+        ret = NIP_ERR_SUCCESS;
+    }
+
+    return ret;
+}
+
+/** \brief Reset the statistics of all the size classes (the current usage is kept) */
+nano_ip_error_t NANO_IP_SLAB_PACKET_ALLOCATOR_ResetStats(slab_packet_allocator_data_t* const allocator_data)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+
+    /* Check parameters */
+    if (allocator_data != NULL)
+    {
+        uint8_t class_index;
+
+        (void)NANO_IP_OAL_MUTEX_Lock(&allocator_data->mutex);
+        for (class_index = 0u; class_index < allocator_data->classes_count; class_index++)
+        {
+            slab_packet_allocator_stats_t* const stats = &allocator_data->classes[class_index].stats;
+            stats->allocations = 0u;
+            stats->fallbacks = 0u;
+            stats->failures = 0u;
+            stats->high_watermark = stats->used_count;
+        }
+        (void)NANO_IP_OAL_MUTEX_Unlock(&allocator_data->mutex);
+
+        ret = NIP_ERR_SUCCESS;
+    }
+
+    return ret;
+}
+
+
+/** \brief Allocate a packet */
+static nano_ip_error_t NANO_IP_SLAB_PACKET_ALLOCATOR_Allocate(void* const allocator_data, nano_ip_net_packet_t** const packet, const uint16_t size)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+    slab_packet_allocator_data_t* allocator = NANO_IP_CAST(slab_packet_allocator_data_t*, allocator_data);
+
+    /* Check parameters */
+    if ((allocator != NULL) && (packet != NULL))
+    {
+        uint8_t class_index = 0u;
+        slab_buffer_desc_t* buffer = NULL;
+
+        /* Lock allocator */
+        (void)NANO_IP_OAL_MUTEX_Lock(&allocator->mutex);
+
+        /* Look for the best fitting class */
+        while ((class_index < allocator->classes_count) && (allocator->classes[class_index].buffer_size < size))
+        {
+            class_index++;
+        }
+        if (class_index < allocator->classes_count)
+        {
+            /* Take the first free buffer of the best fitting class or of the next bigger ones */
+            slab_packet_allocator_class_t* const best_fit_class = &allocator->classes[class_index];
+            while ((class_index < allocator->classes_count) && (buffer == NULL))
+            {
+                slab_packet_allocator_class_t* const size_class = &allocator->classes[class_index];
+                if (size_class->free_buffers != NULL)
+                {
+                    /* Remove the buffer from the free buffers list */
+                    buffer = size_class->free_buffers;
+                    size_class->free_buffers = buffer->next;
+                    buffer->next = NULL;
+                    buffer->used = true;
+
+                    /* Update statistics */
+                    size_class->stats.allocations++;
+                    size_class->stats.used_count++;
+                    if (size_class->stats.used_count > size_class->stats.high_watermark)
+                    {
+                        size_class->stats.high_watermark = size_class->stats.used_count;
+                    }
+                    if (size_class != best_fit_class)
+                    {
+                        best_fit_class->stats.fallbacks++;
+                    }
+                }
+                else
+                {
+                    /* Try a bigger class */
+                    class_index++;
+                }
+            }
+
+            if (buffer != NULL)
+            {
+                /* Fill packet information */
+                nano_ip_net_packet_t* const pkt = &buffer->packet;
+                pkt->data = buffer->data;
+                pkt->current = NANO_IP_CAST(uint8_t*, pkt->data);
+                pkt->size = size;
+                pkt->count = 0u;
+                pkt->flags = 0u;
+                pkt->allocator_data = buffer;
+                pkt->net_if = NULL;
+                pkt->segments = NULL;
+                pkt->ref_count = 1u;
+                (*packet) = pkt;
+
+                ret = NIP_ERR_SUCCESS;
+            }
+            else
+            {
+                /* All the fitting classes are exhausted */
+                best_fit_class->stats.failures++;
+                ret = NIP_ERR_RESOURCE;
+            }
+        }
+        else
+        {
+            /* Buffer too big to be allocated */
+            ret = NIP_ERR_PACKET_TOO_BIG;
+        }
+
+        /* Unlock allocator */
+        (void)NANO_IP_OAL_MUTEX_Unlock(&allocator->mutex);
+    }
+
+    return ret;
+}
+
+/** \brief Release a packet */
+static nano_ip_error_t NANO_IP_SLAB_PACKET_ALLOCATOR_Release(void* const allocator_data, nano_ip_net_packet_t* const packet)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+    slab_packet_allocator_data_t* allocator = NANO_IP_CAST(slab_packet_allocator_data_t*, allocator_data);
+    
+    /* Check parameters */
+    if ((allocator != NULL) && (packet != NULL) && (packet->allocator_data != NULL))
+    {
+        slab_buffer_desc_t* const buffer = NANO_IP_CAST(slab_buffer_desc_t*, packet->allocator_data);
+
+        /* Check that the packet has been allocated by this allocator */
+        if (!NANO_IP_SLAB_PACKET_ALLOCATOR_IsOwned(allocator, buffer) || (packet != &buffer->packet))
+        {
+            /* Packet from another allocator */
+            ret = NIP_ERR_PACKET_NOT_FOUND;
+        }
+        /* Drop a reference, the buffer is released with the last one */
+        else if (!NANO_IP_PACKET_Unref(packet))
+        {
+            /* Packet is still in use */
+            ret = NIP_ERR_SUCCESS;
+        }
+        else
+        {
+            /* Release the payload segments */
+            NANO_IP_PACKET_ReleaseSegments(packet);
+
+            /* Lock allocator */
+            (void)NANO_IP_OAL_MUTEX_Lock(&allocator->mutex);
+
+            /* Check that the buffer is allocated */
+            if (buffer->used)
+            {
+                /* Add the buffer to the free buffers list of its class */
+                slab_packet_allocator_class_t* const size_class = buffer->size_class;
+                buffer->used = false;
+                buffer->next = size_class->free_buffers;
+                size_class->free_buffers = buffer;
+
+                /* Update statistics */
+                size_class->stats.used_count--;
+
+                ret = NIP_ERR_SUCCESS;
+            }
+            else
+            {
+                /* Buffer already released */
+                ret = NIP_ERR_PACKET_NOT_FOUND;
+            }
+
+            /* Unlock allocator */
+            (void)NANO_IP_OAL_MUTEX_Unlock(&allocator->mutex);
+        }
+    }
+
+    return ret;
+}
+
+/** \brief Check that a buffer description belongs to one of the size classes of the allocator */
+static bool NANO_IP_SLAB_PACKET_ALLOCATOR_IsOwned(const slab_packet_allocator_data_t* const allocator, const slab_buffer_desc_t* const buffer)
+{
+    bool owned = false;
+    uint8_t class_index = 0u;
+    const size_t address = NANO_IP_CAST(size_t, buffer);
+
+    /* The buffer description must be an element of the descriptions array of its size class */
+    while ((class_index < allocator->classes_count) && !owned)
+    {
+        const slab_packet_allocator_class_t* const size_class = &allocator->classes[class_index];
+        const size_t first = NANO_IP_CAST(size_t, size_class->buffers_descs);
+        if ((address >= first) &&
+            (address < (first + (size_class->buffers_count * sizeof(slab_buffer_desc_t)))) &&
+            (((address - first) % sizeof(slab_buffer_desc_t)) == 0u))
+        {
+            owned = (buffer->size_class == size_class);
+        }
+        class_index++;
+    }
+
+    return owned;
+}
@@ -0,0 +1,152 @@
+/*
+Copyright(c) 2017 Cedric Jimenez
+
+This file is part of Nano-IP.
+
+Nano-IP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Nano-IP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with Nano-IP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef NANO_IP_SLAB_PACKET_ALLOCATOR_H
+#define NANO_IP_SLAB_PACKET_ALLOCATOR_H
+
+#include "nano_ip_oal.h"
+#include "nano_ip_packet_allocator.h"
+
+
+
+/** \brief Helper macro to instanciate the buffers of a size class of the slab packet allocator with section placement and alignment */
+#define STATIC_INSTANCE_SLAB_PACKET_ALLOCATOR_CLASS_WITH_PLACEMENT(_name, _buffer_size, _buffer_count, _section, alignment) \
+                                    \
+                                    static uint8_t _name##_buffers[(_buffer_count) * (_buffer_size)] __attribute__ ((section (_section))) __attribute__((aligned(alignment))); \
+                                    static slab_buffer_desc_t _name##_buffers_descs[(_buffer_count)] __attribute__ ((section (_section)))
+
+
+/** \brief Helper macro to instanciate the buffers of a size class of the slab packet allocator */
+#define STATIC_INSTANCE_SLAB_PACKET_ALLOCATOR_CLASS(_name, _buffer_size, _buffer_count) \
+                                    \
+                                    static uint8_t _name##_buffers[(_buffer_count) * (_buffer_size)]; \
+                                    static slab_buffer_desc_t _name##_buffers_descs[(_buffer_count)]
+
+
+/** \brief Helper macro to initialize a size class of the slab packet allocator (classes must be sorted by increasing buffer size) */
+#define SLAB_PACKET_ALLOCATOR_CLASS_INIT(_class, _name, _buffer_size, _buffer_count) \
+                                    \
+                                    (_class).buffer_size = (_buffer_size); \
+                                    (_class).buffers_count = (_buffer_count); \
+                                    (_class).buffers = _name##_buffers; \
+                                    (_class).buffers_descs = _name##_buffers_descs
+
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+/* Pre-declaration of a size class */
+typedef struct _slab_packet_allocator_class_t slab_packet_allocator_class_t;
+
+
+/** \brief Buffer description */
+typedef struct _slab_buffer_desc_t
+{
+    /** \brief Data */
+    void* data;
+    /** \brief Packet */
+    nano_ip_net_packet_t packet;
+    /** \brief Size class of the buffer */
+    slab_packet_allocator_class_t* size_class;
+    /** \brief Indicate if the buffer is allocated */
+    bool used;
+    /** \brief Next free buffer */
+    struct _slab_buffer_desc_t* next;
+} slab_buffer_desc_t;
+
+
+/** \brief Statistics of a size class */
+typedef struct _slab_packet_allocator_stats_t
+{
+    /** \brief Number of allocations served by the class */
+    uint32_t allocations;
+    /** \brief Number of allocations which best fitted the class and have been served by a bigger class because the class was exhausted */
+    uint32_t fallbacks;
+    /** \brief Number of allocations which best fitted the class and could not be served by any class */
+    uint32_t failures;
+    /** \brief Number of buffers currently allocated */
+    uint16_t used_count;
+    /** \brief Maximum number of buffers allocated at the same time */
+    uint16_t high_watermark;
+} slab_packet_allocator_stats_t;
+
+
+/** \brief Size class of the slab packet allocator */
+struct _slab_packet_allocator_class_t
+{
+    /* To be initialized by the application befor calling init() function */
+
+    /** \brief Buffer size in bytes */
+    uint16_t buffer_size;
+    /** \brief Number of buffers */
+    uint16_t buffers_count;
+    /** \brief Pointer to the buffers array */
+    uint8_t* buffers;
+    /** \brief Pointer to the buffers descriptions array */
+    slab_buffer_desc_t* buffers_descs;
+
+
+    /* Initialized by the slab packet allocator */
+
+    /** \brief Free buffers list */
+    slab_buffer_desc_t* free_buffers;
+    /** \brief Statistics */
+    slab_packet_allocator_stats_t stats;
+};
+
+
+/** \brief Init data for the slab packet allocator */
+typedef struct _slab_packet_allocator_data_t
+{
+    /* To be initialized by the application befor calling init() function */
+
+    /** \brief Size classes, sorted by increasing buffer size */
+    slab_packet_allocator_class_t* classes;
+    /** \brief Number of size classes */
+    uint8_t classes_count;
+
+
+    /* Initialized by the slab packet allocator */
+
+    /** \brief Mutex */
+    oal_mutex_t mutex;
+
+} slab_packet_allocator_data_t;
+
+
+
+
+/** \brief Initialize the packet allocator */
+nano_ip_error_t NANO_IP_SLAB_PACKET_ALLOCATOR_Init(nano_ip_net_packet_allocator_t* const allocator, slab_packet_allocator_data_t* const allocator_data);
+
+/** \brief Get the statistics of a size class */
+nano_ip_error_t NANO_IP_SLAB_PACKET_ALLOCATOR_GetStats(slab_packet_allocator_data_t* const allocator_data, const uint8_t class_index, slab_packet_allocator_stats_t* const stats);
+
+/** \brief Reset the statistics of all the size classes (the current usage is kept) */
+nano_ip_error_t NANO_IP_SLAB_PACKET_ALLOCATOR_ResetStats(slab_packet_allocator_data_t* const allocator_data);
+
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+
+#endif /* NANO_IP_SLAB_PACKET_ALLOCATOR_H */
@@ -20,8 +20,25 @@ along with Nano-IP.  If not, see <http://www.gnu.org/licenses/>.
 #include "nano_ip_tools.h"
 #include "nano_ip_ipv4.h"
 
+/* The vector kernel of the internet checksum is selected at compile time from the target features
+   enabled on the compiler command line, the portable scalar kernel is used otherwise and in
+   unoptimized builds where the intrinsics are not inlined */
+#if defined(__OPTIMIZE__) && defined(__AVX2__)
+#define INTERNET_CS_AVX2        1u
+#include <immintrin.h>
+#elif defined(__OPTIMIZE__) && defined(__SSE2__)
+#define INTERNET_CS_SSE2        1u
+#include <emmintrin.h>
+#elif defined(__OPTIMIZE__) && defined(__ARM_NEON)
+#define INTERNET_CS_NEON        1u
+#include <arm_neon.h>
+#endif /* __OPTIMIZE__ */
 
 
+
+/** \brief Compute the one's complement sum of the 16 bits words of a buffer, folded to 16 bits */
+static uint32_t NANO_IP_SumInternetCS(const uint8_t* const buffer, const uint32_t size);
+
 /** \brief  Writes a character inside the given string */
 static int NANO_IP_PutChar(char *str, char c);
 
@@ -429,32 +446,39 @@ uint32_t NANO_IP_inet_ntoa(const char* addr_str)
 uint16_t NANO_IP_ComputeInternetCS(uint8_t* const pseudo_header, uint16_t pseudo_header_size, uint8_t* const buffer, uint16_t size)
 {
     uint32_t checksum = 0;
-    uint16_t* data = NANO_IP_CAST(uint16_t*, pseudo_header);
 
     /* Compute sum on pseudo header */
-    if (data != NULL)
+    if (pseudo_header != NULL)
     {
-        while (pseudo_header_size > 1)
-        {
-            checksum += (*data);
-            data++;
-            pseudo_header_size -= sizeof(uint16_t);
-        }
+        checksum = NANO_IP_SumInternetCS(pseudo_header, pseudo_header_size);
     }
 
     /* Compute sum */
-    data = NANO_IP_CAST(uint16_t*, buffer);
-    while (size > 1)
-    {
-        checksum += (*data);
-        data++;
-        size -= sizeof(uint16_t);
-    }
-    if (size != 0)
+    checksum += NANO_IP_SumInternetCS(buffer, size);
+
+    return NANO_IP_FinalizeInternetCS(checksum);
+}
+
+/** \brief Add a buffer to a partial internet checksum sum (offset is the number of bytes already added to the sum) */
+uint32_t NANO_IP_AddToInternetCS(uint32_t sum, const uint8_t* const buffer, const uint16_t size, const uint32_t offset)
+{
+    /* Compute sum */
+    uint32_t checksum = NANO_IP_SumInternetCS(buffer, size);
+
+    /* A buffer starting at an odd offset has its bytes swapped in the 16 bits words of the sum */
+    if ((offset & 1u) != 0u)
     {
-        checksum += *NANO_IP_CAST(uint8_t*, data);
+        checksum = ((checksum & 0x00FFu) << 8u) | (checksum >> 8u);
     }
 
+    return (sum + checksum);
+}
+
+/** \brief Compute the internet checksum from a partial sum */
+uint16_t NANO_IP_FinalizeInternetCS(uint32_t sum)
+{
+    uint32_t checksum = sum;
+
      /*  Fold 32-bit sum to 16 bits */
     while ((checksum >> 16u) != 0)
     {
@@ -468,6 +492,128 @@ uint16_t NANO_IP_ComputeInternetCS(uint8_t* const pseudo_header, uint16_t pseudo
 }
 
 
+/** \brief Compute the one's complement sum of the 16 bits words of a buffer, folded to 16 bits */
+static uint32_t NANO_IP_SumInternetCS(const uint8_t* const buffer, const uint32_t size)
+{
+    union
+    {
+        uint16_t value;
+        uint8_t bytes[2u];
+    } word;
+    uint64_t sum = 0u;
+    uint32_t checksum;
+    const uint8_t* data = buffer;
+    uint32_t remaining = size;
+    const bool odd_address = ((NANO_IP_CAST(size_t, data) & 1u) != 0u);
+
+    /* A buffer at an odd address is summed as if it were preceded by a null byte so that the
+       next loads are aligned: this swaps the bytes of the sum, they are swapped back at the end */
+    if (odd_address && (remaining != 0u))
+    {
+        word.bytes[0u] = 0u;
+        word.bytes[1u] = data[0u];
+        sum += word.value;
+        data++;
+        remaining--;
+    }
+    if (((NANO_IP_CAST(size_t, data) & 2u) != 0u) && (remaining >= sizeof(uint16_t)))
+    {
+        sum += (*NANO_IP_CAST(const uint16_t*, data));
+        data += sizeof(uint16_t);
+        remaining -= sizeof(uint16_t);
+    }
+
+    /* Sum 32 bits words into 64 bits accumulators, the carries are only folded at the end
+       (the folded sum of the 32 bits words is the sum of their 16 bits halves) */
+    #if defined(INTERNET_CS_AVX2)
+    {
+        /* 8 words per iteration, each 64 bits lane receives 2 words */
+        const __m256i zero = _mm256_setzero_si256();
+        __m256i acc = zero;
+        uint64_t lanes[4u];
+        while (remaining >= sizeof(__m256i))
+        {
+            const __m256i words = _mm256_loadu_si256(NANO_IP_CAST(const __m256i*, data));
+            acc = _mm256_add_epi64(acc, _mm256_add_epi64(_mm256_unpacklo_epi32(words, zero), _mm256_unpackhi_epi32(words, zero)));
+            data += sizeof(__m256i);
+            remaining -= sizeof(__m256i);
+        }
+        _mm256_storeu_si256(NANO_IP_CAST(__m256i*, lanes), acc);
+        sum += lanes[0u] + lanes[1u] + lanes[2u] + lanes[3u];
+    }
+    #elif defined(INTERNET_CS_SSE2)
+    {
+        /* 4 words per iteration, each 64 bits lane receives 2 words */
+        const __m128i zero = _mm_setzero_si128();
+        __m128i acc = zero;
+        uint64_t lanes[2u];
+        while (remaining >= sizeof(__m128i))
+        {
+            const __m128i words = _mm_loadu_si128(NANO_IP_CAST(const __m128i*, data));
+            acc = _mm_add_epi64(acc, _mm_add_epi64(_mm_unpacklo_epi32(words, zero), _mm_unpackhi_epi32(words, zero)));
+            data += sizeof(__m128i);
+            remaining -= sizeof(__m128i);
+        }
+        _mm_storeu_si128(NANO_IP_CAST(__m128i*, lanes), acc);
+        sum += lanes[0u] + lanes[1u];
+    }
+    #elif defined(INTERNET_CS_NEON)
+    {
+        /* 4 words per iteration, pairwise added into 2 lanes of 64 bits */
+        uint64x2_t acc = vdupq_n_u64(0u);
+        while (remaining >= sizeof(uint32x4_t))
+        {
+            acc = vpadalq_u32(acc, vld1q_u32(NANO_IP_CAST(const uint32_t*, data)));
+            data += sizeof(uint32x4_t);
+            remaining -= sizeof(uint32x4_t);
+        }
+        sum += vgetq_lane_u64(acc, 0) + vgetq_lane_u64(acc, 1);
+    }
+    #endif /* INTERNET_CS_AVX2 */
+    while (remaining >= (4u * sizeof(uint32_t)))
+    {
+        const uint32_t* const words = NANO_IP_CAST(const uint32_t*, data);
+        sum += NANO_IP_CAST(uint64_t, words[0u]) + words[1u] + words[2u] + words[3u];
+        data += 4u * sizeof(uint32_t);
+        remaining -= 4u * sizeof(uint32_t);
+    }
+    while (remaining >= sizeof(uint32_t))
+    {
+        sum += (*NANO_IP_CAST(const uint32_t*, data));
+        data += sizeof(uint32_t);
+        remaining -= sizeof(uint32_t);
+    }
+    if (remaining >= sizeof(uint16_t))
+    {
+        sum += (*NANO_IP_CAST(const uint16_t*, data));
+        data += sizeof(uint16_t);
+        remaining -= sizeof(uint16_t);
+    }
+    if (remaining != 0u)
+    {
+        /* Last byte padded with a null byte */
+        word.bytes[0u] = data[0u];
+        word.bytes[1u] = 0u;
+        sum += word.value;
+    }
+
+    /* Fold 64-bit sum to 16 bits */
+    sum = (sum & 0xFFFFFFFFu) + (sum >> 32u);
+    sum = (sum & 0xFFFFFFFFu) + (sum >> 32u);
+    checksum = NANO_IP_CAST(uint32_t, sum);
+    checksum = (checksum & 0x0000FFFFu) + (checksum >> 16u);
+    checksum = (checksum & 0x0000FFFFu) + (checksum >> 16u);
+
+    /* Swap back the bytes of the sum of a buffer at an odd address */
+    if (odd_address)
+    {
+        checksum = ((checksum & 0x00FFu) << 8u) | (checksum >> 8u);
+    }
+
+    return checksum;
+}
+
+
 /** \brief  Writes a character inside the given string */
 static int NANO_IP_PutChar(char *str, char c)
 {
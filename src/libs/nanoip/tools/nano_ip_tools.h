@@ -187,6 +187,12 @@ uint32_t NANO_IP_inet_ntoa(const char* addr_str);
 /** \brief Compute the internet checksum of a buffer */
 uint16_t NANO_IP_ComputeInternetCS(uint8_t* const pseudo_header, uint16_t pseudo_header_size, uint8_t* const buffer, uint16_t size);
 
+/** \brief Add a buffer to a partial internet checksum sum (offset is the number of bytes already added to the sum) */
+uint32_t NANO_IP_AddToInternetCS(uint32_t sum, const uint8_t* const buffer, const uint16_t size, const uint32_t offset);
+
+/** \brief Compute the internet checksum from a partial sum */
+uint16_t NANO_IP_FinalizeInternetCS(uint32_t sum);
+
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,1179 @@
+/*
+Copyright(c) 2017 Cedric Jimenez
+
+This file is part of Nano-IP.
+
+Nano-IP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Nano-IP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with Nano-IP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdlib.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <net/if.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/eventfd.h>
+#include <sys/epoll.h>
+#include <arpa/inet.h>
+#include <linux/if_packet.h>
+#include <linux/if_ether.h>
+
+#include "nano_ip_af_packet.h"
+
+#include "nano_ip_tools.h"
+#include "nano_ip_oal.h"
+#include "nano_ip_log.h"
+#include "nano_ip_packet_funcs.h"
+
+
+/** \brief Size in bytes of a RX ring block */
+#define AF_PACKET_RX_BLOCK_SIZE         (1u << 17u)
+
+/** \brief Number of RX ring blocks */
+#define AF_PACKET_RX_BLOCK_COUNT        16u
+
+/** \brief Size in bytes of a RX ring frame (only used by the kernel to check the ring geometry) */
+#define AF_PACKET_RX_FRAME_SIZE         2048u
+
+/** \brief Timeout in milliseconds after which the kernel hands a partially filled RX block to the driver */
+#define AF_PACKET_RX_BLOCK_TIMEOUT      2u
+
+/** \brief Maximum number of RX ring frames loaned to the stack at the same time */
+#define AF_PACKET_RX_LOAN_COUNT         512u
+
+/** \brief Size in bytes of a TX ring block */
+#define AF_PACKET_TX_BLOCK_SIZE         (1u << 16u)
+
+/** \brief Number of TX ring blocks */
+#define AF_PACKET_TX_BLOCK_COUNT        8u
+
+/** \brief Size in bytes of a TX ring frame */
+#define AF_PACKET_TX_FRAME_SIZE         2048u
+
+/** \brief Number of TX ring frames */
+#define AF_PACKET_TX_FRAME_COUNT        ((AF_PACKET_TX_BLOCK_SIZE / AF_PACKET_TX_FRAME_SIZE) * AF_PACKET_TX_BLOCK_COUNT)
+
+/** \brief Offset in bytes of the data in a TX ring frame */
+#define AF_PACKET_TX_DATA_OFFSET        (TPACKET3_HDRLEN - sizeof(struct sockaddr_ll))
+
+/** \brief Timeout in milliseconds of the driver task's wait */
+#define AF_PACKET_POLL_TIMEOUT          100
+
+
+/** \brief RX ring block */
+typedef struct _af_packet_rx_block_t
+{
+    /** \brief Block descriptor in the ring */
+    struct tpacket_block_desc* desc;
+    /** \brief Number of frames of the block loaned to the stack */
+    uint32_t loans;
+    /** \brief Indicate that all the frames of the block have been walked and that the block waits for its loans to be returned */
+    bool walked;
+} af_packet_rx_block_t;
+
+/** \brief AF_PACKET driver data */
+typedef struct _af_packet_drv_t
+{
+    /** \brief Interface's name */
+    const char* name;
+    /** \brief Callbacks */
+    net_driver_callbacks_t callbacks;
+    /** \brief List of available rx packets (used when no loan descriptor is available) */
+    nano_ip_packet_queue_t rx_packets;
+    /** \brief List of available loan descriptors */
+    nano_ip_packet_queue_t rx_loans;
+    /** \brief List of received packets */
+    nano_ip_packet_queue_t received_packets;
+    /** \brief List of transmitted packets */
+    nano_ip_packet_queue_t transmitted_packets;
+    /** \brief Interface's mutex */
+    oal_mutex_t mutex;
+    /** \brief Task */
+    oal_task_t task;
+    /** \brief Packet socket */
+    int socket;
+    /** \brief Event used to wake up the task */
+    int event;
+    #if (NANO_IP_ENABLE_RUN_TO_COMPLETION != 0u)
+    /** \brief Epoll instance gathering the socket and the wake up event, used as handle of the stack poll */
+    int poll_fd;
+    #endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
+    /** \brief Indicate if the driver is running */
+    bool running;
+    /** \brief RX and TX rings */
+    uint8_t* rings;
+    /** \brief RX ring blocks */
+    af_packet_rx_block_t rx_blocks[AF_PACKET_RX_BLOCK_COUNT];
+    /** \brief Index of the RX block being walked */
+    uint32_t rx_block;
+    /** \brief Next frame to walk in the RX block, NULL if the block walk has not started */
+    struct tpacket3_hdr* rx_frame;
+    /** \brief Number of frames left to walk in the RX block */
+    uint32_t rx_frames_left;
+    /** \brief Indicate that the RX walk is stopped until a loan descriptor or a rx packet is returned */
+    bool rx_starved;
+    /** \brief Indicate if the reception notifications are disabled */
+    bool rx_notification_disabled;
+    /** \brief Loan descriptors to give the RX ring frames to the stack without copy */
+    nano_ip_net_packet_t rx_loan_descs[AF_PACKET_RX_LOAN_COUNT];
+    /** \brief TX ring */
+    uint8_t* tx_ring;
+    /** \brief Index of the next TX frame */
+    uint32_t tx_frame;
+    /** \brief Number of TX frames waiting for the transmission to be kicked */
+    uint32_t tx_requests;
+    /** \brief Network interface driver */
+    nano_ip_net_driver_t* driver;
+} af_packet_drv_t;
+
+
+
+/** \brief Init the AF_PACKET interface driver */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvInit(void* const user_data, net_driver_callbacks_t* const callbacks);
+/** \brief Start the AF_PACKET interface driver */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvStart(void* const user_data);
+/** \brief Stop the AF_PACKET interface driver */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvStop(void* const user_data);
+/** \brief Set the MAC address */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvSetMacAddress(void* const user_data, const uint8_t* const mac_address);
+/** \brief Set the IPv4 address */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvSetIPv4Address(void* const user_data, const ipv4_address_t ipv4_address, const ipv4_address_t ipv4_netmask);
+/** \brief Send a packet on the AF_PACKET interface driver */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvSendPacket(void* const user_data, nano_ip_net_packet_t* const packet);
+/** \brief Add a packet for reception for the AF_PACKET interface driver */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvAddRxPacket(void* const user_data, nano_ip_net_packet_t* const packet);
+/** \brief Get the last received packet on the AF_PACKET interface driver */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvGetNextRxPacket(void* const user_data, nano_ip_net_packet_t** const packet);
+/** \brief Get the last sent packet on the AF_PACKET interface driver */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvGetNextTxPacket(void* const user_data, nano_ip_net_packet_t** const packet);
+/** \brief Get the link state of the AF_PACKET interface driver */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvGetLinkState(void* const user_data, net_link_state_t* const state);
+/** \brief Enable or disable the reception notifications of the AF_PACKET interface driver */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvSetRxNotification(void* const user_data, const bool enabled);
+/** \brief Send a queue of packets on the AF_PACKET interface driver */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvSendPackets(void* const user_data, nano_ip_packet_queue_t* const packets);
+/** \brief Add a queue of packets for reception for the AF_PACKET interface driver */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvAddRxPackets(void* const user_data, nano_ip_packet_queue_t* const packets);
+/** \brief Get the last received packets on the AF_PACKET interface driver */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvGetNextRxPackets(void* const user_data, nano_ip_packet_queue_t* const packets, const uint32_t max_count);
+/** \brief Get the last sent packets on the AF_PACKET interface driver */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvGetNextTxPackets(void* const user_data, nano_ip_packet_queue_t* const packets, const uint32_t max_count);
+#if (NANO_IP_ENABLE_RUN_TO_COMPLETION != 0u)
+/** \brief Process the events of the AF_PACKET interface driver in the caller's context */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvPoll(void* const user_data);
+/** \brief Get the poll handle of the AF_PACKET interface driver */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvGetPollHandle(void* const user_data, oal_poll_handle_t* const handle);
+#endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
+
+
+/** \brief Open the packet socket and map its rings */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvOpenSocket(af_packet_drv_t* const af_packet_drv_inst);
+/** \brief Close the packet socket and unmap its rings */
+static void NANO_IP_AF_PACKET_DrvCloseSocket(af_packet_drv_t* const af_packet_drv_inst);
+/** \brief Copy a packet into the next TX frame (the interface must be locked) */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvQueueTxFrame(af_packet_drv_t* const af_packet_drv_inst, nano_ip_net_packet_t* const packet);
+/** \brief Give a packet back for reception (the interface must be locked) */
+static void NANO_IP_AF_PACKET_DrvReturnRxPacket(af_packet_drv_t* const af_packet_drv_inst, nano_ip_net_packet_t* const packet);
+/** \brief Wake up the driver task */
+static void NANO_IP_AF_PACKET_DrvWakeUp(af_packet_drv_t* const af_packet_drv_inst);
+/** \brief Give a RX block back to the kernel */
+static void NANO_IP_AF_PACKET_DrvReleaseRxBlock(af_packet_rx_block_t* const block);
+/** \brief Walk the RX blocks handed by the kernel, returns true if the stack must be notified of received packets */
+static bool NANO_IP_AF_PACKET_DrvWalkRxBlocks(af_packet_drv_t* const af_packet_drv_inst);
+/** \brief Kick the transmission of the pending TX frames, returns true if frames have been sent */
+static bool NANO_IP_AF_PACKET_DrvKickTx(af_packet_drv_t* const af_packet_drv_inst);
+/** \brief Send the pending TX frames and receive the frames of the RX blocks handed by the kernel */
+static void NANO_IP_AF_PACKET_DrvProcessEvents(af_packet_drv_t* const af_packet_drv_inst);
+#if (NANO_IP_ENABLE_RUN_TO_COMPLETION == 0u)
+/** \brief Driver task */
+static void NANO_IP_AF_PACKET_DrvTask(void* param);
+#endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
+
+
+
+/** \brief Initialize AF_PACKET interface */
+nano_ip_error_t NANO_IP_AF_PACKET_Init(nano_ip_net_if_t* const af_packet_iface, const char* iface_name)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+
+    /* Check parameters */
+    if ((af_packet_iface != NULL) && (iface_name != NULL))
+    {
+        /* Allocate a driver instance */
+        af_packet_drv_t* af_packet_drv_inst = NANO_IP_CAST(af_packet_drv_t*, malloc(sizeof(af_packet_drv_t)));
+        if (af_packet_drv_inst != NULL)
+        {
+            /* 0 init */
+            MEMSET(af_packet_drv_inst, 0, sizeof(af_packet_drv_t));
+            af_packet_drv_inst->socket = -1;
+            af_packet_drv_inst->event = -1;
+            #if (NANO_IP_ENABLE_RUN_TO_COMPLETION != 0u)
+            af_packet_drv_inst->poll_fd = -1;
+            #endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
+
+            /* Allocate driver */
+            af_packet_drv_inst->driver = NANO_IP_CAST(nano_ip_net_driver_t*, malloc(sizeof(nano_ip_net_driver_t)));
+            if (af_packet_drv_inst->driver != NULL)
+            {
+                uint32_t i;
+
+                /* 0 init */
+                MEMSET(af_packet_drv_inst->driver, 0, sizeof(nano_ip_net_driver_t));
+
+                /* Init driver interface */
+                af_packet_drv_inst->name = iface_name;
+                af_packet_drv_inst->driver->user_data = af_packet_drv_inst;
+                af_packet_drv_inst->driver->caps = NETDRV_CAPS_ETH_MIN_FRAME_SIZE |
+                                                   NETDRV_CAP_ETH_CS_COMPUTATION |
+                                                   NETDRV_CAP_ETH_CS_CHECK |
+                                                   NETDRV_CAP_ETH_FRAME_PADDING |
+                                                   NETDRV_CAP_IPV4_CS_CHECK |
+                                                   NETDRV_CAP_UDPIPV4_CS_CHECK |
+                                                   NETDRV_CAP_TCPIPV4_CS_CHECK |
+                                                   NETDRV_CAP_TX_GATHER;
+
+                af_packet_drv_inst->driver->init = NANO_IP_AF_PACKET_DrvInit;
+                af_packet_drv_inst->driver->start = NANO_IP_AF_PACKET_DrvStart;
+                af_packet_drv_inst->driver->stop = NANO_IP_AF_PACKET_DrvStop;
+                af_packet_drv_inst->driver->set_mac_address = NANO_IP_AF_PACKET_DrvSetMacAddress;
+                af_packet_drv_inst->driver->set_ipv4_address = NANO_IP_AF_PACKET_DrvSetIPv4Address;
+                af_packet_drv_inst->driver->send_packet = NANO_IP_AF_PACKET_DrvSendPacket;
+                af_packet_drv_inst->driver->add_rx_packet = NANO_IP_AF_PACKET_DrvAddRxPacket;
+                af_packet_drv_inst->driver->get_next_rx_packet = NANO_IP_AF_PACKET_DrvGetNextRxPacket;
+                af_packet_drv_inst->driver->get_next_tx_packet = NANO_IP_AF_PACKET_DrvGetNextTxPacket;
+                af_packet_drv_inst->driver->get_link_state = NANO_IP_AF_PACKET_DrvGetLinkState;
+                af_packet_drv_inst->driver->send_packets = NANO_IP_AF_PACKET_DrvSendPackets;
+                af_packet_drv_inst->driver->add_rx_packets = NANO_IP_AF_PACKET_DrvAddRxPackets;
+                af_packet_drv_inst->driver->get_next_rx_packets = NANO_IP_AF_PACKET_DrvGetNextRxPackets;
+                af_packet_drv_inst->driver->get_next_tx_packets = NANO_IP_AF_PACKET_DrvGetNextTxPackets;
+                af_packet_drv_inst->driver->set_rx_notification = NANO_IP_AF_PACKET_DrvSetRxNotification;
+                #if (NANO_IP_ENABLE_RUN_TO_COMPLETION != 0u)
+                af_packet_drv_inst->driver->poll = NANO_IP_AF_PACKET_DrvPoll;
+                af_packet_drv_inst->driver->get_poll_handle = NANO_IP_AF_PACKET_DrvGetPollHandle;
+                #endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
+                af_packet_iface->driver = af_packet_drv_inst->driver;
+
+                /* Init loan descriptors */
+                for (i = 0u; i < AF_PACKET_RX_LOAN_COUNT; i++)
+                {
+                    NANO_IP_PACKET_AddToQueue(&af_packet_drv_inst->rx_loans, &af_packet_drv_inst->rx_loan_descs[i]);
+                }
+
+                /* Create the interface's mutex */
+                ret = NANO_IP_OAL_MUTEX_Create(&af_packet_drv_inst->mutex);
+            }
+            else
+            {
+                free(af_packet_drv_inst);
+                ret = NIP_ERR_RESOURCE;
+            }
+        }
+        else
+        {
+            ret = NIP_ERR_RESOURCE;
+        }
+    }
+
+    return ret;
+}
+
+
+/** \brief Init the AF_PACKET interface driver */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvInit(void* const user_data, net_driver_callbacks_t* const callbacks)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+    af_packet_drv_t* af_packet_drv_inst = NANO_IP_CAST(af_packet_drv_t*, user_data);
+
+    /* Check parameters */
+    if (af_packet_drv_inst != NULL)
+    {
+        (void)MEMCPY(&af_packet_drv_inst->callbacks, callbacks, sizeof(net_driver_callbacks_t));
+        ret = NIP_ERR_SUCCESS;
+
+        #if (NANO_IP_ENABLE_RUN_TO_COMPLETION != 0u)
+        /* Create the epoll instance now, the stack registers it before the driver is started */
+        af_packet_drv_inst->poll_fd = epoll_create1(EPOLL_CLOEXEC);
+        if (af_packet_drv_inst->poll_fd < 0)
+        {
+            NANO_IP_LOG_ERROR("Unable to create the epoll instance of %s (errno = %d)\n", af_packet_drv_inst->name, errno);
+            ret = NIP_ERR_FAILURE;
+        }
+        #endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
+    }
+
+    return ret;
+}
+
+/** \brief Start the AF_PACKET interface driver */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvStart(void* const user_data)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+    af_packet_drv_t* af_packet_drv_inst = NANO_IP_CAST(af_packet_drv_t*, user_data);
+
+    /* Check parameters */
+    if (af_packet_drv_inst != NULL)
+    {
+        /* Open the packet socket */
+        ret = NANO_IP_AF_PACKET_DrvOpenSocket(af_packet_drv_inst);
+        if (ret == NIP_ERR_SUCCESS)
+        {
+            af_packet_drv_inst->running = true;
+
+            #if (NANO_IP_ENABLE_RUN_TO_COMPLETION == 0u)
+            /* Create the driver task */
+            ret = NANO_IP_OAL_TASK_Create(&af_packet_drv_inst->task, "AF_PACKET Driver Task", NANO_IP_AF_PACKET_DrvTask, af_packet_drv_inst);
+            if (ret != NIP_ERR_SUCCESS)
+            {
+                af_packet_drv_inst->running = false;
+                NANO_IP_AF_PACKET_DrvCloseSocket(af_packet_drv_inst);
+            }
+            #endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
+        }
+    }
+
+    return ret;
+}
+
+/** \brief Stop the AF_PACKET interface driver */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvStop(void* const user_data)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+    af_packet_drv_t* af_packet_drv_inst = NANO_IP_CAST(af_packet_drv_t*, user_data);
+
+    /* Check parameters */
+    if (af_packet_drv_inst != NULL)
+    {
+        #if (NANO_IP_ENABLE_RUN_TO_COMPLETION != 0u)
+        /* No driver task, the driver is stopped in the stack context */
+        af_packet_drv_inst->running = false;
+        NANO_IP_AF_PACKET_DrvCloseSocket(af_packet_drv_inst);
+        #else
+        /* Stop the driver task, it will close the socket */
+        af_packet_drv_inst->running = false;
+        NANO_IP_AF_PACKET_DrvWakeUp(af_packet_drv_inst);
+        #endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
+
+        ret = NIP_ERR_SUCCESS;
+    }
+
+    return ret;
+}
+
+/** \brief Set the MAC address */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvSetMacAddress(void* const user_data, const uint8_t* const mac_address)
+{
+    /* No need to configure MAC address, the socket is in promiscuous mode */
+    (void)user_data;
+    (void)mac_address;
+    return NIP_ERR_SUCCESS;
+}
+
+/** \brief Set the IPv4 address */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvSetIPv4Address(void* const user_data, const ipv4_address_t ipv4_address, const ipv4_address_t ipv4_netmask)
+{
+    /* No need to configure IPV4 address for a packet socket */
+    (void)user_data;
+    (void)ipv4_address;
+    (void)ipv4_netmask;
+    return NIP_ERR_SUCCESS;
+}
+
+/** \brief Send a packet on the AF_PACKET interface driver */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvSendPacket(void* const user_data, nano_ip_net_packet_t* const packet)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+    af_packet_drv_t* af_packet_drv_inst = NANO_IP_CAST(af_packet_drv_t*, user_data);
+
+    /* Check parameters */
+    if ((af_packet_drv_inst != NULL) && (packet != NULL))
+    {
+        bool wake_up;
+
+        /* Lock interface */
+        (void)NANO_IP_OAL_MUTEX_Lock(&af_packet_drv_inst->mutex);
+
+        /* Copy the packet, the transmission is kicked by the driver task so that all
+           the frames queued in the meantime are sent with a single system call */
+        wake_up = (af_packet_drv_inst->tx_requests == 0u);
+        ret = NANO_IP_AF_PACKET_DrvQueueTxFrame(af_packet_drv_inst, packet);
+        wake_up = (wake_up && (ret == NIP_ERR_SUCCESS));
+
+        /* Unlock interface */
+        (void)NANO_IP_OAL_MUTEX_Unlock(&af_packet_drv_inst->mutex);
+
+        /* Wake up the driver task */
+        if (wake_up)
+        {
+            NANO_IP_AF_PACKET_DrvWakeUp(af_packet_drv_inst);
+        }
+    }
+
+    return ret;
+}
+
+/** \brief Add a packet for reception for the AF_PACKET interface driver */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvAddRxPacket(void* const user_data, nano_ip_net_packet_t* const packet)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+    af_packet_drv_t* af_packet_drv_inst = NANO_IP_CAST(af_packet_drv_t*, user_data);
+
+    /* Check parameters */
+    if ((af_packet_drv_inst != NULL) && (packet != NULL))
+    {
+        bool wake_up;
+
+        /* Lock interface */
+        (void)NANO_IP_OAL_MUTEX_Lock(&af_packet_drv_inst->mutex);
+
+        /* Give the packet back */
+        NANO_IP_AF_PACKET_DrvReturnRxPacket(af_packet_drv_inst, packet);
+
+        /* Resume the RX walk if it was waiting for a descriptor */
+        wake_up = af_packet_drv_inst->rx_starved;
+        af_packet_drv_inst->rx_starved = false;
+
+        /* Unlock interface */
+        (void)NANO_IP_OAL_MUTEX_Unlock(&af_packet_drv_inst->mutex);
+
+        if (wake_up)
+        {
+            NANO_IP_AF_PACKET_DrvWakeUp(af_packet_drv_inst);
+        }
+
+        ret = NIP_ERR_SUCCESS;
+    }
+
+    return ret;
+}
+
+/** \brief Get the last received packet on the AF_PACKET interface driver */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvGetNextRxPacket(void* const user_data, nano_ip_net_packet_t** const packet)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+    af_packet_drv_t* af_packet_drv_inst = NANO_IP_CAST(af_packet_drv_t*, user_data);
+
+    /* Check parameters */
+    if ((af_packet_drv_inst != NULL) && (packet != NULL))
+    {
+        /* Lock interface */
+        (void)NANO_IP_OAL_MUTEX_Lock(&af_packet_drv_inst->mutex);
+
+        /* Remove last received packet from the list */
+        (*packet) = NANO_IP_PACKET_PopFromQueue(&af_packet_drv_inst->received_packets);
+        if ((*packet) != NULL)
+        {
+            ret = NIP_ERR_SUCCESS;
+        }
+        else
+        {
+            ret = NIP_ERR_PACKET_NOT_FOUND;
+        }
+
+        /* Unlock interface */
+        (void)NANO_IP_OAL_MUTEX_Unlock(&af_packet_drv_inst->mutex);
+    }
+
+    return ret;
+}
+
+/** \brief Get the last sent packet on the AF_PACKET interface driver */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvGetNextTxPacket(void* const user_data, nano_ip_net_packet_t** const packet)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+    af_packet_drv_t* af_packet_drv_inst = NANO_IP_CAST(af_packet_drv_t*, user_data);
+
+    /* Check parameters */
+    if ((af_packet_drv_inst != NULL) && (packet != NULL))
+    {
+        /* Lock interface */
+        (void)NANO_IP_OAL_MUTEX_Lock(&af_packet_drv_inst->mutex);
+
+        /* Remove last transmitted packet from the list */
+        (*packet) = NANO_IP_PACKET_PopFromQueue(&af_packet_drv_inst->transmitted_packets);
+        if ((*packet) != NULL)
+        {
+            ret = NIP_ERR_SUCCESS;
+        }
+        else
+        {
+            ret = NIP_ERR_PACKET_NOT_FOUND;
+        }
+
+        /* Unlock interface */
+        (void)NANO_IP_OAL_MUTEX_Unlock(&af_packet_drv_inst->mutex);
+    }
+
+    return ret;
+}
+
+
+/** \brief Send a queue of packets on the AF_PACKET interface driver */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvSendPackets(void* const user_data, nano_ip_packet_queue_t* const packets)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+    af_packet_drv_t* af_packet_drv_inst = NANO_IP_CAST(af_packet_drv_t*, user_data);
+
+    /* Check parameters */
+    if ((af_packet_drv_inst != NULL) && (packets != NULL))
+    {
+        bool wake_up;
+        nano_ip_net_packet_t* packet;
+
+        /* Lock interface */
+        (void)NANO_IP_OAL_MUTEX_Lock(&af_packet_drv_inst->mutex);
+
+        /* Copy all the packets, the first error is reported */
+        wake_up = (af_packet_drv_inst->tx_requests == 0u);
+        ret = NIP_ERR_SUCCESS;
+        packet = NANO_IP_PACKET_PopFromQueue(packets);
+        while (packet != NULL)
+        {
+            const nano_ip_error_t err = NANO_IP_AF_PACKET_DrvQueueTxFrame(af_packet_drv_inst, packet);
+            if (ret == NIP_ERR_SUCCESS)
+            {
+                ret = err;
+            }
+            packet = NANO_IP_PACKET_PopFromQueue(packets);
+        }
+        wake_up = (wake_up && (af_packet_drv_inst->tx_requests != 0u));
+
+        /* Unlock interface */
+        (void)NANO_IP_OAL_MUTEX_Unlock(&af_packet_drv_inst->mutex);
+
+        /* Wake up the driver task once for the whole queue */
+        if (wake_up)
+        {
+            NANO_IP_AF_PACKET_DrvWakeUp(af_packet_drv_inst);
+        }
+    }
+
+    return ret;
+}
+
+/** \brief Add a queue of packets for reception for the AF_PACKET interface driver */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvAddRxPackets(void* const user_data, nano_ip_packet_queue_t* const packets)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+    af_packet_drv_t* af_packet_drv_inst = NANO_IP_CAST(af_packet_drv_t*, user_data);
+
+    /* Check parameters */
+    if ((af_packet_drv_inst != NULL) && (packets != NULL))
+    {
+        bool wake_up;
+        nano_ip_net_packet_t* packet;
+
+        /* Lock interface */
+        (void)NANO_IP_OAL_MUTEX_Lock(&af_packet_drv_inst->mutex);
+
+        /* Give the packets back */
+        packet = NANO_IP_PACKET_PopFromQueue(packets);
+        while (packet != NULL)
+        {
+            NANO_IP_AF_PACKET_DrvReturnRxPacket(af_packet_drv_inst, packet);
+            packet = NANO_IP_PACKET_PopFromQueue(packets);
+        }
+
+        /* Resume the RX walk if it was waiting for a descriptor */
+        wake_up = af_packet_drv_inst->rx_starved;
+        af_packet_drv_inst->rx_starved = false;
+
+        /* Unlock interface */
+        (void)NANO_IP_OAL_MUTEX_Unlock(&af_packet_drv_inst->mutex);
+
+        if (wake_up)
+        {
+            NANO_IP_AF_PACKET_DrvWakeUp(af_packet_drv_inst);
+        }
+
+        ret = NIP_ERR_SUCCESS;
+    }
+
+    return ret;
+}
+
+/** \brief Get the last received packets on the AF_PACKET interface driver */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvGetNextRxPackets(void* const user_data, nano_ip_packet_queue_t* const packets, const uint32_t max_count)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+    af_packet_drv_t* af_packet_drv_inst = NANO_IP_CAST(af_packet_drv_t*, user_data);
+
+    /* Check parameters */
+    if ((af_packet_drv_inst != NULL) && (packets != NULL))
+    {
+        uint32_t count = 0u;
+
+        /* Lock interface */
+        (void)NANO_IP_OAL_MUTEX_Lock(&af_packet_drv_inst->mutex);
+
+        /* Move the received packets */
+        ret = NIP_ERR_PACKET_NOT_FOUND;
+        while ((count < max_count) && !NANO_IP_PACKET_QueueIsEmpty(&af_packet_drv_inst->received_packets))
+        {
+            NANO_IP_PACKET_AddToQueue(packets, NANO_IP_PACKET_PopFromQueue(&af_packet_drv_inst->received_packets));
+            ret = NIP_ERR_SUCCESS;
+            count++;
+        }
+
+        /* Unlock interface */
+        (void)NANO_IP_OAL_MUTEX_Unlock(&af_packet_drv_inst->mutex);
+    }
+
+    return ret;
+}
+
+/** \brief Get the last sent packets on the AF_PACKET interface driver */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvGetNextTxPackets(void* const user_data, nano_ip_packet_queue_t* const packets, const uint32_t max_count)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+    af_packet_drv_t* af_packet_drv_inst = NANO_IP_CAST(af_packet_drv_t*, user_data);
+
+    /* Check parameters */
+    if ((af_packet_drv_inst != NULL) && (packets != NULL))
+    {
+        uint32_t count = 0u;
+
+        /* Lock interface */
+        (void)NANO_IP_OAL_MUTEX_Lock(&af_packet_drv_inst->mutex);
+
+        /* Move the transmitted packets */
+        ret = NIP_ERR_PACKET_NOT_FOUND;
+        while ((count < max_count) && !NANO_IP_PACKET_QueueIsEmpty(&af_packet_drv_inst->transmitted_packets))
+        {
+            NANO_IP_PACKET_AddToQueue(packets, NANO_IP_PACKET_PopFromQueue(&af_packet_drv_inst->transmitted_packets));
+            ret = NIP_ERR_SUCCESS;
+            count++;
+        }
+
+        /* Unlock interface */
+        (void)NANO_IP_OAL_MUTEX_Unlock(&af_packet_drv_inst->mutex);
+    }
+
+    return ret;
+}
+
+/** \brief Get the link state of the AF_PACKET interface driver */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvGetLinkState(void* const user_data, net_link_state_t* const state)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+    af_packet_drv_t* af_packet_drv_inst = NANO_IP_CAST(af_packet_drv_t*, user_data);
+
+    /* Check parameters */
+    if ((af_packet_drv_inst != NULL) && (state != NULL))
+    {
+        (*state) = NLS_UP;
+        ret = NIP_ERR_SUCCESS;
+    }
+
+    return ret;
+}
+
+/** \brief Enable or disable the reception notifications of the AF_PACKET interface driver */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvSetRxNotification(void* const user_data, const bool enabled)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+    af_packet_drv_t* af_packet_drv_inst = NANO_IP_CAST(af_packet_drv_t*, user_data);
+
+    /* Check parameters */
+    if (af_packet_drv_inst != NULL)
+    {
+        (void)NANO_IP_OAL_MUTEX_Lock(&af_packet_drv_inst->mutex);
+        af_packet_drv_inst->rx_notification_disabled = !enabled;
+        (void)NANO_IP_OAL_MUTEX_Unlock(&af_packet_drv_inst->mutex);
+        ret = NIP_ERR_SUCCESS;
+    }
+
+    return ret;
+}
+
+#if (NANO_IP_ENABLE_RUN_TO_COMPLETION != 0u)
+
+/** \brief Process the events of the AF_PACKET interface driver in the caller's context */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvPoll(void* const user_data)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+    af_packet_drv_t* af_packet_drv_inst = NANO_IP_CAST(af_packet_drv_t*, user_data);
+
+    /* Check parameters */
+    if (af_packet_drv_inst != NULL)
+    {
+        if (af_packet_drv_inst->running)
+        {
+            /* Acknowledge the wake ups (the event is non-blocking) */
+            uint64_t value;
+            (void)read(af_packet_drv_inst->event, &value, sizeof(value));
+
+            NANO_IP_AF_PACKET_DrvProcessEvents(af_packet_drv_inst);
+        }
+        ret = NIP_ERR_SUCCESS;
+    }
+
+    return ret;
+}
+
+/** \brief Get the poll handle of the AF_PACKET interface driver */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvGetPollHandle(void* const user_data, oal_poll_handle_t* const handle)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+    af_packet_drv_t* af_packet_drv_inst = NANO_IP_CAST(af_packet_drv_t*, user_data);
+
+    /* Check parameters */
+    if ((af_packet_drv_inst != NULL) && (handle != NULL))
+    {
+        (*handle) = af_packet_drv_inst->poll_fd;
+        ret = NIP_ERR_SUCCESS;
+    }
+
+    return ret;
+}
+
+#endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
+
+
+
+/** \brief Open the packet socket and map its rings */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvOpenSocket(af_packet_drv_t* const af_packet_drv_inst)
+{
+    nano_ip_error_t ret = NIP_ERR_FAILURE;
+    const int iface_index = NANO_IP_CAST(int, if_nametoindex(af_packet_drv_inst->name));
+
+    /* Create the socket and the wake up event */
+    af_packet_drv_inst->socket = socket(AF_PACKET, SOCK_RAW, NANO_IP_CAST(int, htons(ETH_P_ALL)));
+    af_packet_drv_inst->event = eventfd(0u, EFD_NONBLOCK);
+    if ((iface_index == 0) || (af_packet_drv_inst->socket < 0) || (af_packet_drv_inst->event < 0))
+    {
+        NANO_IP_LOG_ERROR("Unable to open packet socket on %s (errno = %d)\n", af_packet_drv_inst->name, errno);
+    }
+    else
+    {
+        const int version = TPACKET_V3;
+        const int bypass = 1;
+        struct tpacket_req3 rx_req;
+        struct tpacket_req3 tx_req;
+
+        /* Configure the RX ring, the kernel fills whole blocks of frames */
+        (void)MEMSET(&rx_req, 0, sizeof(rx_req));
+        rx_req.tp_block_size = AF_PACKET_RX_BLOCK_SIZE;
+        rx_req.tp_block_nr = AF_PACKET_RX_BLOCK_COUNT;
+        rx_req.tp_frame_size = AF_PACKET_RX_FRAME_SIZE;
+        rx_req.tp_frame_nr = (AF_PACKET_RX_BLOCK_SIZE / AF_PACKET_RX_FRAME_SIZE) * AF_PACKET_RX_BLOCK_COUNT;
+        rx_req.tp_retire_blk_tov = AF_PACKET_RX_BLOCK_TIMEOUT;
+
+        /* Configure the TX ring */
+        (void)MEMSET(&tx_req, 0, sizeof(tx_req));
+        tx_req.tp_block_size = AF_PACKET_TX_BLOCK_SIZE;
+        tx_req.tp_block_nr = AF_PACKET_TX_BLOCK_COUNT;
+        tx_req.tp_frame_size = AF_PACKET_TX_FRAME_SIZE;
+        tx_req.tp_frame_nr = AF_PACKET_TX_FRAME_COUNT;
+
+        /* Transmitted frames bypass the qdisc layer (optional, ignore failure on older kernels) */
+        (void)setsockopt(af_packet_drv_inst->socket, SOL_PACKET, PACKET_QDISC_BYPASS, &bypass, sizeof(bypass));
+
+        if ((setsockopt(af_packet_drv_inst->socket, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) != 0) ||
+            (setsockopt(af_packet_drv_inst->socket, SOL_PACKET, PACKET_RX_RING, &rx_req, sizeof(rx_req)) != 0) ||
+            (setsockopt(af_packet_drv_inst->socket, SOL_PACKET, PACKET_TX_RING, &tx_req, sizeof(tx_req)) != 0))
+        {
+            NANO_IP_LOG_ERROR("Unable to configure TPACKET_V3 rings on %s (errno = %d)\n", af_packet_drv_inst->name, errno);
+        }
+        else
+        {
+            /* Map the RX ring followed by the TX ring */
+            void* const rings = mmap(NULL, (AF_PACKET_RX_BLOCK_SIZE * AF_PACKET_RX_BLOCK_COUNT) + (AF_PACKET_TX_BLOCK_SIZE * AF_PACKET_TX_BLOCK_COUNT),
+                                     PROT_READ | PROT_WRITE, MAP_SHARED | MAP_LOCKED | MAP_POPULATE, af_packet_drv_inst->socket, 0);
+            if (rings == MAP_FAILED)
+            {
+                NANO_IP_LOG_ERROR("Unable to map packet rings of %s (errno = %d)\n", af_packet_drv_inst->name, errno);
+            }
+            else
+            {
+                struct sockaddr_ll address;
+                struct packet_mreq mreq;
+                uint32_t i;
+
+                af_packet_drv_inst->rings = NANO_IP_CAST(uint8_t*, rings);
+                for (i = 0u; i < AF_PACKET_RX_BLOCK_COUNT; i++)
+                {
+                    af_packet_drv_inst->rx_blocks[i].desc = NANO_IP_CAST(struct tpacket_block_desc*, &af_packet_drv_inst->rings[i * AF_PACKET_RX_BLOCK_SIZE]);
+                    af_packet_drv_inst->rx_blocks[i].loans = 0u;
+                    af_packet_drv_inst->rx_blocks[i].walked = false;
+                }
+                af_packet_drv_inst->tx_ring = &af_packet_drv_inst->rings[AF_PACKET_RX_BLOCK_SIZE * AF_PACKET_RX_BLOCK_COUNT];
+                af_packet_drv_inst->rx_block = 0u;
+                af_packet_drv_inst->rx_frame = NULL;
+                af_packet_drv_inst->tx_frame = 0u;
+                af_packet_drv_inst->tx_requests = 0u;
+
+                /* Bind the socket to the interface */
+                (void)MEMSET(&address, 0, sizeof(address));
+                address.sll_family = AF_PACKET;
+                address.sll_protocol = htons(ETH_P_ALL);
+                address.sll_ifindex = iface_index;
+
+                /* Receive the frames sent to the MAC address of the stack */
+                (void)MEMSET(&mreq, 0, sizeof(mreq));
+                mreq.mr_ifindex = iface_index;
+                mreq.mr_type = PACKET_MR_PROMISC;
+
+                if ((bind(af_packet_drv_inst->socket, NANO_IP_CAST(struct sockaddr*, &address), sizeof(address)) != 0) ||
+                    (setsockopt(af_packet_drv_inst->socket, SOL_PACKET, PACKET_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) != 0))
+                {
+                    NANO_IP_LOG_ERROR("Unable to bind packet socket to %s (errno = %d)\n", af_packet_drv_inst->name, errno);
+                }
+                else
+                {
+                    ret = NIP_ERR_SUCCESS;
+                }
+            }
+        }
+    }
+    #if (NANO_IP_ENABLE_RUN_TO_COMPLETION != 0u)
+    if (ret == NIP_ERR_SUCCESS)
+    {
+        /* Wake up the stack poll on RX blocks or on wake ups (closing the descriptors removes them from the epoll instance) */
+        struct epoll_event event;
+        (void)MEMSET(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        if ((epoll_ctl(af_packet_drv_inst->poll_fd, EPOLL_CTL_ADD, af_packet_drv_inst->socket, &event) != 0) ||
+            (epoll_ctl(af_packet_drv_inst->poll_fd, EPOLL_CTL_ADD, af_packet_drv_inst->event, &event) != 0))
+        {
+            NANO_IP_LOG_ERROR("Unable to register the packet socket of %s for polling (errno = %d)\n", af_packet_drv_inst->name, errno);
+            ret = NIP_ERR_FAILURE;
+        }
+    }
+    #endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
+    if (ret != NIP_ERR_SUCCESS)
+    {
+        NANO_IP_AF_PACKET_DrvCloseSocket(af_packet_drv_inst);
+    }
+
+    return ret;
+}
+
+/** \brief Close the packet socket and unmap its rings */
+static void NANO_IP_AF_PACKET_DrvCloseSocket(af_packet_drv_t* const af_packet_drv_inst)
+{
+    if (af_packet_drv_inst->rings != NULL)
+    {
+        (void)munmap(af_packet_drv_inst->rings, (AF_PACKET_RX_BLOCK_SIZE * AF_PACKET_RX_BLOCK_COUNT) + (AF_PACKET_TX_BLOCK_SIZE * AF_PACKET_TX_BLOCK_COUNT));
+        af_packet_drv_inst->rings = NULL;
+        af_packet_drv_inst->tx_ring = NULL;
+    }
+    if (af_packet_drv_inst->socket >= 0)
+    {
+        (void)close(af_packet_drv_inst->socket);
+        af_packet_drv_inst->socket = -1;
+    }
+    if (af_packet_drv_inst->event >= 0)
+    {
+        (void)close(af_packet_drv_inst->event);
+        af_packet_drv_inst->event = -1;
+    }
+}
+
+/** \brief Copy a packet into the next TX frame (the interface must be locked) */
+static nano_ip_error_t NANO_IP_AF_PACKET_DrvQueueTxFrame(af_packet_drv_t* const af_packet_drv_inst, nano_ip_net_packet_t* const packet)
+{
+    nano_ip_error_t ret;
+    const uint32_t length = NANO_IP_CAST(uint32_t, packet->count) + NANO_IP_PACKET_GetSegmentsSize(packet);
+    if (length <= (AF_PACKET_TX_FRAME_SIZE - AF_PACKET_TX_DATA_OFFSET))
+    {
+        /* Check if the next TX frame is available */
+        struct tpacket3_hdr* const frame = NANO_IP_CAST(struct tpacket3_hdr*, &af_packet_drv_inst->tx_ring[af_packet_drv_inst->tx_frame * AF_PACKET_TX_FRAME_SIZE]);
+        const uint32_t status = __atomic_load_n(&frame->tp_status, __ATOMIC_ACQUIRE);
+        if ((status & (TP_STATUS_SEND_REQUEST | TP_STATUS_SENDING)) == 0u)
+        {
+            /* Copy the frame data and its payload segments */
+            uint8_t* data = NANO_IP_CAST(uint8_t*, frame) + AF_PACKET_TX_DATA_OFFSET;
+            const nano_ip_packet_segment_t* segment = packet->segments;
+            (void)MEMCPY(data, packet->data, packet->count);
+            data += packet->count;
+            while (segment != NULL)
+            {
+                (void)MEMCPY(data, segment->data, segment->size);
+                data += segment->size;
+                segment = segment->next;
+            }
+            frame->tp_len = length;
+            frame->tp_snaplen = length;
+            frame->tp_next_offset = 0u;
+
+            /* Hand the frame to the kernel */
+            __atomic_store_n(&frame->tp_status, TP_STATUS_SEND_REQUEST, __ATOMIC_RELEASE);
+            af_packet_drv_inst->tx_frame++;
+            if (af_packet_drv_inst->tx_frame == AF_PACKET_TX_FRAME_COUNT)
+            {
+                af_packet_drv_inst->tx_frame = 0u;
+            }
+            af_packet_drv_inst->tx_requests++;
+
+            /* Add packet to the transmitted packet list, it has been copied */
+            NANO_IP_PACKET_AddToQueue(&af_packet_drv_inst->transmitted_packets, packet);
+
+            ret = NIP_ERR_SUCCESS;
+        }
+        else
+        {
+            /* TX ring is full */
+            ret = NIP_ERR_BUSY;
+        }
+    }
+    else
+    {
+        ret = NIP_ERR_PACKET_TOO_BIG;
+    }
+
+    return ret;
+}
+
+/** \brief Give a packet back for reception (the interface must be locked) */
+static void NANO_IP_AF_PACKET_DrvReturnRxPacket(af_packet_drv_t* const af_packet_drv_inst, nano_ip_net_packet_t* const packet)
+{
+    /* Check if the packet is a loaned RX ring frame */
+    if ((packet >= &af_packet_drv_inst->rx_loan_descs[0u]) && (packet < &af_packet_drv_inst->rx_loan_descs[AF_PACKET_RX_LOAN_COUNT]))
+    {
+        /* Give the block back to the kernel once all its frames have been returned */
+        af_packet_rx_block_t* const block = NANO_IP_CAST(af_packet_rx_block_t*, packet->allocator_data);
+        block->loans--;
+        if (block->walked && (block->loans == 0u))
+        {
+            NANO_IP_AF_PACKET_DrvReleaseRxBlock(block);
+        }
+
+        /* Add the descriptor to the list */
+        packet->data = NULL;
+        packet->allocator_data = NULL;
+        NANO_IP_PACKET_AddToQueue(&af_packet_drv_inst->rx_loans, packet);
+    }
+    else
+    {
+        /* Add packet to the list */
+        NANO_IP_PACKET_AddToQueue(&af_packet_drv_inst->rx_packets, packet);
+    }
+}
+
+/** \brief Wake up the driver task */
+static void NANO_IP_AF_PACKET_DrvWakeUp(af_packet_drv_t* const af_packet_drv_inst)
+{
+    const uint64_t value = 1u;
+    (void)write(af_packet_drv_inst->event, &value, sizeof(value));
+}
+
+/** \brief Give a RX block back to the kernel */
+static void NANO_IP_AF_PACKET_DrvReleaseRxBlock(af_packet_rx_block_t* const block)
+{
+    block->walked = false;
+    __atomic_store_n(&block->desc->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+}
+
+/** \brief Walk the RX blocks handed by the kernel, returns true if the stack must be notified of received packets */
+static bool NANO_IP_AF_PACKET_DrvWalkRxBlocks(af_packet_drv_t* const af_packet_drv_inst)
+{
+    bool received = false;
+    bool walk = true;
+
+    /* Lock interface */
+    (void)NANO_IP_OAL_MUTEX_Lock(&af_packet_drv_inst->mutex);
+
+    while (walk)
+    {
+        af_packet_rx_block_t* const block = &af_packet_drv_inst->rx_blocks[af_packet_drv_inst->rx_block];
+        if (af_packet_drv_inst->rx_frame == NULL)
+        {
+            /* Check if the kernel has handed the block (and that it is not still waiting for its loans from the previous turn) */
+            const uint32_t status = __atomic_load_n(&block->desc->hdr.bh1.block_status, __ATOMIC_ACQUIRE);
+            if (((status & TP_STATUS_USER) != 0u) && !block->walked)
+            {
+                /* Start walking the block */
+                af_packet_drv_inst->rx_frame = NANO_IP_CAST(struct tpacket3_hdr*, NANO_IP_CAST(uint8_t*, block->desc) + block->desc->hdr.bh1.offset_to_first_pkt);
+                af_packet_drv_inst->rx_frames_left = block->desc->hdr.bh1.num_pkts;
+            }
+            else
+            {
+                /* No more blocks */
+                walk = false;
+            }
+        }
+        if (walk)
+        {
+            /* Walk the block's frames */
+            while ((af_packet_drv_inst->rx_frames_left != 0u) && walk)
+            {
+                struct tpacket3_hdr* const frame = af_packet_drv_inst->rx_frame;
+                const struct sockaddr_ll* const address = NANO_IP_CAST(const struct sockaddr_ll*, NANO_IP_CAST(uint8_t*, frame) + TPACKET_ALIGN(sizeof(struct tpacket3_hdr)));
+                if ((address->sll_pkttype != PACKET_OUTGOING) && (frame->tp_snaplen <= 0xFFFFu))
+                {
+                    uint8_t* const data = NANO_IP_CAST(uint8_t*, frame) + frame->tp_mac;
+                    const uint16_t length = NANO_IP_CAST(uint16_t, frame->tp_snaplen);
+
+                    /* Loan the frame to the stack */
+                    nano_ip_net_packet_t* packet = NANO_IP_PACKET_PopFromQueue(&af_packet_drv_inst->rx_loans);
+                    if (packet != NULL)
+                    {
+                        packet->data = data;
+                        packet->size = length;
+                        packet->allocator_data = block;
+                        packet->segments = NULL;
+                        packet->ref_count = 1u;
+                        block->loans++;
+                    }
+                    else
+                    {
+                        /* No more loan descriptor, copy the frame into a rx packet */
+                        packet = af_packet_drv_inst->rx_packets.head;
+                        if ((packet != NULL) && (packet->size >= length))
+                        {
+                            (void)NANO_IP_PACKET_PopFromQueue(&af_packet_drv_inst->rx_packets);
+                            (void)MEMCPY(packet->data, data, length);
+                        }
+                        else
+                        {
+                            /* Wait for a descriptor to be returned */
+                            packet = NULL;
+                            af_packet_drv_inst->rx_starved = true;
+                            walk = false;
+                        }
+                    }
+                    if (packet != NULL)
+                    {
+                        /* Add packet to the received packet list */
+                        packet->current = packet->data;
+                        packet->count = length;
+                        packet->flags = NET_IF_PACKET_FLAG_RX;
+                        NANO_IP_PACKET_AddToQueue(&af_packet_drv_inst->received_packets, packet);
+                        received = true;
+                    }
+                }
+                if (walk)
+                {
+                    /* Next frame */
+                    af_packet_drv_inst->rx_frame = NANO_IP_CAST(struct tpacket3_hdr*, NANO_IP_CAST(uint8_t*, frame) + frame->tp_next_offset);
+                    af_packet_drv_inst->rx_frames_left--;
+                }
+            }
+            if (walk)
+            {
+                /* Block fully walked, it is given back to the kernel when all its frames have been returned */
+                block->walked = true;
+                if (block->loans == 0u)
+                {
+                    NANO_IP_AF_PACKET_DrvReleaseRxBlock(block);
+                }
+                af_packet_drv_inst->rx_frame = NULL;
+                af_packet_drv_inst->rx_block++;
+                if (af_packet_drv_inst->rx_block == AF_PACKET_RX_BLOCK_COUNT)
+                {
+                    af_packet_drv_inst->rx_block = 0u;
+                }
+            }
+        }
+    }
+
+    /* No notification while the stack polls the reception */
+    if (af_packet_drv_inst->rx_notification_disabled)
+    {
+        received = false;
+    }
+
+    /* Unlock interface */
+    (void)NANO_IP_OAL_MUTEX_Unlock(&af_packet_drv_inst->mutex);
+
+    return received;
+}
+
+/** \brief Kick the transmission of the pending TX frames, returns true if frames have been sent */
+static bool NANO_IP_AF_PACKET_DrvKickTx(af_packet_drv_t* const af_packet_drv_inst)
+{
+    bool sent = false;
+    uint32_t tx_requests;
+
+    /* Get the number of pending frames */
+    (void)NANO_IP_OAL_MUTEX_Lock(&af_packet_drv_inst->mutex);
+    tx_requests = af_packet_drv_inst->tx_requests;
+    af_packet_drv_inst->tx_requests = 0u;
+    (void)NANO_IP_OAL_MUTEX_Unlock(&af_packet_drv_inst->mutex);
+
+    if (tx_requests != 0u)
+    {
+        /* Single system call for all the pending frames */
+        if ((sendto(af_packet_drv_inst->socket, NULL, 0u, MSG_DONTWAIT, NULL, 0u) < 0) && 
+            ((errno == EAGAIN) || (errno == ENOBUFS)))
+        {
+            /* Kernel queue is full, retry on the next wake up */
+            (void)NANO_IP_OAL_MUTEX_Lock(&af_packet_drv_inst->mutex);
+            af_packet_drv_inst->tx_requests += tx_requests;
+            (void)NANO_IP_OAL_MUTEX_Unlock(&af_packet_drv_inst->mutex);
+        }
+        sent = true;
+    }
+
+    return sent;
+}
+
+/** \brief Send the pending TX frames and receive the frames of the RX blocks handed by the kernel */
+static void NANO_IP_AF_PACKET_DrvProcessEvents(af_packet_drv_t* const af_packet_drv_inst)
+{
+    /* Send the pending TX frames */
+    if (NANO_IP_AF_PACKET_DrvKickTx(af_packet_drv_inst))
+    {
+        /* Notify packets transmission (the frames have been copied) */
+        af_packet_drv_inst->callbacks.packet_sent(af_packet_drv_inst->callbacks.stack_data, false);
+    }
+
+    /* Receive the frames of the RX blocks handed by the kernel */
+    if (NANO_IP_AF_PACKET_DrvWalkRxBlocks(af_packet_drv_inst))
+    {
+        /* Notify packets reception */
+        af_packet_drv_inst->callbacks.packet_received(af_packet_drv_inst->callbacks.stack_data, false);
+    }
+}
+
+#if (NANO_IP_ENABLE_RUN_TO_COMPLETION == 0u)
+
+/** \brief Driver task */
+static void NANO_IP_AF_PACKET_DrvTask(void* param)
+{
+    af_packet_drv_t* af_packet_drv_inst = NANO_IP_CAST(af_packet_drv_t*, param);
+
+    /* Task loop */
+    while (af_packet_drv_inst->running)
+    {
+        struct pollfd fds[2u];
+
+        /* Wait for RX blocks or for a wake up */
+        fds[0u].fd = af_packet_drv_inst->socket;
+        fds[0u].events = POLLIN;
+        fds[0u].revents = 0;
+        fds[1u].fd = af_packet_drv_inst->event;
+        fds[1u].events = POLLIN;
+        fds[1u].revents = 0;
+        if ((poll(fds, 2u, AF_PACKET_POLL_TIMEOUT) < 0) && (errno != EINTR))
+        {
+            /* Notify error */
+            af_packet_drv_inst->callbacks.net_drv_error(af_packet_drv_inst->callbacks.stack_data, false);
+        }
+        if ((fds[1u].revents & POLLIN) != 0)
+        {
+            uint64_t value;
+            (void)read(af_packet_drv_inst->event, &value, sizeof(value));
+        }
+
+        /* Send the pending TX frames and receive the RX blocks */
+        NANO_IP_AF_PACKET_DrvProcessEvents(af_packet_drv_inst);
+    }
+
+    /* Close the socket */
+    NANO_IP_AF_PACKET_DrvCloseSocket(af_packet_drv_inst);
+}
+
+#endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
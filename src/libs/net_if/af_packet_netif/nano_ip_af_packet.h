@@ -0,0 +1,43 @@
+/*
+Copyright(c) 2017 Cedric Jimenez
+
+This file is part of Nano-IP.
+
+Nano-IP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Nano-IP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with Nano-IP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef NANO_IP_AF_PACKET_H
+#define NANO_IP_AF_PACKET_H
+
+#include "nano_ip_net_if.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+
+
+/** \brief Initialize AF_PACKET interface (Linux only, uses TPACKET_V3 RX and TX rings mapped in user space).
+           The interface can be any Linux network interface, ex: one end of a veth pair whose other end is
+           moved into a network namespace. Requires the CAP_NET_RAW capability */
+nano_ip_error_t NANO_IP_AF_PACKET_Init(nano_ip_net_if_t* const af_packet_iface, const char* iface_name);
+
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+
+#endif /* NANO_IP_AF_PACKET_H */
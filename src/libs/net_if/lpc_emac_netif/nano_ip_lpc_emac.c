@@ -146,6 +146,9 @@ typedef struct _lpc_emac_drv_t
 
     /** \brief Callbacks */
     net_driver_callbacks_t callbacks;
+
+    /** \brief Indicate if the reception notifications are disabled */
+    bool rx_notification_disabled;
     
     /** \brief List of received packets */
     nano_ip_packet_queue_t received_packets;
@@ -206,6 +209,8 @@ static nano_ip_error_t NANO_IP_LPC_EMAC_DrvGetNextRxPacket(void* const user_data
 static nano_ip_error_t NANO_IP_LPC_EMAC_DrvGetNextTxPacket(void* const user_data, nano_ip_net_packet_t** const packet);
 /** \brief Get the link state of the LPC EMAC interface driver */
 static nano_ip_error_t NANO_IP_LPC_EMAC_DrvGetLinkState(void* const user_data, net_link_state_t* const state);
+/** \brief Enable or disable the reception notifications of the LPC EMAC interface driver */
+static nano_ip_error_t NANO_IP_LPC_EMAC_DrvSetRxNotification(void* const user_data, const bool enabled);
 
 /** \brief Read data from a PHY register */
 static nano_ip_error_t NANO_IP_LPC_EMAC_DrvPhyRead(void* const user_data, const uint8_t phy_address, const uint8_t phy_reg, uint16_t* const read_data);
@@ -214,11 +219,14 @@ static nano_ip_error_t NANO_IP_LPC_EMAC_DrvPhyWrite(void* const user_data, const
 
 
 /** \brief Enable LPC EMAC interrupts */
-static void NANO_IP_LPC_EMAC_EnableInterrupts(volatile lpc_emac_regs_t* const lpc_emac_regs);
+static void NANO_IP_LPC_EMAC_EnableInterrupts(const lpc_emac_drv_t* const lpc_emac_driver);
 
 /** \brief Disable LPC EMAC interrupts */
 static void NANO_IP_LPC_EMAC_DisableInterrupts(volatile lpc_emac_regs_t* const lpc_emac_regs);
 
+/** \brief Move the packets received by the LPC EMAC DMA engine to the received list, returns true if packets have been received */
+static bool NANO_IP_LPC_EMAC_HarvestRxPackets(lpc_emac_drv_t* const lpc_emac_driver);
+
 /** \brief LPC EMAC interrupt handler */
 static void NANO_IP_LPC_EMAC_InterruptHandler(void* const driver_data);
 
@@ -243,7 +251,14 @@ static const nano_ip_net_driver_t s_lpc_emac_driver = {
                                                             NANO_IP_LPC_EMAC_DrvAddRxPacket,
                                                             NANO_IP_LPC_EMAC_DrvGetNextRxPacket,
                                                             NANO_IP_LPC_EMAC_DrvGetNextTxPacket,
-                                                            NANO_IP_LPC_EMAC_DrvGetLinkState
+                                                            NANO_IP_LPC_EMAC_DrvGetLinkState,
+                                                            NULL, /* send_packets() */
+                                                            NULL, /* add_rx_packets() */
+                                                            NULL, /* get_next_rx_packets() */
+                                                            NULL, /* get_next_tx_packets() */
+                                                            NANO_IP_LPC_EMAC_DrvSetRxNotification,
+                                                            NULL, /* poll() */
+                                                            NULL /* get_poll_handle() */
                                                         };
 
 /** \brief LPC EMAC MDIO driver */
@@ -422,7 +437,7 @@ static nano_ip_error_t NANO_IP_LPC_EMAC_DrvStart(void* const user_data)
             lpc_emac_regs->MAC1 = (1u << 0u);
         
             /* Enable interrupts */
-            NANO_IP_LPC_EMAC_EnableInterrupts(lpc_emac_regs);
+            NANO_IP_LPC_EMAC_EnableInterrupts(lpc_emac_driver);
 
             /* Driver is now started */
             lpc_emac_driver->started = true;
@@ -536,7 +551,7 @@ static nano_ip_error_t NANO_IP_LPC_EMAC_DrvSendPacket(void* const user_data, nan
             NANO_IP_PACKET_AddToQueue(&lpc_emac_driver->transmitting_packets, packet);
 
             /* Enable interrupts */
-            NANO_IP_LPC_EMAC_EnableInterrupts(lpc_emac_regs);
+            NANO_IP_LPC_EMAC_EnableInterrupts(lpc_emac_driver);
 
             ret = NIP_ERR_SUCCESS;
         }
@@ -593,7 +608,7 @@ static nano_ip_error_t NANO_IP_LPC_EMAC_DrvAddRxPacket(void* const user_data, na
         /* Enable interrupts */
         if (lpc_emac_driver->started)
         {
-            NANO_IP_LPC_EMAC_EnableInterrupts(lpc_emac_regs);
+            NANO_IP_LPC_EMAC_EnableInterrupts(lpc_emac_driver);
         }
 
         ret = NIP_ERR_SUCCESS;
@@ -616,7 +631,11 @@ static nano_ip_error_t NANO_IP_LPC_EMAC_DrvGetNextRxPacket(void* const user_data
         /* Disable interrupts */
         NANO_IP_LPC_EMAC_DisableInterrupts(lpc_emac_regs);
 
-        /* Check if a packet has been received */
+        /* Check if a packet has been received (the DMA engine is harvested here when the reception notifications are disabled) */
+        if (lpc_emac_driver->rx_notification_disabled && (lpc_emac_driver->received_packets.head == NULL))
+        {
+            (void)NANO_IP_LPC_EMAC_HarvestRxPackets(lpc_emac_driver);
+        }
         (*packet) = NANO_IP_PACKET_PopFromQueue(&lpc_emac_driver->received_packets);
         if ((*packet) == NULL)
         {
@@ -628,7 +647,7 @@ static nano_ip_error_t NANO_IP_LPC_EMAC_DrvGetNextRxPacket(void* const user_data
         }
 
         /* Enable interrupts */
-        NANO_IP_LPC_EMAC_EnableInterrupts(lpc_emac_regs);
+        NANO_IP_LPC_EMAC_EnableInterrupts(lpc_emac_driver);
     }
 
     return ret;
@@ -660,7 +679,7 @@ static nano_ip_error_t NANO_IP_LPC_EMAC_DrvGetNextTxPacket(void* const user_data
         }
 
         /* Enable interrupts */
-        NANO_IP_LPC_EMAC_EnableInterrupts(lpc_emac_regs);
+        NANO_IP_LPC_EMAC_EnableInterrupts(lpc_emac_driver);
     }
 
     return ret;
@@ -682,6 +701,31 @@ static nano_ip_error_t NANO_IP_LPC_EMAC_DrvGetLinkState(void* const user_data, n
     return ret;
 }
 
+/** \brief Enable or disable the reception notifications of the LPC EMAC interface driver */
+static nano_ip_error_t NANO_IP_LPC_EMAC_DrvSetRxNotification(void* const user_data, const bool enabled)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+    lpc_emac_drv_t* lpc_emac_driver = NANO_IP_CAST(lpc_emac_drv_t*, user_data);
+
+    /* Check parameters */
+    if (lpc_emac_driver != NULL)
+    {
+        volatile lpc_emac_regs_t* const lpc_emac_regs = lpc_emac_driver->regs;
+
+        /* Update the interrupt mask */
+        NANO_IP_LPC_EMAC_DisableInterrupts(lpc_emac_regs);
+        lpc_emac_driver->rx_notification_disabled = !enabled;
+        if (lpc_emac_driver->started)
+        {
+            NANO_IP_LPC_EMAC_EnableInterrupts(lpc_emac_driver);
+        }
+
+        ret = NIP_ERR_SUCCESS;
+    }
+
+    return ret;
+}
+
 /** \brief Read data from a PHY register */
 static nano_ip_error_t NANO_IP_LPC_EMAC_DrvPhyRead(void* const user_data, const uint8_t phy_address, const uint8_t phy_reg, uint16_t* const read_data)
 {
@@ -769,9 +813,15 @@ static nano_ip_error_t NANO_IP_LPC_EMAC_DrvPhyWrite(void* const user_data, const
 
 
 /** \brief Enable LPC EMAC interrupts */
-static void NANO_IP_LPC_EMAC_EnableInterrupts(volatile lpc_emac_regs_t* const lpc_emac_regs)
+static void NANO_IP_LPC_EMAC_EnableInterrupts(const lpc_emac_drv_t* const lpc_emac_driver)
 {
-    lpc_emac_regs->IntEnable = (1u << 0u) | (1u << 1u) | (1u << 3u) | (1u << 5u) | (1u << 7u);
+    uint32_t int_enable = (1u << 0u) | (1u << 1u) | (1u << 3u) | (1u << 5u) | (1u << 7u);
+    if (lpc_emac_driver->rx_notification_disabled)
+    {
+        /* Reception is polled by the stack */
+        int_enable &= ~(1u << 3u);
+    }
+    lpc_emac_driver->regs->IntEnable = int_enable;
 }
 
 /** \brief Disable LPC EMAC interrupts */
@@ -780,6 +830,46 @@ static void NANO_IP_LPC_EMAC_DisableInterrupts(volatile lpc_emac_regs_t* const l
     lpc_emac_regs->IntEnable = 0u;
 }
 
+/** \brief Move the packets received by the LPC EMAC DMA engine to the received list, returns true if packets have been received */
+static bool NANO_IP_LPC_EMAC_HarvestRxPackets(lpc_emac_drv_t* const lpc_emac_driver)
+{
+    bool received = false;
+    volatile lpc_emac_regs_t* const lpc_emac_regs = lpc_emac_driver->regs;
+
+    while ((lpc_emac_driver->rx_queued_packets.head != NULL) &&
+           (lpc_emac_regs->RxProduceIndex != lpc_emac_driver->rx_descriptor_consume_index))
+    {
+        volatile lpc_emac_rx_status_desc_t* rx_status_desc = &lpc_emac_driver->rx_status_descs[lpc_emac_driver->rx_descriptor_consume_index];
+
+        /* Remove packet from the Rx queued list */
+        nano_ip_net_packet_t* packet = NANO_IP_PACKET_PopFromQueue(&lpc_emac_driver->rx_queued_packets);
+
+        /* Add packet to the received list */
+        NANO_IP_PACKET_AddToQueue(&lpc_emac_driver->received_packets, packet);
+
+        /* Extract packet size (minus FCS) and error flags */
+        packet->count = NANO_IP_CAST(uint16_t, ((rx_status_desc->status_info) & 0x3FFu)) + 1u - sizeof(uint32_t);
+        if (((rx_status_desc->status_info & ((1u << 23u) | (1u << 25u) | (1u << 27u))) != 0u) ||
+            ((rx_status_desc->status_info & (1u << 30u)) == 0u))
+        {
+            packet->flags |= NET_IF_PACKET_FLAG_ERROR;
+        }
+
+        /* Next descriptor */
+        lpc_emac_driver->rx_descriptor_consume_index++;
+        if (lpc_emac_driver->rx_descriptor_consume_index == lpc_emac_driver->rx_descriptor_count)
+        {
+            lpc_emac_driver->rx_descriptor_consume_index = 0u;
+        }
+
+        /* Packets have been received */
+        received = true;
+        lpc_emac_driver->rx_packet_count++;
+    }
+
+    return received;
+}
+
 /** \brief LPC EMAC interrupt handler */
 static void NANO_IP_LPC_EMAC_InterruptHandler(void* const driver_data)
 {
@@ -792,40 +882,10 @@ static void NANO_IP_LPC_EMAC_InterruptHandler(void* const driver_data)
         volatile lpc_emac_regs_t* const lpc_emac_regs = lpc_emac_driver->regs;
 
         /* Handle received packets */
-        notify_stack = false;
-        while ((lpc_emac_driver->rx_queued_packets.head != NULL) &&
-               (lpc_emac_regs->RxProduceIndex != lpc_emac_driver->rx_descriptor_consume_index))
-        {
-            volatile lpc_emac_rx_status_desc_t* rx_status_desc = &lpc_emac_driver->rx_status_descs[lpc_emac_driver->rx_descriptor_consume_index];
-
-            /* Remove packet from the Rx queued list */
-            nano_ip_net_packet_t* packet = NANO_IP_PACKET_PopFromQueue(&lpc_emac_driver->rx_queued_packets);
-
-            /* Add packet to the received list */
-            NANO_IP_PACKET_AddToQueue(&lpc_emac_driver->received_packets, packet);
-
-            /* Extract packet size (minus FCS) and error flags */
-            packet->count = NANO_IP_CAST(uint16_t, ((rx_status_desc->status_info) & 0x3FFu)) + 1u - sizeof(uint32_t);
-            if (((rx_status_desc->status_info & ((1u << 23u) | (1u << 25u) | (1u << 27u))) != 0u) ||
-                ((rx_status_desc->status_info & (1u << 30u)) == 0u))
-            {
-                packet->flags |= NET_IF_PACKET_FLAG_ERROR;
-            }
-
-            /* Next descriptor */
-            lpc_emac_driver->rx_descriptor_consume_index++;
-            if (lpc_emac_driver->rx_descriptor_consume_index == lpc_emac_driver->rx_descriptor_count)
-            {
-                lpc_emac_driver->rx_descriptor_consume_index = 0u;
-            }
+        notify_stack = NANO_IP_LPC_EMAC_HarvestRxPackets(lpc_emac_driver);
 
-            /* Stack must be notified for packet reception */
-            notify_stack = true;
-            lpc_emac_driver->rx_packet_count++;
-        }
-
-        /* Notify the stack that packets have been received */
-        if (notify_stack)
+        /* Notify the stack that packets have been received (unless it is polling the reception) */
+        if (notify_stack && !lpc_emac_driver->rx_notification_disabled)
         {
             lpc_emac_driver->callbacks.packet_received(lpc_emac_driver->callbacks.stack_data, true);
         }
@@ -47,6 +47,8 @@ typedef struct _pcap_drv_t
     nano_ip_packet_queue_t transmitted_packets;
     /** \brief Interface's mutex */
     oal_mutex_t mutex;
+    /** \brief Indicate if the reception notifications are disabled */
+    bool rx_notification_disabled;
     /** \brief Task */
     oal_task_t task;
     /** \brief pcap handle */
@@ -77,6 +79,8 @@ static nano_ip_error_t NANO_IP_PCAP_DrvGetNextRxPacket(void* const user_data, na
 static nano_ip_error_t NANO_IP_PCAP_DrvGetNextTxPacket(void* const user_data, nano_ip_net_packet_t** const packet);
 /** \brief Get the link state of the pcap interface driver */
 static nano_ip_error_t NANO_IP_PCAP_DrvGetLinkState(void* const user_data, net_link_state_t* const state);
+/** \brief Enable or disable the reception notifications of the pcap interface driver */
+static nano_ip_error_t NANO_IP_PCAP_DrvSetRxNotification(void* const user_data, const bool enabled);
 
 
 /** \brief Receive callback */
@@ -200,6 +204,7 @@ nano_ip_error_t NANO_IP_PCAP_Init(nano_ip_net_if_t* const pcap_iface, const char
                     pcap_drv_inst->driver->get_next_rx_packet = NANO_IP_PCAP_DrvGetNextRxPacket;
                     pcap_drv_inst->driver->get_next_tx_packet = NANO_IP_PCAP_DrvGetNextTxPacket;
                     pcap_drv_inst->driver->get_link_state = NANO_IP_PCAP_DrvGetLinkState;
+                    pcap_drv_inst->driver->set_rx_notification = NANO_IP_PCAP_DrvSetRxNotification;
                     pcap_iface->driver = pcap_drv_inst->driver;
 
                     /* Create the interface's mutex */
@@ -335,17 +340,21 @@ static nano_ip_error_t NANO_IP_PCAP_DrvSendPacket(void* const user_data, nano_ip
             ret = NIP_ERR_FAILURE;
         }
 
-        /* Lock interface */
-        (void)NANO_IP_OAL_MUTEX_Lock(&pcap_drv_inst->mutex);
+        /* On error the packet still belongs to the caller */
+        if (ret == NIP_ERR_SUCCESS)
+        {
+            /* Lock interface */
+            (void)NANO_IP_OAL_MUTEX_Lock(&pcap_drv_inst->mutex);
 
-        /* Add packet to the transmitted packet list */
-        NANO_IP_PACKET_AddToQueue(&pcap_drv_inst->transmitted_packets, packet);
+            /* Add packet to the transmitted packet list */
+            NANO_IP_PACKET_AddToQueue(&pcap_drv_inst->transmitted_packets, packet);
 
-        /* Unlock interface */
-        (void)NANO_IP_OAL_MUTEX_Unlock(&pcap_drv_inst->mutex);
+            /* Unlock interface */
+            (void)NANO_IP_OAL_MUTEX_Unlock(&pcap_drv_inst->mutex);
 
-        /* Notify packet transmission */
-        pcap_drv_inst->callbacks.packet_sent(pcap_drv_inst->callbacks.stack_data, false);
+            /* Notify packet transmission */
+            pcap_drv_inst->callbacks.packet_sent(pcap_drv_inst->callbacks.stack_data, false);
+        }
     }
 
     return ret;
@@ -452,6 +461,24 @@ static nano_ip_error_t NANO_IP_PCAP_DrvGetLinkState(void* const user_data, net_l
     return ret;
 }
 
+/** \brief Enable or disable the reception notifications of the pcap interface driver */
+static nano_ip_error_t NANO_IP_PCAP_DrvSetRxNotification(void* const user_data, const bool enabled)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+    pcap_drv_t* pcap_drv_inst = NANO_IP_CAST(pcap_drv_t*, user_data);
+
+    /* Check parameters */
+    if (pcap_drv_inst != NULL)
+    {
+        (void)NANO_IP_OAL_MUTEX_Lock(&pcap_drv_inst->mutex);
+        pcap_drv_inst->rx_notification_disabled = !enabled;
+        (void)NANO_IP_OAL_MUTEX_Unlock(&pcap_drv_inst->mutex);
+        ret = NIP_ERR_SUCCESS;
+    }
+
+    return ret;
+}
+
 
 
 /** \brief Receive callback */
@@ -478,12 +505,16 @@ static void NANO_IP_PCAP_DrvPcapHandler(u_char *user, const struct pcap_pkthdr *
 
             /* Add packet to the received packet list */
             NANO_IP_PACKET_AddToQueue(&pcap_drv_inst->received_packets, received_packet);
+            const bool notify_rx = !pcap_drv_inst->rx_notification_disabled;
 
             /* Unlock interface */
             (void)NANO_IP_OAL_MUTEX_Unlock(&pcap_drv_inst->mutex);
 
             /* Notify packet reception */
-            pcap_drv_inst->callbacks.packet_received(pcap_drv_inst->callbacks.stack_data, false);
+            if (notify_rx)
+            {
+                pcap_drv_inst->callbacks.packet_received(pcap_drv_inst->callbacks.stack_data, false);
+            }
         }
         else
         {
@@ -152,6 +152,9 @@ typedef struct _synopsys_emac_drv_t
 
     /** \brief Callbacks */
     net_driver_callbacks_t callbacks;
+
+    /** \brief Indicate if the reception notifications are disabled */
+    bool rx_notification_disabled;
     
     /** \brief List of received packets */
     nano_ip_packet_queue_t received_packets;
@@ -209,6 +212,8 @@ static nano_ip_error_t NANO_IP_SYNOPSYS_EMAC_DrvGetNextRxPacket(void* const user
 static nano_ip_error_t NANO_IP_SYNOPSYS_EMAC_DrvGetNextTxPacket(void* const user_data, nano_ip_net_packet_t** const packet);
 /** \brief Get the link state of the SYNOPSYS EMAC interface driver */
 static nano_ip_error_t NANO_IP_SYNOPSYS_EMAC_DrvGetLinkState(void* const user_data, net_link_state_t* const state);
+/** \brief Enable or disable the reception notifications of the SYNOPSYS EMAC interface driver */
+static nano_ip_error_t NANO_IP_SYNOPSYS_EMAC_DrvSetRxNotification(void* const user_data, const bool enabled);
 
 /** \brief Read data from a PHY register */
 static nano_ip_error_t NANO_IP_SYNOPSYS_EMAC_DrvPhyRead(void* const user_data, const uint8_t phy_address, const uint8_t phy_reg, uint16_t* const read_data);
@@ -217,11 +222,14 @@ static nano_ip_error_t NANO_IP_SYNOPSYS_EMAC_DrvPhyWrite(void* const user_data,
 
 
 /** \brief Enable SYNOPSYS EMAC interrupts */
-static void NANO_IP_SYNOPSYS_EMAC_EnableInterrupts(volatile synopsys_emac_regs_t* const synopsys_emac_regs);
+static void NANO_IP_SYNOPSYS_EMAC_EnableInterrupts(const synopsys_emac_drv_t* const synopsys_emac_driver);
 
 /** \brief Disable SYNOPSYS EMAC interrupts */
 static void NANO_IP_SYNOPSYS_EMAC_DisableInterrupts(volatile synopsys_emac_regs_t* const synopsys_emac_regs);
 
+/** \brief Move the packets received by the SYNOPSYS EMAC DMA engine to the received list, returns true if packets have been received */
+static bool NANO_IP_SYNOPSYS_EMAC_HarvestRxPackets(synopsys_emac_drv_t* const synopsys_emac_driver);
+
 /** \brief SYNOPSYS EMAC interrupt handler */
 static void NANO_IP_SYNOPSYS_EMAC_InterruptHandler(void* const driver_data);
 
@@ -246,7 +254,14 @@ static const nano_ip_net_driver_t s_synopsys_emac_driver = {
                                                             NANO_IP_SYNOPSYS_EMAC_DrvAddRxPacket,
                                                             NANO_IP_SYNOPSYS_EMAC_DrvGetNextRxPacket,
                                                             NANO_IP_SYNOPSYS_EMAC_DrvGetNextTxPacket,
-                                                            NANO_IP_SYNOPSYS_EMAC_DrvGetLinkState
+                                                            NANO_IP_SYNOPSYS_EMAC_DrvGetLinkState,
+                                                            NULL, /* send_packets() */
+                                                            NULL, /* add_rx_packets() */
+                                                            NULL, /* get_next_rx_packets() */
+                                                            NULL, /* get_next_tx_packets() */
+                                                            NANO_IP_SYNOPSYS_EMAC_DrvSetRxNotification,
+                                                            NULL, /* poll() */
+                                                            NULL /* get_poll_handle() */
                                                         };
 
 /** \brief SYNOPSYS EMAC MDIO driver */
@@ -419,7 +434,7 @@ static nano_ip_error_t NANO_IP_SYNOPSYS_EMAC_DrvStart(void* const user_data)
 	    synopsys_emac_regs->DMARPDR = 1u;
 
         /* Enable interrupts */
-        NANO_IP_SYNOPSYS_EMAC_EnableInterrupts(synopsys_emac_regs);
+        NANO_IP_SYNOPSYS_EMAC_EnableInterrupts(synopsys_emac_driver);
 
         /* Driver is now started */
         synopsys_emac_driver->started = true;
@@ -527,7 +542,7 @@ static nano_ip_error_t NANO_IP_SYNOPSYS_EMAC_DrvSendPacket(void* const user_data
             NANO_IP_PACKET_AddToQueue(&synopsys_emac_driver->transmitting_packets, packet);
 
             /* Enable interrupts */
-            NANO_IP_SYNOPSYS_EMAC_EnableInterrupts(synopsys_emac_regs);
+            NANO_IP_SYNOPSYS_EMAC_EnableInterrupts(synopsys_emac_driver);
 
             /* Notify DMA engine that a descriptor is available for transmission */
             synopsys_emac_regs->DMATPDR = 1u;
@@ -581,7 +596,7 @@ static nano_ip_error_t NANO_IP_SYNOPSYS_EMAC_DrvAddRxPacket(void* const user_dat
         if (synopsys_emac_driver->started)
         {
             /* Enable interrupts */
-            NANO_IP_SYNOPSYS_EMAC_EnableInterrupts(synopsys_emac_regs);
+            NANO_IP_SYNOPSYS_EMAC_EnableInterrupts(synopsys_emac_driver);
 
             /* Notify DMA engine that a descriptor is available for reception */
             synopsys_emac_regs->DMARPDR = 1u;
@@ -607,7 +622,11 @@ static nano_ip_error_t NANO_IP_SYNOPSYS_EMAC_DrvGetNextRxPacket(void* const user
         /* Disable interrupts */
         NANO_IP_SYNOPSYS_EMAC_DisableInterrupts(synopsys_emac_regs);
 
-        /* Check if a packet has been received */
+        /* Check if a packet has been received (the DMA engine is harvested here when the reception notifications are disabled) */
+        if (synopsys_emac_driver->rx_notification_disabled && (synopsys_emac_driver->received_packets.head == NULL))
+        {
+            (void)NANO_IP_SYNOPSYS_EMAC_HarvestRxPackets(synopsys_emac_driver);
+        }
         (*packet) = NANO_IP_PACKET_PopFromQueue(&synopsys_emac_driver->received_packets);
         if ((*packet) == NULL)
         {
@@ -619,7 +638,7 @@ static nano_ip_error_t NANO_IP_SYNOPSYS_EMAC_DrvGetNextRxPacket(void* const user
         }
 
         /* Enable interrupts */
-        NANO_IP_SYNOPSYS_EMAC_EnableInterrupts(synopsys_emac_regs);
+        NANO_IP_SYNOPSYS_EMAC_EnableInterrupts(synopsys_emac_driver);
     }
 
     return ret;
@@ -651,7 +670,7 @@ static nano_ip_error_t NANO_IP_SYNOPSYS_EMAC_DrvGetNextTxPacket(void* const user
         }
 
         /* Enable interrupts */
-        NANO_IP_SYNOPSYS_EMAC_EnableInterrupts(synopsys_emac_regs);
+        NANO_IP_SYNOPSYS_EMAC_EnableInterrupts(synopsys_emac_driver);
     }
 
     return ret;
@@ -673,6 +692,31 @@ static nano_ip_error_t NANO_IP_SYNOPSYS_EMAC_DrvGetLinkState(void* const user_da
     return ret;
 }
 
+/** \brief Enable or disable the reception notifications of the SYNOPSYS EMAC interface driver */
+static nano_ip_error_t NANO_IP_SYNOPSYS_EMAC_DrvSetRxNotification(void* const user_data, const bool enabled)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+    synopsys_emac_drv_t* synopsys_emac_driver = NANO_IP_CAST(synopsys_emac_drv_t*, user_data);
+
+    /* Check parameters */
+    if (synopsys_emac_driver != NULL)
+    {
+        volatile synopsys_emac_regs_t* const synopsys_emac_regs = synopsys_emac_driver->regs;
+
+        /* Update the interrupt mask */
+        NANO_IP_SYNOPSYS_EMAC_DisableInterrupts(synopsys_emac_regs);
+        synopsys_emac_driver->rx_notification_disabled = !enabled;
+        if (synopsys_emac_driver->started)
+        {
+            NANO_IP_SYNOPSYS_EMAC_EnableInterrupts(synopsys_emac_driver);
+        }
+
+        ret = NIP_ERR_SUCCESS;
+    }
+
+    return ret;
+}
+
 /** \brief Read data from a PHY register */
 static nano_ip_error_t NANO_IP_SYNOPSYS_EMAC_DrvPhyRead(void* const user_data, const uint8_t phy_address, const uint8_t phy_reg, uint16_t* const read_data)
 {
@@ -741,9 +785,15 @@ static nano_ip_error_t NANO_IP_SYNOPSYS_EMAC_DrvPhyWrite(void* const user_data,
 
 
 /** \brief Enable SYNOPSYS EMAC interrupts */
-static void NANO_IP_SYNOPSYS_EMAC_EnableInterrupts(volatile synopsys_emac_regs_t* const synopsys_emac_regs)
+static void NANO_IP_SYNOPSYS_EMAC_EnableInterrupts(const synopsys_emac_drv_t* const synopsys_emac_driver)
 {
-    synopsys_emac_regs->DMAIER = (1u << 0u) | (1u << 6u) | (1u << 15u) | (1u << 16u);
+    uint32_t int_enable = (1u << 0u) | (1u << 6u) | (1u << 15u) | (1u << 16u);
+    if (synopsys_emac_driver->rx_notification_disabled)
+    {
+        /* Reception is polled by the stack */
+        int_enable &= ~(1u << 6u);
+    }
+    synopsys_emac_driver->regs->DMAIER = int_enable;
 }
 
 /** \brief Disable SYNOPSYS EMAC interrupts */
@@ -752,6 +802,36 @@ static void NANO_IP_SYNOPSYS_EMAC_DisableInterrupts(volatile synopsys_emac_regs_
     synopsys_emac_regs->DMAIER = 0u;
 }
 
+/** \brief Move the packets received by the SYNOPSYS EMAC DMA engine to the received list, returns true if packets have been received */
+static bool NANO_IP_SYNOPSYS_EMAC_HarvestRxPackets(synopsys_emac_drv_t* const synopsys_emac_driver)
+{
+    bool received = false;
+    volatile synopsys_emac_regs_t* const synopsys_emac_regs = synopsys_emac_driver->regs;
+
+    while ((synopsys_emac_driver->rx_queued_packets.head != NULL) &&
+           (synopsys_emac_regs->DMACHRBAR != NANO_IP_CAST(uint32_t, synopsys_emac_driver->rx_queued_packets.head->data)))
+    {
+        /* Remove packet from the Rx queued list */
+        nano_ip_net_packet_t* packet = NANO_IP_PACKET_PopFromQueue(&synopsys_emac_driver->rx_queued_packets);
+
+        /* Add packet to the received list */
+        NANO_IP_PACKET_AddToQueue(&synopsys_emac_driver->received_packets, packet);
+
+        /* Extract packet size */
+        packet->count = NANO_IP_CAST(uint16_t, ((synopsys_emac_driver->dma_current_rx_desc->status >> 16u) & 0x3FFFu));
+        packet->count -= sizeof(uint32_t); /* CRC32 */
+
+        /* Next descriptor */
+        synopsys_emac_driver->dma_current_rx_desc = synopsys_emac_driver->dma_current_rx_desc->next;
+
+        /* Packets have been received */
+        received = true;
+        synopsys_emac_driver->rx_packet_count++;
+    }
+
+    return received;
+}
+
 /** \brief SYNOPSYS EMAC interrupt handler */
 static void NANO_IP_SYNOPSYS_EMAC_InterruptHandler(void* const driver_data)
 {
@@ -764,30 +844,10 @@ static void NANO_IP_SYNOPSYS_EMAC_InterruptHandler(void* const driver_data)
         volatile synopsys_emac_regs_t* const synopsys_emac_regs = synopsys_emac_driver->regs;
 
         /* Handle received packets */
-        notify_stack = false;
-        while ((synopsys_emac_driver->rx_queued_packets.head != NULL) &&
-               (synopsys_emac_regs->DMACHRBAR != NANO_IP_CAST(uint32_t, synopsys_emac_driver->rx_queued_packets.head->data)))
-        {
-            /* Remove packet from the Rx queued list */
-            nano_ip_net_packet_t* packet = NANO_IP_PACKET_PopFromQueue(&synopsys_emac_driver->rx_queued_packets);
+        notify_stack = NANO_IP_SYNOPSYS_EMAC_HarvestRxPackets(synopsys_emac_driver);
 
-            /* Add packet to the received list */
-            NANO_IP_PACKET_AddToQueue(&synopsys_emac_driver->received_packets, packet);
-
-            /* Extract packet size */
-            packet->count = NANO_IP_CAST(uint16_t, ((synopsys_emac_driver->dma_current_rx_desc->status >> 16u) & 0x3FFFu));
-            packet->count -= sizeof(uint32_t); /* CRC32 */
-
-            /* Next descriptor */
-            synopsys_emac_driver->dma_current_rx_desc = synopsys_emac_driver->dma_current_rx_desc->next;
-
-            /* Stack must be notified for packet reception */
-            notify_stack = true;
-            synopsys_emac_driver->rx_packet_count++;
-        }
-
-        /* Notify the stack that packets have been received */
-        if (notify_stack)
+        /* Notify the stack that packets have been received (unless it is polling the reception) */
+        if (notify_stack && !synopsys_emac_driver->rx_notification_disabled)
         {
             synopsys_emac_driver->callbacks.packet_received(synopsys_emac_driver->callbacks.stack_data, true);
         }
@@ -0,0 +1,769 @@
+/*
+Copyright(c) 2017 Cedric Jimenez
+
+This file is part of Nano-IP.
+
+Nano-IP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Nano-IP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with Nano-IP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <sys/uio.h>
+#include <sys/epoll.h>
+#include <linux/if_tun.h>
+#include <linux/if_ether.h>
+#include <linux/virtio_net.h>
+
+#include "nano_ip_tap.h"
+
+#include "nano_ip_tools.h"
+#include "nano_ip_oal.h"
+#include "nano_ip_log.h"
+#include "nano_ip_packet_funcs.h"
+
+
+/** \brief Path of the TUN/TAP clone device */
+#define TAP_CLONE_DEVICE            "/dev/net/tun"
+
+/** \brief Maximum number of buffers of a transmitted frame (virtio-net header, frame data and payload segments) */
+#define TAP_TX_MAX_IOVECS           16u
+
+/** \brief Size in bytes of the buffer used to drop a frame when no rx packet is available */
+#define TAP_DROP_BUFFER_SIZE        65536u
+
+/** \brief Timeout in milliseconds of the receive task's wait */
+#define TAP_POLL_TIMEOUT            100
+
+/** \brief Maximum number of frames read by a call to the driver poll operation */
+#define TAP_POLL_MAX_FRAMES         64u
+
+/** \brief IPv4 ethertype */
+#define TAP_ETHERTYPE_IPV4          0x0800u
+
+/** \brief IPv4 minimum header size */
+#define TAP_IPV4_MIN_HEADER_SIZE    20u
+
+/** \brief TCP protocol number */
+#define TAP_TCP_PROTOCOL            6u
+
+/** \brief UDP protocol number */
+#define TAP_UDP_PROTOCOL            17u
+
+
+/** \brief TAP driver data */
+typedef struct _tap_drv_t
+{
+    /** \brief Interface's name */
+    const char* name;
+    /** \brief Callbacks */
+    net_driver_callbacks_t callbacks;
+    /** \brief List of available rx packets */
+    nano_ip_packet_queue_t rx_packets;
+    /** \brief List of received packets */
+    nano_ip_packet_queue_t received_packets;
+    /** \brief List of transmitted packets */
+    nano_ip_packet_queue_t transmitted_packets;
+    /** \brief Interface's mutex */
+    oal_mutex_t mutex;
+    /** \brief Task */
+    oal_task_t task;
+    /** \brief TAP queue file descriptor */
+    int fd;
+    #if (NANO_IP_ENABLE_RUN_TO_COMPLETION != 0u)
+    /** \brief Epoll instance holding the TAP queue, used as handle of the stack poll */
+    int poll_fd;
+    #endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
+    /** \brief Indicate if the driver is running */
+    bool running;
+    /** \brief Indicate if the reception notifications are disabled */
+    bool rx_notification_disabled;
+    /** \brief Network interface driver */
+    nano_ip_net_driver_t* driver;
+} tap_drv_t;
+
+
+
+/** \brief Init the TAP interface driver */
+static nano_ip_error_t NANO_IP_TAP_DrvInit(void* const user_data, net_driver_callbacks_t* const callbacks);
+/** \brief Start the TAP interface driver */
+static nano_ip_error_t NANO_IP_TAP_DrvStart(void* const user_data);
+/** \brief Stop the TAP interface driver */
+static nano_ip_error_t NANO_IP_TAP_DrvStop(void* const user_data);
+/** \brief Set the MAC address */
+static nano_ip_error_t NANO_IP_TAP_DrvSetMacAddress(void* const user_data, const uint8_t* const mac_address);
+/** \brief Set the IPv4 address */
+static nano_ip_error_t NANO_IP_TAP_DrvSetIPv4Address(void* const user_data, const ipv4_address_t ipv4_address, const ipv4_address_t ipv4_netmask);
+/** \brief Send a packet on the TAP interface driver */
+static nano_ip_error_t NANO_IP_TAP_DrvSendPacket(void* const user_data, nano_ip_net_packet_t* const packet);
+/** \brief Add a packet for reception for the TAP interface driver */
+static nano_ip_error_t NANO_IP_TAP_DrvAddRxPacket(void* const user_data, nano_ip_net_packet_t* const packet);
+/** \brief Get the last received packet on the TAP interface driver */
+static nano_ip_error_t NANO_IP_TAP_DrvGetNextRxPacket(void* const user_data, nano_ip_net_packet_t** const packet);
+/** \brief Get the last sent packet on the TAP interface driver */
+static nano_ip_error_t NANO_IP_TAP_DrvGetNextTxPacket(void* const user_data, nano_ip_net_packet_t** const packet);
+/** \brief Get the link state of the TAP interface driver */
+static nano_ip_error_t NANO_IP_TAP_DrvGetLinkState(void* const user_data, net_link_state_t* const state);
+/** \brief Enable or disable the reception notifications of the TAP interface driver */
+static nano_ip_error_t NANO_IP_TAP_DrvSetRxNotification(void* const user_data, const bool enabled);
+#if (NANO_IP_ENABLE_RUN_TO_COMPLETION != 0u)
+/** \brief Process the events of the TAP interface driver in the caller's context */
+static nano_ip_error_t NANO_IP_TAP_DrvPoll(void* const user_data);
+/** \brief Get the poll handle of the TAP interface driver */
+static nano_ip_error_t NANO_IP_TAP_DrvGetPollHandle(void* const user_data, oal_poll_handle_t* const handle);
+#endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
+
+
+/** \brief Open a queue of the TAP device */
+static nano_ip_error_t NANO_IP_TAP_DrvOpen(tap_drv_t* const tap_drv_inst);
+/** \brief Receive a frame */
+static void NANO_IP_TAP_DrvReceive(tap_drv_t* const tap_drv_inst);
+/** \brief Check the TCP or UDP checksum of a received frame, returns false if it is invalid */
+static bool NANO_IP_TAP_DrvCheckL4Checksum(const uint8_t* const frame, const uint32_t length);
+#if (NANO_IP_ENABLE_RUN_TO_COMPLETION == 0u)
+/** \brief Receive task */
+static void NANO_IP_TAP_DrvRxTask(void* param);
+#endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
+
+
+
+/** \brief Initialize TAP interface */
+nano_ip_error_t NANO_IP_TAP_Init(nano_ip_net_if_t* const tap_iface, const char* iface_name)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+
+    /* Check parameters */
+    if ((tap_iface != NULL) && (iface_name != NULL) && (strlen(iface_name) < IFNAMSIZ))
+    {
+        /* Allocate a driver instance */
+        tap_drv_t* tap_drv_inst = NANO_IP_CAST(tap_drv_t*, malloc(sizeof(tap_drv_t)));
+        if (tap_drv_inst != NULL)
+        {
+            /* 0 init */
+            MEMSET(tap_drv_inst, 0, sizeof(tap_drv_t));
+            tap_drv_inst->fd = -1;
+            #if (NANO_IP_ENABLE_RUN_TO_COMPLETION != 0u)
+            tap_drv_inst->poll_fd = -1;
+            #endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
+
+            /* Allocate driver */
+            tap_drv_inst->driver = NANO_IP_CAST(nano_ip_net_driver_t*, malloc(sizeof(nano_ip_net_driver_t)));
+            if (tap_drv_inst->driver != NULL)
+            {
+                /* 0 init */
+                MEMSET(tap_drv_inst->driver, 0, sizeof(nano_ip_net_driver_t));
+
+                /* Init driver interface, the TCP and UDP checksums of the received frames are either
+                   validated by the kernel, or not computed at all for the frames generated by the host,
+                   or checked by the driver */
+                tap_drv_inst->name = iface_name;
+                tap_drv_inst->driver->user_data = tap_drv_inst;
+                tap_drv_inst->driver->caps = NETDRV_CAPS_ETH_MIN_FRAME_SIZE |
+                                             NETDRV_CAP_ETH_CS_COMPUTATION |
+                                             NETDRV_CAP_ETH_CS_CHECK |
+                                             NETDRV_CAP_ETH_FRAME_PADDING |
+                                             NETDRV_CAP_UDPIPV4_CS_CHECK |
+                                             NETDRV_CAP_TCPIPV4_CS_CHECK |
+                                             NETDRV_CAP_TX_GATHER;
+
+                tap_drv_inst->driver->init = NANO_IP_TAP_DrvInit;
+                tap_drv_inst->driver->start = NANO_IP_TAP_DrvStart;
+                tap_drv_inst->driver->stop = NANO_IP_TAP_DrvStop;
+                tap_drv_inst->driver->set_mac_address = NANO_IP_TAP_DrvSetMacAddress;
+                tap_drv_inst->driver->set_ipv4_address = NANO_IP_TAP_DrvSetIPv4Address;
+                tap_drv_inst->driver->send_packet = NANO_IP_TAP_DrvSendPacket;
+                tap_drv_inst->driver->add_rx_packet = NANO_IP_TAP_DrvAddRxPacket;
+                tap_drv_inst->driver->get_next_rx_packet = NANO_IP_TAP_DrvGetNextRxPacket;
+                tap_drv_inst->driver->get_next_tx_packet = NANO_IP_TAP_DrvGetNextTxPacket;
+                tap_drv_inst->driver->get_link_state = NANO_IP_TAP_DrvGetLinkState;
+                tap_drv_inst->driver->set_rx_notification = NANO_IP_TAP_DrvSetRxNotification;
+                #if (NANO_IP_ENABLE_RUN_TO_COMPLETION != 0u)
+                tap_drv_inst->driver->poll = NANO_IP_TAP_DrvPoll;
+                tap_drv_inst->driver->get_poll_handle = NANO_IP_TAP_DrvGetPollHandle;
+                #endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
+                tap_iface->driver = tap_drv_inst->driver;
+
+                /* Create the interface's mutex */
+                ret = NANO_IP_OAL_MUTEX_Create(&tap_drv_inst->mutex);
+            }
+            else
+            {
+                free(tap_drv_inst);
+                ret = NIP_ERR_RESOURCE;
+            }
+        }
+        else
+        {
+            ret = NIP_ERR_RESOURCE;
+        }
+    }
+
+    return ret;
+}
+
+
+/** \brief Init the TAP interface driver */
+static nano_ip_error_t NANO_IP_TAP_DrvInit(void* const user_data, net_driver_callbacks_t* const callbacks)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+    tap_drv_t* tap_drv_inst = NANO_IP_CAST(tap_drv_t*, user_data);
+
+    /* Check parameters */
+    if (tap_drv_inst != NULL)
+    {
+        (void)MEMCPY(&tap_drv_inst->callbacks, callbacks, sizeof(net_driver_callbacks_t));
+        ret = NIP_ERR_SUCCESS;
+
+        #if (NANO_IP_ENABLE_RUN_TO_COMPLETION != 0u)
+        /* Create the epoll instance now, the stack registers it before the driver is started */
+        tap_drv_inst->poll_fd = epoll_create1(EPOLL_CLOEXEC);
+        if (tap_drv_inst->poll_fd < 0)
+        {
+            NANO_IP_LOG_ERROR("Unable to create the epoll instance of %s (errno = %d)\n", tap_drv_inst->name, errno);
+            ret = NIP_ERR_FAILURE;
+        }
+        #endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
+    }
+
+    return ret;
+}
+
+/** \brief Start the TAP interface driver */
+static nano_ip_error_t NANO_IP_TAP_DrvStart(void* const user_data)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+    tap_drv_t* tap_drv_inst = NANO_IP_CAST(tap_drv_t*, user_data);
+
+    /* Check parameters */
+    if (tap_drv_inst != NULL)
+    {
+        /* Open the TAP device */
+        ret = NANO_IP_TAP_DrvOpen(tap_drv_inst);
+        if (ret == NIP_ERR_SUCCESS)
+        {
+            tap_drv_inst->running = true;
+
+            #if (NANO_IP_ENABLE_RUN_TO_COMPLETION != 0u)
+            /* Wake up the stack poll on received frames (closing the device removes it from the epoll instance) */
+            struct epoll_event event;
+            (void)MEMSET(&event, 0, sizeof(event));
+            event.events = EPOLLIN;
+            if (epoll_ctl(tap_drv_inst->poll_fd, EPOLL_CTL_ADD, tap_drv_inst->fd, &event) != 0)
+            {
+                NANO_IP_LOG_ERROR("Unable to register TAP device %s for polling (errno = %d)\n", tap_drv_inst->name, errno);
+                ret = NIP_ERR_FAILURE;
+            }
+            #else
+            /* Create receive task */
+            ret = NANO_IP_OAL_TASK_Create(&tap_drv_inst->task, "TAP Driver Task", NANO_IP_TAP_DrvRxTask, tap_drv_inst);
+            #endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
+            if (ret != NIP_ERR_SUCCESS)
+            {
+                tap_drv_inst->running = false;
+                (void)close(tap_drv_inst->fd);
+                tap_drv_inst->fd = -1;
+            }
+        }
+    }
+
+    return ret;
+}
+
+/** \brief Stop the TAP interface driver */
+static nano_ip_error_t NANO_IP_TAP_DrvStop(void* const user_data)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+    tap_drv_t* tap_drv_inst = NANO_IP_CAST(tap_drv_t*, user_data);
+
+    /* Check parameters */
+    if (tap_drv_inst != NULL)
+    {
+        #if (NANO_IP_ENABLE_RUN_TO_COMPLETION != 0u)
+        /* No receive task, the device is closed in the stack context */
+        tap_drv_inst->running = false;
+        (void)close(tap_drv_inst->fd);
+        tap_drv_inst->fd = -1;
+        #else
+        /* Stop packet reception, the receive task will close the device */
+        tap_drv_inst->running = false;
+        #endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
+
+        ret = NIP_ERR_SUCCESS;
+    }
+
+    return ret;
+}
+
+/** \brief Set the MAC address */
+static nano_ip_error_t NANO_IP_TAP_DrvSetMacAddress(void* const user_data, const uint8_t* const mac_address)
+{
+    /* No need to configure MAC address, the TAP device does not filter the frames sent by the host */
+    (void)user_data;
+    (void)mac_address;
+    return NIP_ERR_SUCCESS;
+}
+
+/** \brief Set the IPv4 address */
+static nano_ip_error_t NANO_IP_TAP_DrvSetIPv4Address(void* const user_data, const ipv4_address_t ipv4_address, const ipv4_address_t ipv4_netmask)
+{
+    /* No need to configure IPV4 address for a TAP device */
+    (void)user_data;
+    (void)ipv4_address;
+    (void)ipv4_netmask;
+    return NIP_ERR_SUCCESS;
+}
+
+/** \brief Send a packet on the TAP interface driver */
+static nano_ip_error_t NANO_IP_TAP_DrvSendPacket(void* const user_data, nano_ip_net_packet_t* const packet)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+    tap_drv_t* tap_drv_inst = NANO_IP_CAST(tap_drv_t*, user_data);
+
+    /* Check parameters */
+    if ((tap_drv_inst != NULL) && (packet != NULL))
+    {
+        struct virtio_net_hdr vnet_hdr;
+        struct iovec iovecs[TAP_TX_MAX_IOVECS];
+        const nano_ip_packet_segment_t* segment = packet->segments;
+        int iovecs_count = 2;
+        ssize_t length;
+
+        /* The stack always computes the checksums, the kernel does not need to check them again */
+        (void)MEMSET(&vnet_hdr, 0, sizeof(vnet_hdr));
+        vnet_hdr.flags = VIRTIO_NET_HDR_F_DATA_VALID;
+        vnet_hdr.gso_type = VIRTIO_NET_HDR_GSO_NONE;
+
+        /* Gather the virtio-net header, the frame and its payload segments */
+        iovecs[0u].iov_base = &vnet_hdr;
+        iovecs[0u].iov_len = sizeof(vnet_hdr);
+        iovecs[1u].iov_base = packet->data;
+        iovecs[1u].iov_len = packet->count;
+        length = NANO_IP_CAST(ssize_t, sizeof(vnet_hdr) + packet->count);
+        while ((segment != NULL) && (iovecs_count < NANO_IP_CAST(int, TAP_TX_MAX_IOVECS)))
+        {
+            iovecs[iovecs_count].iov_base = NANO_IP_CAST(void*, segment->data);
+            iovecs[iovecs_count].iov_len = segment->size;
+            length += NANO_IP_CAST(ssize_t, segment->size);
+            iovecs_count++;
+            segment = segment->next;
+        }
+
+        /* Send packet, the frame must be written at once */
+        if (segment != NULL)
+        {
+            ret = NIP_ERR_RESOURCE;
+        }
+        else if (writev(tap_drv_inst->fd, iovecs, iovecs_count) == length)
+        {
+            ret = NIP_ERR_SUCCESS;
+        }
+        else
+        {
+            ret = NIP_ERR_FAILURE;
+        }
+
+        /* On error the packet still belongs to the caller */
+        if (ret == NIP_ERR_SUCCESS)
+        {
+            /* Lock interface */
+            (void)NANO_IP_OAL_MUTEX_Lock(&tap_drv_inst->mutex);
+
+            /* Add packet to the transmitted packet list */
+            NANO_IP_PACKET_AddToQueue(&tap_drv_inst->transmitted_packets, packet);
+
+            /* Unlock interface */
+            (void)NANO_IP_OAL_MUTEX_Unlock(&tap_drv_inst->mutex);
+
+            /* Notify packet transmission */
+            tap_drv_inst->callbacks.packet_sent(tap_drv_inst->callbacks.stack_data, false);
+        }
+    }
+
+    return ret;
+}
+
+/** \brief Add a packet for reception for the TAP interface driver */
+static nano_ip_error_t NANO_IP_TAP_DrvAddRxPacket(void* const user_data, nano_ip_net_packet_t* const packet)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+    tap_drv_t* tap_drv_inst = NANO_IP_CAST(tap_drv_t*, user_data);
+
+    /* Check parameters */
+    if ((tap_drv_inst != NULL) && (packet != NULL))
+    {
+        /* Lock interface */
+        (void)NANO_IP_OAL_MUTEX_Lock(&tap_drv_inst->mutex);
+
+        /* Add packet to the list */
+        NANO_IP_PACKET_AddToQueue(&tap_drv_inst->rx_packets, packet);
+
+        /* Unlock interface */
+        (void)NANO_IP_OAL_MUTEX_Unlock(&tap_drv_inst->mutex);
+
+        ret = NIP_ERR_SUCCESS;
+    }
+
+    return ret;
+}
+
+/** \brief Get the last received packet on the TAP interface driver */
+static nano_ip_error_t NANO_IP_TAP_DrvGetNextRxPacket(void* const user_data, nano_ip_net_packet_t** const packet)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+    tap_drv_t* tap_drv_inst = NANO_IP_CAST(tap_drv_t*, user_data);
+
+    /* Check parameters */
+    if ((tap_drv_inst != NULL) && (packet != NULL))
+    {
+        /* Lock interface */
+        (void)NANO_IP_OAL_MUTEX_Lock(&tap_drv_inst->mutex);
+
+        /* Remove last received packet from the list */
+        (*packet) = NANO_IP_PACKET_PopFromQueue(&tap_drv_inst->received_packets);
+        if ((*packet) != NULL)
+        {
+            ret = NIP_ERR_SUCCESS;
+        }
+        else
+        {
+            ret = NIP_ERR_PACKET_NOT_FOUND;
+        }
+
+        /* Unlock interface */
+        (void)NANO_IP_OAL_MUTEX_Unlock(&tap_drv_inst->mutex);
+    }
+
+    return ret;
+}
+
+/** \brief Get the last sent packet on the TAP interface driver */
+static nano_ip_error_t NANO_IP_TAP_DrvGetNextTxPacket(void* const user_data, nano_ip_net_packet_t** const packet)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+    tap_drv_t* tap_drv_inst = NANO_IP_CAST(tap_drv_t*, user_data);
+
+    /* Check parameters */
+    if ((tap_drv_inst != NULL) && (packet != NULL))
+    {
+        /* Lock interface */
+        (void)NANO_IP_OAL_MUTEX_Lock(&tap_drv_inst->mutex);
+
+        /* Remove last transmitted packet from the list */
+        (*packet) = NANO_IP_PACKET_PopFromQueue(&tap_drv_inst->transmitted_packets);
+        if ((*packet) != NULL)
+        {
+            ret = NIP_ERR_SUCCESS;
+        }
+        else
+        {
+            ret = NIP_ERR_PACKET_NOT_FOUND;
+        }
+
+        /* Unlock interface */
+        (void)NANO_IP_OAL_MUTEX_Unlock(&tap_drv_inst->mutex);
+    }
+
+    return ret;
+}
+
+
+/** \brief Get the link state of the TAP interface driver */
+static nano_ip_error_t NANO_IP_TAP_DrvGetLinkState(void* const user_data, net_link_state_t* const state)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+    tap_drv_t* tap_drv_inst = NANO_IP_CAST(tap_drv_t*, user_data);
+
+    /* Check parameters */
+    if ((tap_drv_inst != NULL) && (state != NULL))
+    {
+        (*state) = NLS_UP;
+        ret = NIP_ERR_SUCCESS;
+    }
+
+    return ret;
+}
+
+/** \brief Enable or disable the reception notifications of the TAP interface driver */
+static nano_ip_error_t NANO_IP_TAP_DrvSetRxNotification(void* const user_data, const bool enabled)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+    tap_drv_t* tap_drv_inst = NANO_IP_CAST(tap_drv_t*, user_data);
+
+    /* Check parameters */
+    if (tap_drv_inst != NULL)
+    {
+        (void)NANO_IP_OAL_MUTEX_Lock(&tap_drv_inst->mutex);
+        tap_drv_inst->rx_notification_disabled = !enabled;
+        (void)NANO_IP_OAL_MUTEX_Unlock(&tap_drv_inst->mutex);
+        ret = NIP_ERR_SUCCESS;
+    }
+
+    return ret;
+}
+
+#if (NANO_IP_ENABLE_RUN_TO_COMPLETION != 0u)
+
+/** \brief Process the events of the TAP interface driver in the caller's context */
+static nano_ip_error_t NANO_IP_TAP_DrvPoll(void* const user_data)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+    tap_drv_t* tap_drv_inst = NANO_IP_CAST(tap_drv_t*, user_data);
+
+    /* Check parameters */
+    if (tap_drv_inst != NULL)
+    {
+        /* Read the available frames, the remaining ones keep the poll handle ready */
+        uint32_t count = 0u;
+        bool readable = tap_drv_inst->running;
+        while (readable && (count < TAP_POLL_MAX_FRAMES))
+        {
+            struct pollfd fds;
+            fds.fd = tap_drv_inst->fd;
+            fds.events = POLLIN;
+            fds.revents = 0;
+            readable = ((poll(&fds, 1u, 0) > 0) && ((fds.revents & POLLIN) != 0));
+            if (readable)
+            {
+                NANO_IP_TAP_DrvReceive(tap_drv_inst);
+                count++;
+            }
+        }
+        ret = NIP_ERR_SUCCESS;
+    }
+
+    return ret;
+}
+
+/** \brief Get the poll handle of the TAP interface driver */
+static nano_ip_error_t NANO_IP_TAP_DrvGetPollHandle(void* const user_data, oal_poll_handle_t* const handle)
+{
+    nano_ip_error_t ret = NIP_ERR_INVALID_ARG;
+    tap_drv_t* tap_drv_inst = NANO_IP_CAST(tap_drv_t*, user_data);
+
+    /* Check parameters */
+    if ((tap_drv_inst != NULL) && (handle != NULL))
+    {
+        (*handle) = tap_drv_inst->poll_fd;
+        ret = NIP_ERR_SUCCESS;
+    }
+
+    return ret;
+}
+
+#endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */
+
+
+
+/** \brief Open a queue of the TAP device */
+static nano_ip_error_t NANO_IP_TAP_DrvOpen(tap_drv_t* const tap_drv_inst)
+{
+    nano_ip_error_t ret = NIP_ERR_FAILURE;
+
+    tap_drv_inst->fd = open(TAP_CLONE_DEVICE, O_RDWR | O_CLOEXEC);
+    if (tap_drv_inst->fd < 0)
+    {
+        NANO_IP_LOG_ERROR("Unable to open %s (errno = %d)\n", TAP_CLONE_DEVICE, errno);
+    }
+    else
+    {
+        struct ifreq ifr;
+        const int vnet_hdr_size = NANO_IP_CAST(int, sizeof(struct virtio_net_hdr));
+
+        /* Attach a queue to the TAP device, the frames are preceded by a virtio-net header
+           carrying their checksum and segmentation offload state */
+        (void)MEMSET(&ifr, 0, sizeof(ifr));
+        ifr.ifr_flags = IFF_TAP | IFF_NO_PI | IFF_VNET_HDR | IFF_MULTI_QUEUE;
+        (void)strncpy(ifr.ifr_name, tap_drv_inst->name, IFNAMSIZ - 1u);
+
+        /* Only negociate checksum offload: the frames sent by the host may carry a partial checksum
+           (it is not verified by the stack), and no segmentation offload is enabled so the kernel
+           never hands super-frames to the stack */
+        if ((ioctl(tap_drv_inst->fd, TUNSETIFF, &ifr) != 0) ||
+            (ioctl(tap_drv_inst->fd, TUNSETVNETHDRSZ, &vnet_hdr_size) != 0) ||
+            (ioctl(tap_drv_inst->fd, TUNSETOFFLOAD, NANO_IP_CAST(unsigned long, TUN_F_CSUM)) != 0))
+        {
+            NANO_IP_LOG_ERROR("Unable to configure TAP device %s (errno = %d)\n", tap_drv_inst->name, errno);
+            (void)close(tap_drv_inst->fd);
+            tap_drv_inst->fd = -1;
+        }
+        else
+        {
+            ret = NIP_ERR_SUCCESS;
+        }
+    }
+
+    return ret;
+}
+
+/** \brief Receive a frame */
+static void NANO_IP_TAP_DrvReceive(tap_drv_t* const tap_drv_inst)
+{
+    static uint8_t drop_buffer[TAP_DROP_BUFFER_SIZE];
+    struct virtio_net_hdr vnet_hdr;
+    struct iovec iovecs[2u];
+    ssize_t length;
+
+    /* Lock interface */
+    (void)NANO_IP_OAL_MUTEX_Lock(&tap_drv_inst->mutex);
+
+    /* Get first available rx packet */
+    nano_ip_net_packet_t* const received_packet = NANO_IP_PACKET_PopFromQueue(&tap_drv_inst->rx_packets);
+
+    /* Unlock interface */
+    (void)NANO_IP_OAL_MUTEX_Unlock(&tap_drv_inst->mutex);
+
+    /* Read the frame, it is dropped if no rx packet is available */
+    iovecs[0u].iov_base = &vnet_hdr;
+    iovecs[0u].iov_len = sizeof(vnet_hdr);
+    if (received_packet != NULL)
+    {
+        iovecs[1u].iov_base = received_packet->data;
+        iovecs[1u].iov_len = received_packet->size;
+    }
+    else
+    {
+        iovecs[1u].iov_base = drop_buffer;
+        iovecs[1u].iov_len = sizeof(drop_buffer);
+    }
+    length = readv(tap_drv_inst->fd, iovecs, 2) - NANO_IP_CAST(ssize_t, sizeof(vnet_hdr));
+    if (received_packet != NULL)
+    {
+        bool valid = (length > 0);
+        if (valid)
+        {
+            /* Checksums of the frames neither validated by the kernel nor generated by the host must be checked */
+            received_packet->count = NANO_IP_CAST(uint16_t, length);
+            if ((vnet_hdr.flags & (VIRTIO_NET_HDR_F_DATA_VALID | VIRTIO_NET_HDR_F_NEEDS_CSUM)) == 0u)
+            {
+                valid = NANO_IP_TAP_DrvCheckL4Checksum(received_packet->data, received_packet->count);
+            }
+        }
+
+        /* Lock interface */
+        (void)NANO_IP_OAL_MUTEX_Lock(&tap_drv_inst->mutex);
+
+        if (valid)
+        {
+            /* Add packet to the received packet list */
+            NANO_IP_PACKET_AddToQueue(&tap_drv_inst->received_packets, received_packet);
+        }
+        else
+        {
+            /* Give the packet back to the available rx packet list */
+            NANO_IP_PACKET_AddToQueue(&tap_drv_inst->rx_packets, received_packet);
+        }
+        const bool notify_rx = (valid && !tap_drv_inst->rx_notification_disabled);
+
+        /* Unlock interface */
+        (void)NANO_IP_OAL_MUTEX_Unlock(&tap_drv_inst->mutex);
+
+        if (notify_rx)
+        {
+            /* Notify packet reception */
+            tap_drv_inst->callbacks.packet_received(tap_drv_inst->callbacks.stack_data, false);
+        }
+    }
+    else
+    {
+        /* Notify packet error */
+        tap_drv_inst->callbacks.net_drv_error(tap_drv_inst->callbacks.stack_data, false);
+    }
+}
+
+/** \brief Check the TCP or UDP checksum of a received frame, returns false if it is invalid */
+static bool NANO_IP_TAP_DrvCheckL4Checksum(const uint8_t* const frame, const uint32_t length)
+{
+    bool valid = true;
+
+    /* Only check unfragmented IPv4 frames */
+    if ((length >= (ETH_HLEN + TAP_IPV4_MIN_HEADER_SIZE)) && (NET_READ_16(&frame[12u]) == TAP_ETHERTYPE_IPV4))
+    {
+        const uint8_t* const ipv4_header = &frame[ETH_HLEN];
+        const uint32_t header_length = NANO_IP_CAST(uint32_t, (ipv4_header[0u] & 0x0Fu)) * 4u;
+        const uint32_t total_length = NET_READ_16(&ipv4_header[2u]);
+        const uint8_t protocol = ipv4_header[9u];
+        if (((protocol == TAP_TCP_PROTOCOL) || (protocol == TAP_UDP_PROTOCOL)) &&
+            ((NET_READ_16(&ipv4_header[6u]) & 0x3FFFu) == 0u) &&
+            (header_length >= TAP_IPV4_MIN_HEADER_SIZE) && (total_length > header_length) && ((ETH_HLEN + total_length) <= length))
+        {
+            const uint8_t* const l4_header = &ipv4_header[header_length];
+            const uint16_t l4_length = NANO_IP_CAST(uint16_t, (total_length - header_length));
+
+            /* A null UDP checksum indicates that the checksum has not been computed */
+            if ((protocol == TAP_TCP_PROTOCOL) || (l4_length < 8u) || (l4_header[6u] != 0u) || (l4_header[7u] != 0u))
+            {
+                uint8_t pseudo_header[12u];
+                uint32_t sum;
+
+                /* Pseudo header followed by the TCP or UDP header and data */
+                (void)MEMCPY(pseudo_header, &ipv4_header[12u], 8u);
+                pseudo_header[8u] = 0u;
+                pseudo_header[9u] = protocol;
+                pseudo_header[10u] = NANO_IP_CAST(uint8_t, (l4_length >> 8u));
+                pseudo_header[11u] = NANO_IP_CAST(uint8_t, (l4_length & 0xFFu));
+                sum = NANO_IP_AddToInternetCS(0u, pseudo_header, sizeof(pseudo_header), 0u);
+                sum = NANO_IP_AddToInternetCS(sum, l4_header, l4_length, 0u);
+                valid = (NANO_IP_FinalizeInternetCS(sum) == 0u);
+            }
+        }
+    }
+
+    return valid;
+}
+
+#if (NANO_IP_ENABLE_RUN_TO_COMPLETION == 0u)
+
+/** \brief Receive task */
+static void NANO_IP_TAP_DrvRxTask(void* param)
+{
+    tap_drv_t* tap_drv_inst = NANO_IP_CAST(tap_drv_t*, param);
+
+    /* Task loop */
+    while (tap_drv_inst->running)
+    {
+        struct pollfd fds;
+
+        /* Wait for a frame */
+        fds.fd = tap_drv_inst->fd;
+        fds.events = POLLIN;
+        fds.revents = 0;
+        if (poll(&fds, 1u, TAP_POLL_TIMEOUT) < 0)
+        {
+            if (errno != EINTR)
+            {
+                /* Notify error */
+                tap_drv_inst->callbacks.net_drv_error(tap_drv_inst->callbacks.stack_data, false);
+            }
+        }
+        else if ((fds.revents & POLLIN) != 0)
+        {
+            NANO_IP_TAP_DrvReceive(tap_drv_inst);
+        }
+        else
+        {
+            /* Timeout */
+        }
+    }
+
+    /* Close the TAP device */
+    (void)close(tap_drv_inst->fd);
+    tap_drv_inst->fd = -1;
+}
+
+#endif /* NANO_IP_ENABLE_RUN_TO_COMPLETION */